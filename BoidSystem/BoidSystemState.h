@@ -7,7 +7,10 @@
 
 #include "Engine/Core/AABBOctree.h"
 #include "Core/Spatial/Octree.h"
+#include "Core/Profiler.h"
 #include "Engine/Systems/KDTree.h"
+#include "Core/Memory/MemoryResource.h"
+#include "Core/Memory/MemoryTracker.h"
 #include "Engine/SystemComponents/StatSystemComponent.h"
 
 #include "Game.h"
@@ -114,6 +117,7 @@ public:
     void Update(float deltaTime) override
     {
         BaseState::Update(deltaTime);
+        PROFILE_COUNTER("Live Boids", m_wanderers.size());
 
         DebugDraw::Clear();
         glm::mat4 viewProj = m_camera.GetViewProjection();
@@ -133,6 +137,7 @@ public:
         PopulateKDTree();
 #endif
 
+        size_t neighborCount = 0;
         for (size_t i = 0; i < ENTITY_COUNT; i++)
         {
 #if USE_OCTREE
@@ -146,9 +151,11 @@ public:
 
                 glm::vec3 force = m_wanderers[i].CalcSteeringBehavior(m_wanderers, neighborIndices);
                 m_wanderers[i].UpdatePosition(deltaTime, force);
+                neighborCount += m_wanderers[i].m_currentNeighborCount;
             }
             m_wanderers[i].DrawDebug();
         }
+        PROFILE_COUNTER("Neighbors", neighborCount);
 #if USE_OCTREE
         m_octree.DebugDraw();
 #elif USE_KDTREE
@@ -193,7 +200,7 @@ public:
     void PopulateOctree()
     {
 #if !NEW_OCTREE
-        m_octree = AABBOctree(glm::vec3(0.0f), 50.0f);
+        m_octree = AABBOctree(glm::vec3(0.0f), 50.0f, &m_octreeMemory);
         for (size_t i = 0; i < ENTITY_COUNT; i++)
         {
             m_octree.Insert(m_wanderers[i].m_position, i);
@@ -213,7 +220,8 @@ public:
 #if !NEW_OCTREE
         AABB searchAabb = AABB(pos, range);
 
-        neighborResult.clear();
+        JobContext::ScratchScope scratch;
+        AABBOctree::SearchResults neighborResult;
         // m_octree.FindNeighbors(pos, range, neighborResult);
         m_octree.Search(searchAabb, neighborResult);
 
@@ -242,12 +250,14 @@ public:
             content.push_back({ m_wanderers[i].m_position, i });
         }
 
-        m_kdtree = kdtree(content);
+        m_kdtree.rebuild(std::move(content));
     }
 
     void QueryKDTree(glm::vec3 pos, float range, size_t agentIndex)
     {
-        auto result = m_kdtree.nearest(pos, range);
+        JobContext::ScratchScope scratch;
+        kdtree::QueryResults result;
+        m_kdtree.nearest(pos, range, result);
         neighborIndices.clear();
         for (const kdtree::NodeContent& node : result)
         {
@@ -293,8 +303,9 @@ private:
 
     core::Octree m_coreOctree;
 
+    // leaf lists of m_octree, rebuilt every frame.
+    PoolMemoryResource m_octreeMemory{ TrackedMemoryResource::Get(MemoryTag::Spatial) };
     AABBOctree m_octree;
-    std::vector<OcNode> neighborResult;
     std::vector<size_t> neighborIndices;
 
     kdtree m_kdtree;
@@ -4,6 +4,7 @@
 
 #if MULTITHREAD
 #define NUM_THREADS 16
+#define USE_PARALLEL_FOR 1
 #define USE_THREAD 1
 #define USE_THREAD_JOBS 0
 #define USE_ASYNC 1
@@ -23,7 +24,9 @@
 
 #ifndef APP_INFO
 #if MULTITHREAD
-    #if USE_THREAD
+    #if USE_PARALLEL_FOR
+    #define TYPE "MT - ParallelFor"
+    #elif USE_THREAD
     #define TYPE "MT - " NUM_THREADS " Threads - Blocks"
     #elif USE_THREAD_JOBS
     #define TYPE "MT - " NUM_THREADS " Threads - Jobs"
@@ -3,7 +3,8 @@
 #include <glm/glm.hpp>
 #include <glm/ext/vector_float3.hpp>
 
-#include "Core/Containers/VectorContainer.h"
+#include "Core/Containers/SmallVector.h"
+#include "Core/Memory/MemoryTracker.h"
 
 #include "Definitions.h"
 #include "Engine/Utils/MathUtils.h"
@@ -13,6 +14,10 @@
 
 struct Boid
 {
+    // most boids see fewer neighbors than this, those never allocate.
+    static constexpr size_t kInlineNeighbors = 32;
+    using NeighborIndices = SmallVector<size_t, kInlineNeighbors, TrackedAllocator<size_t, MemoryTag::Boids>>;
+
     Boid()
         : m_id(++ID)
         , m_properties(&DefaultProperties)
@@ -21,8 +26,6 @@ struct Boid
         m_position = MathUtils::RandomInUnitSphere();
         m_targetBoid = nullptr;
         m_fleeBoid = nullptr;
-
-        m_neighborIndices.resize(ENTITY_COUNT);
     }
 
     Boid(Properties* properties)
@@ -34,8 +37,6 @@ struct Boid
         m_position = MathUtils::RandomInUnitSphere();
         m_targetBoid = nullptr;
         m_fleeBoid = nullptr;
-
-        m_neighborIndices.resize(ENTITY_COUNT);
     }
 
     Boid(const Boid& other)
@@ -49,8 +50,6 @@ struct Boid
         m_targetBoid = other.m_targetBoid;
         m_fleeBoid = other.m_fleeBoid;
         m_path = other.m_path;
-
-        m_neighborIndices.resize(ENTITY_COUNT);
     }
 
     bool operator==(const Boid& rhs) const { return m_id == rhs.m_id; }
@@ -114,37 +113,14 @@ struct Boid
 
 #if USE_OCTREE
         m_currentNeighborCount = neighborIndices.size();
+        const size_t* indices = neighborIndices.data();
 #else
         Search(this, otherBoids, m_neighborIndices, m_currentNeighborCount);
+        const size_t* indices = m_neighborIndices.data();
 #endif
-#if MULTITHREAD
-        std::vector<size_t> neiIndices = m_neighborIndices;
-#else
-        // NOTE (MA): This is a reference that comes from Main, and is shared accross threads
-        // and is not protected against writes.
-        neighborIndices = m_neighborIndices;
-#endif
-        if (HasFeature(eSeparation)) { force += m_properties->m_weightSeparation * Separation(otherBoids, 
-#if MULTITHREAD
-            neiIndices
-#else
-            neighborIndices
-#endif
-        ); }
-        if (HasFeature(eCohesion)) { force += m_properties->m_weightCohesion * Cohesion(otherBoids, 
-#if MULTITHREAD
-            neiIndices
-#else
-            neighborIndices
-#endif
-        ); }
-        if (HasFeature(eAlignment)) { force += m_properties->m_weightAlignment * Alignment(otherBoids, 
-#if MULTITHREAD
-            neiIndices
-#else
-            neighborIndices
-#endif
-        ); }
+        if (HasFeature(eSeparation)) { force += m_properties->m_weightSeparation * Separation(otherBoids, indices); }
+        if (HasFeature(eCohesion)) { force += m_properties->m_weightCohesion * Cohesion(otherBoids, indices); }
+        if (HasFeature(eAlignment)) { force += m_properties->m_weightAlignment * Alignment(otherBoids, indices); }
 
         return glm::clamp(force, -m_properties->m_maxForce, m_properties->m_maxForce);
     }
@@ -220,7 +196,7 @@ struct Boid
         return desiredVelocity - m_velocity;
     }
 
-    glm::vec3 Separation(std::vector<Boid>& neighbors, std::vector<size_t>& neighborIndices)
+    glm::vec3 Separation(std::vector<Boid>& neighbors, const size_t* neighborIndices)
     {
         glm::vec3 force = {};
 
@@ -245,7 +221,7 @@ struct Boid
         return force;
     }
 
-    glm::vec3 Alignment(std::vector<Boid>& neighbors, std::vector<size_t>& neighborIndices)
+    glm::vec3 Alignment(std::vector<Boid>& neighbors, const size_t* neighborIndices)
     {
         glm::vec3 force = {};
 
@@ -264,7 +240,7 @@ struct Boid
         return force;
     }
 
-    glm::vec3 Cohesion(std::vector<Boid>& neighbors, std::vector<size_t>& neighborIndices)
+    glm::vec3 Cohesion(std::vector<Boid>& neighbors, const size_t* neighborIndices)
     {
         glm::vec3 centerOfMass = {};
         glm::vec3 force = {};
@@ -316,12 +292,13 @@ struct Boid
         free(memoryBlock);
     }
 
-    void Search(Boid* agent, std::vector<Boid>& neighbors, std::vector<size_t>& result, size_t& outResultCount, size_t maxNeighbors = 0)
+    void Search(Boid* agent, std::vector<Boid>& neighbors, NeighborIndices& result, size_t& outResultCount, size_t maxNeighbors = 0)
     {
 #if USE_AABB
         AABB aabb = AABB(agent->m_position, agent->m_properties->m_neighborRange);
 #endif
 
+        result.clear();
         outResultCount = 0;
         size_t neighborSize = neighbors.size();
         int i = 0;
@@ -349,8 +326,8 @@ struct Boid
                 break;
             }
 
-            assert(result.size() > outResultCount);
-            result[outResultCount++] = i;
+            result.push_back(i);
+            ++outResultCount;
         }
     }
 
@@ -374,7 +351,9 @@ struct Boid
     // we'll deal with those optimizations later on.
     std::vector<Boid> m_neighborsScratch;
 
-    std::vector<size_t> m_neighborIndices;
+    // the last Search, grows past kInlineNeighbors only in crowds.
+    NeighborIndices m_neighborIndices;
+    // the states sum it into one "Neighbors" counter sample per frame.
     size_t m_currentNeighborCount = 0u;
 
     static unsigned int ID;
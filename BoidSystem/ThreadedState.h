@@ -16,14 +16,23 @@
 #include <future>
 
 #include "Core/Containers/ThreadSafeQueue.h"
+#include "Core/JobScheduler/JobScheduler.h"
+#include "Core/JobScheduler/ParallelFor.h"
+#include "Core/Memory/MemoryResource.h"
+#include "Core/Memory/MemoryTracker.h"
+#include "Core/Profiler.h"
 
 #include "Renderer/ViewportGrid.h"
 
+// boids per chunk, steering cost grows with the neighbor count.
+#define BOID_GRAIN_SIZE 16
+
 struct JobBlock
 {
     size_t start;
     size_t end;
-    std::vector<Boid> boids;
+    // copied in and out within one Update, so the frame's scratch is enough.
+    std::vector<Boid, ScratchAllocator<Boid>> boids;
 };
 
 struct AsyncJob
@@ -167,6 +176,10 @@ public:
             m_wanderers.push_back(b);
         }
 
+#if USE_PARALLEL_FOR
+        m_steeringForces.resize(ENTITY_COUNT);
+#endif
+
 #if USE_THREAD_JOBS
         m_isRunning.store(true);
         for (size_t i = 0; i < NUM_THREADS; ++i)
@@ -181,6 +194,7 @@ public:
     void Update(float deltaTime) override
     {
         BaseState::Update(deltaTime);
+        PROFILE_COUNTER("Live Boids", m_wanderers.size());
 
         // Debug
         DebugDraw::Clear();
@@ -201,16 +215,51 @@ public:
         PopulateKDTree();
 #endif
 
-#if USE_THREAD
-        std::vector<std::thread> threads;
-        std::atomic<int> finishedThreads{ 0 };
+#if USE_PARALLEL_FOR
+        // steering only reads other boids, so every boid can be evaluated in
+        // parallel before any position is moved.
+        {
+            PROFILE_SCOPE("Boids Steering");
+
+            // one slot per pool thread, the pool can be started after this state.
+            const size_t slots = static_cast<size_t>(JobScheduler::GetInstance().GetWorkerCount()) + 1;
+            if (!m_neighborScratch || m_neighborScratch->size() != slots)
+            {
+                m_neighborScratch = std::make_unique<WorkerLocal<std::vector<size_t>>>();
+            }
+
+            ParallelForRange(0, m_wanderers.size(), BOID_GRAIN_SIZE, [this](size_t begin, size_t end) {
+                PROFILE_SCOPE("Steering Chunk");
+                std::vector<size_t>& neighbors = m_neighborScratch->Local();
+                for (size_t i = begin; i < end; ++i)
+                {
+                    m_wanderers[i].UpdateTargets();
+#if USE_OCTREE
+                    QueryOctree(m_wanderers[i].m_position, m_wanderers[i].m_properties->m_neighborRange, i, neighbors);
+#endif
+                    m_steeringForces[i] = m_wanderers[i].CalcSteeringBehavior(m_wanderers, neighbors);
+                }
+                });
+        }
+
+        {
+            PROFILE_SCOPE("Boids Move");
+            ParallelFor(0, m_wanderers.size(), BOID_GRAIN_SIZE * 4, [this, deltaTime](size_t i) {
+                m_wanderers[i].UpdatePosition(deltaTime, m_steeringForces[i]);
+                });
+        }
+#elif USE_THREAD
+        // the blocks' boid copies, released when Update returns.
+        JobContext::ScratchScope scratch;
+
         const size_t groupSize = m_wanderers.size() / NUM_THREADS;
         size_t rest = m_wanderers.size() % NUM_THREADS;
 
         std::vector<JobBlock> job;
         job.resize(NUM_THREADS);
 
-        size_t groupIndex = 0;
+        JobScheduler& scheduler = JobScheduler::GetInstance();
+        JobCounter counter;
 
         for (size_t t = 0; t < NUM_THREADS; ++t)
         {
@@ -221,9 +270,10 @@ public:
             if (t == NUM_THREADS - 1) {
                 tJob.end += rest;
             }
-            tJob.boids = std::vector<Boid>(m_wanderers.begin() + (tJob.start), m_wanderers.begin() + tJob.end);
+            tJob.boids.assign(m_wanderers.begin() + tJob.start, m_wanderers.begin() + tJob.end);
 
-            std::thread thr([&]() {
+            scheduler.AddJob([&tJob, deltaTime, this]() {
+                PROFILE_SCOPE("Boid Block");
                 size_t boidsize = tJob.boids.size();
                 for (size_t i = 0; i < boidsize; i++)
                 {
@@ -231,28 +281,11 @@ public:
                     glm::vec3 force = tJob.boids[i].CalcSteeringBehavior(m_wanderers, neighborIndices);
                     tJob.boids[i].UpdatePosition(deltaTime, force);
                 }
-
-                // no more jobs.
-                {
-                    std::lock_guard<std::mutex> lock(m_mutex);
-                    finishedThreads++;
-                    m_cvar.notify_one();
-                }
-                });
-            threads.push_back(std::move(thr));
-        }
-
-        {
-            std::unique_lock<std::mutex> lock(m_mutex);
-            m_cvar.wait(lock, [&finishedThreads] {
-                return finishedThreads == NUM_THREADS;
-                });
+                }, &counter);
         }
 
-        for (std::thread& t : threads)
-        {
-            t.join();
-        }
+        // fan-in, this thread helps out with the blocks until they are all done.
+        scheduler.WaitForCounter(&counter);
 
         for (size_t t = 0; t < NUM_THREADS; t++)
         {
@@ -323,10 +356,14 @@ public:
 
         m_finishedJobs.clear();
 #endif
+        // one sample per frame, per boid it would crowd the profiler ring.
+        size_t neighborCount = 0;
         for (size_t i = 0; i < ENTITY_COUNT; ++i)
         {
+            neighborCount += m_wanderers[i].m_currentNeighborCount;
             m_wanderers[i].DrawDebug();
         }
+        PROFILE_COUNTER("Neighbors", neighborCount);
 
         neighborIndices.clear();
 
@@ -344,18 +381,20 @@ public:
 
     void PopulateOctree()
     {
-        m_octree = AABBOctree(glm::vec3(0.0f), 50.0f);
+        m_octree = AABBOctree(glm::vec3(0.0f), 50.0f, &m_octreeMemory);
         for (size_t i = 0; i < ENTITY_COUNT; i++)
         {
             m_octree.Insert(m_wanderers[i].m_position, i);
         }
     }
 
-    void QueryOctree(glm::vec3 pos, float range, size_t agentIndex)
+    // neighbors of agentIndex go to outIndices, safe to call from jobs.
+    void QueryOctree(glm::vec3 pos, float range, size_t agentIndex, std::vector<size_t>& outIndices)
     {
         AABB searchAabb = AABB(pos, range);
 
-        neighborResult.clear();
+        JobContext::ScratchScope scratch;
+        AABBOctree::SearchResults neighborResult;
         m_octree.Search(searchAabb, neighborResult);
 
 #if USE_OCTREE_PRUNE_BY_DIST
@@ -365,11 +404,11 @@ public:
             }), neighborResult.end());
 #endif
 
-        neighborIndices.clear();
+        outIndices.clear();
         for (const OcNode& node : neighborResult)
         {
             if (node.m_data == agentIndex) { continue; }
-            neighborIndices.emplace_back(node.m_data);
+            outIndices.emplace_back(node.m_data);
         }
     }
 
@@ -381,12 +420,14 @@ public:
             content.push_back({ m_wanderers[i].m_position, i });
         }
 
-        m_kdtree = kdtree(content);
+        m_kdtree.rebuild(std::move(content));
     }
 
     void QueryKDTree(glm::vec3 pos, float range, size_t agentIndex)
     {
-        auto result = m_kdtree.nearest(pos, range);
+        JobContext::ScratchScope scratch;
+        kdtree::QueryResults result;
+        m_kdtree.nearest(pos, range, result);
         neighborIndices.clear();
         for (const kdtree::NodeContent& node : result)
         {
@@ -398,11 +439,13 @@ public:
 #if USE_THREAD_JOBS
     void WorkerThreadLoop()
     {
+        Profiler::GetInstance().SetThreadName("Boid Worker");
         BoidJob job;
         while (m_isRunning.load())
         {
             if (m_boidJobQ.try_pop(job))
             {
+                PROFILE_SCOPE("Boid Job");
                 job.agent.UpdateTargets();
                 glm::vec3 force = job.agent.CalcSteeringBehavior(m_wanderers, neighborIndices);
                 job.agent.UpdatePosition(job.deltatime, force);
@@ -466,12 +509,18 @@ private:
     std::vector<Path> m_paths;
     std::vector<Boid> m_pathFollowers;
 
+    // leaf lists of m_octree, rebuilt every frame.
+    PoolMemoryResource m_octreeMemory{ TrackedMemoryResource::Get(MemoryTag::Spatial) };
     AABBOctree m_octree;
-    std::vector<OcNode> neighborResult;
     std::vector<size_t> neighborIndices;
 
     kdtree m_kdtree;
 
+    // parallel for
+    std::vector<glm::vec3> m_steeringForces;
+    // octree neighbor lists, one per worker.
+    std::unique_ptr<WorkerLocal<std::vector<size_t>>> m_neighborScratch;
+
     std::mutex m_mutex;
     std::condition_variable m_cvar;
 
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#pragma comment(lib, "Synchronization.lib")
+#elif defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MUTEX_CPU_RELAX() _mm_pause()
+#else
+#define MUTEX_CPU_RELAX() std::this_thread::yield()
+#endif
+
+namespace FutexDetail
+{
+	// sleeps while *address == expected, may wake up spuriously.
+	inline void Wait(std::atomic<uint32_t>& address, uint32_t expected)
+	{
+#if defined(_WIN32)
+		WaitOnAddress(&address, &expected, sizeof(expected), INFINITE);
+#elif defined(__linux__)
+		syscall(SYS_futex, reinterpret_cast<uint32_t*>(&address), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+		if (address.load(std::memory_order_relaxed) == expected)
+		{
+			std::this_thread::yield();
+		}
+#endif
+	}
+
+	inline void WakeOne(std::atomic<uint32_t>& address)
+	{
+#if defined(_WIN32)
+		WakeByAddressSingle(&address);
+#elif defined(__linux__)
+		syscall(SYS_futex, reinterpret_cast<uint32_t*>(&address), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+		(void)address;
+#endif
+	}
+}
+
+struct MutexStats
+{
+	uint64_t acquisitions = 0;
+	// lock() calls that didn't get the lock on the first try.
+	uint64_t contended = 0;
+	// time spent in contended lock() calls.
+	uint64_t waitNs = 0;
+};
+
+// Spins for a short, self tuning while and then sleeps on a futex
+// (WaitOnAddress on Windows). Unlocking only enters the kernel when a
+// thread is actually asleep. Satisfies Lockable, so it drops into
+// std::lock_guard, Terrain<Mutex> and ThreadSafeQueue<T, Mutex>.
+template<bool CollectStats>
+class BasicAdaptiveMutex
+{
+public:
+	BasicAdaptiveMutex() = default;
+	BasicAdaptiveMutex(const BasicAdaptiveMutex&) = delete;
+	BasicAdaptiveMutex& operator=(const BasicAdaptiveMutex&) = delete;
+
+	void lock()
+	{
+		uint32_t expected = Unlocked;
+		if (m_state.compare_exchange_strong(expected, Locked, std::memory_order_acquire, std::memory_order_relaxed))
+		{
+			Count(false, 0);
+			return;
+		}
+
+		LockContended();
+	}
+
+	bool try_lock()
+	{
+		uint32_t expected = Unlocked;
+		const bool locked = m_state.compare_exchange_strong(expected, Locked, std::memory_order_acquire, std::memory_order_relaxed);
+		if (locked)
+		{
+			Count(false, 0);
+		}
+		return locked;
+	}
+
+	void unlock()
+	{
+		if (m_state.exchange(Unlocked, std::memory_order_release) == Sleeping)
+		{
+			FutexDetail::WakeOne(m_state);
+		}
+	}
+
+	MutexStats GetStats() const
+	{
+		MutexStats stats;
+		stats.acquisitions = m_acquisitions.load(std::memory_order_relaxed);
+		stats.contended = m_contended.load(std::memory_order_relaxed);
+		stats.waitNs = m_waitNs.load(std::memory_order_relaxed);
+		return stats;
+	}
+
+	void ResetStats()
+	{
+		m_acquisitions.store(0, std::memory_order_relaxed);
+		m_contended.store(0, std::memory_order_relaxed);
+		m_waitNs.store(0, std::memory_order_relaxed);
+	}
+
+private:
+	enum : uint32_t
+	{
+		Unlocked = 0,
+		Locked = 1,
+		// locked, and someone may be asleep waiting for it.
+		Sleeping = 2,
+	};
+
+	static constexpr int kMinSpins = 16;
+	static constexpr int kMaxSpins = 2048;
+
+	void LockContended()
+	{
+		std::chrono::steady_clock::time_point start;
+		if (CollectStats)
+		{
+			start = std::chrono::steady_clock::now();
+		}
+
+		// spin about twice as long as it took to get the lock lately.
+		const int limit = std::min(kMaxSpins, std::max(kMinSpins, m_spinEstimate.load(std::memory_order_relaxed) * 2));
+		for (int spin = 0; spin < limit; ++spin)
+		{
+			uint32_t expected = Unlocked;
+			if (m_state.load(std::memory_order_relaxed) == Unlocked
+				&& m_state.compare_exchange_weak(expected, Locked, std::memory_order_acquire, std::memory_order_relaxed))
+			{
+				UpdateSpinEstimate(spin);
+				Count(true, Elapsed(start));
+				return;
+			}
+			MUTEX_CPU_RELAX();
+		}
+		UpdateSpinEstimate(limit);
+
+		// Sleeping even if we end up alone, unlock will then make one spare wake call.
+		while (m_state.exchange(Sleeping, std::memory_order_acquire) != Unlocked)
+		{
+			FutexDetail::Wait(m_state, Sleeping);
+		}
+		Count(true, Elapsed(start));
+	}
+
+	void UpdateSpinEstimate(int spins)
+	{
+		const int estimate = m_spinEstimate.load(std::memory_order_relaxed);
+		m_spinEstimate.store(estimate + (spins - estimate) / 8, std::memory_order_relaxed);
+	}
+
+	uint64_t Elapsed(std::chrono::steady_clock::time_point start) const
+	{
+		if (!CollectStats)
+		{
+			return 0;
+		}
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+	}
+
+	void Count(bool contended, uint64_t waitNs)
+	{
+		if (!CollectStats)
+		{
+			return;
+		}
+
+		m_acquisitions.fetch_add(1, std::memory_order_relaxed);
+		if (contended)
+		{
+			m_contended.fetch_add(1, std::memory_order_relaxed);
+			m_waitNs.fetch_add(waitNs, std::memory_order_relaxed);
+		}
+	}
+
+	std::atomic<uint32_t> m_state{ Unlocked };
+	std::atomic<int> m_spinEstimate{ kMinSpins };
+
+	std::atomic<uint64_t> m_acquisitions{ 0 };
+	std::atomic<uint64_t> m_contended{ 0 };
+	std::atomic<uint64_t> m_waitNs{ 0 };
+};
+
+using AdaptiveMutex = BasicAdaptiveMutex<false>;
+// same lock, counting acquisitions, contention and wait time.
+using ProfiledAdaptiveMutex = BasicAdaptiveMutex<true>;
@@ -0,0 +1,392 @@
+#pragma once
+
+#include <assert.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// for string keys: lookups with a std::string_view or const char* don't
+// build a std::string. Hashes the same as std::hash<std::string>, so a
+// Utils::Hash of the key can be passed to find(key, hash).
+struct StringHash
+{
+    using is_transparent = void;
+
+    size_t operator()(std::string_view text) const { return std::hash<std::string_view>{}(text); }
+};
+
+// for keys that already are hashes, like the Utils::Hash ids.
+struct IdentityHash
+{
+    size_t operator()(size_t value) const { return value; }
+};
+
+// Open addressing hash map with Robin Hood probing: entries sit in one
+// flat array, each as close to its home slot as the others allow, so a
+// lookup scans a few neighbouring slots instead of chasing bucket nodes.
+// A side array keeps each slot's probe distance and 32 bits of its hash,
+// so most misses never touch a key. Erase shifts the following entries
+// back, there are no tombstones. Keys are const to users, like std::map's;
+// entries moving between slots still move their key instead of copying it.
+// Iterators and references are invalidated by any insert or erase.
+// find(key, hash) takes a precomputed Hash()(key) to skip hashing.
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap
+{
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<const Key, Value>;
+
+    static constexpr size_t kMinCapacity = 16;
+
+    template<bool Const>
+    class Iterator
+    {
+    public:
+        using Map = typename std::conditional<Const, const FlatHashMap, FlatHashMap>::type;
+        using reference = typename std::conditional<Const, const value_type&, value_type&>::type;
+        using pointer = typename std::conditional<Const, const value_type*, value_type*>::type;
+
+        Iterator() = default;
+        Iterator(Map* map, size_t index) : m_map(map), m_index(index) { SkipEmpty(); }
+
+        // iterator to const_iterator.
+        template<bool OtherConst, typename = typename std::enable_if<Const && !OtherConst>::type>
+        Iterator(const Iterator<OtherConst>& other) : m_map(other.m_map), m_index(other.m_index) {}
+
+        reference operator*() const { return m_map->m_slots[m_index]; }
+        pointer operator->() const { return &m_map->m_slots[m_index]; }
+
+        Iterator& operator++()
+        {
+            ++m_index;
+            SkipEmpty();
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const { return m_index == other.m_index; }
+        bool operator!=(const Iterator& other) const { return m_index != other.m_index; }
+
+    private:
+        friend class FlatHashMap;
+        template<bool> friend class Iterator;
+
+        void SkipEmpty()
+        {
+            while (m_index < m_map->m_capacity && m_map->m_meta[m_index].distance == 0) { ++m_index; }
+        }
+
+        Map* m_map = nullptr;
+        size_t m_index = 0;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    FlatHashMap() = default;
+
+    explicit FlatHashMap(size_t count)
+    {
+        reserve(count);
+    }
+
+    ~FlatHashMap()
+    {
+        Destroy();
+    }
+
+    FlatHashMap(const FlatHashMap& other)
+    {
+        *this = other;
+    }
+
+    FlatHashMap& operator=(const FlatHashMap& other)
+    {
+        if (this != &other)
+        {
+            Destroy();
+            if (other.m_size > 0)
+            {
+                // same capacity, so every entry keeps its slot.
+                Allocate(other.m_capacity);
+                for (size_t i = 0; i < m_capacity; ++i)
+                {
+                    m_meta[i] = other.m_meta[i];
+                    if (m_meta[i].distance > 0) { new (&m_slots[i]) value_type(other.m_slots[i]); }
+                }
+                m_size = other.m_size;
+            }
+        }
+        return *this;
+    }
+
+    FlatHashMap(FlatHashMap&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    FlatHashMap& operator=(FlatHashMap&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Destroy();
+            m_meta = other.m_meta;
+            m_slots = other.m_slots;
+            m_capacity = other.m_capacity;
+            m_size = other.m_size;
+            other.m_meta = nullptr;
+            other.m_slots = nullptr;
+            other.m_capacity = 0;
+            other.m_size = 0;
+        }
+        return *this;
+    }
+
+    template<typename K>
+    iterator find(const K& key) { return iterator(this, FindIndex(key, Hash()(key))); }
+    template<typename K>
+    const_iterator find(const K& key) const { return const_iterator(this, FindIndex(key, Hash()(key))); }
+
+    template<typename K>
+    iterator find(const K& key, size_t hash) { return iterator(this, FindIndex(key, hash)); }
+    template<typename K>
+    const_iterator find(const K& key, size_t hash) const { return const_iterator(this, FindIndex(key, hash)); }
+
+    template<typename K>
+    bool contains(const K& key) const { return FindIndex(key, Hash()(key)) != m_capacity; }
+    template<typename K>
+    size_t count(const K& key) const { return contains(key) ? 1 : 0; }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+    {
+        const size_t hash = Hash()(key);
+        const size_t found = FindIndex(key, hash);
+        if (found != m_capacity)
+        {
+            return { iterator(this, found), false };
+        }
+
+        Grow();
+        const size_t index = Insert(Entry(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...)), Mix(hash));
+        return { iterator(this, index), true };
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(const Key& key, Args&&... args) { return try_emplace(key, std::forward<Args>(args)...); }
+
+    std::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+
+    Value& operator[](const Key& key) { return try_emplace(key).first->second; }
+
+    template<typename K>
+    size_t erase(const K& key)
+    {
+        size_t index = FindIndex(key, Hash()(key));
+        if (index == m_capacity)
+        {
+            return 0;
+        }
+
+        // shift the entries after it back, until one is already home or the slot is empty.
+        m_slots[index].~value_type();
+        size_t next = (index + 1) & (m_capacity - 1);
+        while (m_meta[next].distance > 1)
+        {
+            new (&m_slots[index]) value_type(TakeKey(m_slots[next]), std::move(m_slots[next].second));
+            m_slots[next].~value_type();
+            m_meta[index] = m_meta[next];
+            --m_meta[index].distance;
+
+            index = next;
+            next = (next + 1) & (m_capacity - 1);
+        }
+        m_meta[index].distance = 0;
+        --m_size;
+        return 1;
+    }
+
+    void clear()
+    {
+        for (size_t i = 0; i < m_capacity; ++i)
+        {
+            if (m_meta[i].distance > 0)
+            {
+                m_slots[i].~value_type();
+                m_meta[i].distance = 0;
+            }
+        }
+        m_size = 0;
+    }
+
+    // room for count entries without growing.
+    void reserve(size_t count)
+    {
+        size_t capacity = kMinCapacity;
+        while (capacity * kMaxLoadNum / kMaxLoadDen < count) { capacity <<= 1; }
+        if (capacity > m_capacity)
+        {
+            Rehash(capacity);
+        }
+    }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    size_t capacity() const { return m_capacity; }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, m_capacity); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_capacity); }
+
+private:
+    // grows at 7/8 full, Robin Hood keeps probes short up to there.
+    static constexpr size_t kMaxLoadNum = 7;
+    static constexpr size_t kMaxLoadDen = 8;
+
+    // an entry on its way to a slot, with a key that can still be moved.
+    using Entry = std::pair<Key, Value>;
+
+    struct Meta
+    {
+        uint32_t hash = 0;
+        // probe distance + 1, 0 marks an empty slot.
+        uint32_t distance = 0;
+    };
+
+    // spreads weak hashes (identity, pointers) over the low bits used as index.
+    static uint32_t Mix(size_t hash)
+    {
+        uint64_t h = static_cast<uint64_t>(hash);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        return static_cast<uint32_t>(h);
+    }
+
+    template<typename K>
+    size_t FindIndex(const K& key, size_t hash) const
+    {
+        if (m_size == 0)
+        {
+            return m_capacity;
+        }
+
+        const uint32_t mixed = Mix(hash);
+        const size_t mask = m_capacity - 1;
+        size_t index = mixed & mask;
+        for (uint32_t distance = 1; m_meta[index].distance >= distance; ++distance)
+        {
+            if (m_meta[index].hash == mixed && KeyEqual()(m_slots[index].first, key))
+            {
+                return index;
+            }
+            index = (index + 1) & mask;
+        }
+        return m_capacity;
+    }
+
+    // the map owns its slots and destroys the entry right after, so moving
+    // the key out of one is safe even though users only see it as const.
+    static Key&& TakeKey(value_type& slot)
+    {
+        return std::move(const_cast<Key&>(slot.first));
+    }
+
+    // the key must not be in the map and there must be room. Returns where entry ended up.
+    size_t Insert(Entry&& entry, uint32_t mixed)
+    {
+        const size_t mask = m_capacity - 1;
+        size_t index = mixed & mask;
+        size_t placed = m_capacity;
+        Meta meta{ mixed, 1 };
+
+        while (true)
+        {
+            if (m_meta[index].distance == 0)
+            {
+                new (&m_slots[index]) value_type(std::move(entry.first), std::move(entry.second));
+                m_meta[index] = meta;
+                ++m_size;
+                return placed != m_capacity ? placed : index;
+            }
+
+            // take the slot from an entry closer to home than we are, it carries on probing.
+            if (m_meta[index].distance < meta.distance)
+            {
+                std::swap(meta, m_meta[index]);
+                Entry displaced(TakeKey(m_slots[index]), std::move(m_slots[index].second));
+                m_slots[index].~value_type();
+                new (&m_slots[index]) value_type(std::move(entry.first), std::move(entry.second));
+                entry = std::move(displaced);
+                if (placed == m_capacity) { placed = index; }
+            }
+
+            index = (index + 1) & mask;
+            ++meta.distance;
+        }
+    }
+
+    void Grow()
+    {
+        if (m_capacity == 0 || (m_size + 1) * kMaxLoadDen > m_capacity * kMaxLoadNum)
+        {
+            Rehash(m_capacity == 0 ? kMinCapacity : m_capacity * 2);
+        }
+    }
+
+    void Rehash(size_t capacity)
+    {
+        Meta* oldMeta = m_meta;
+        value_type* oldSlots = m_slots;
+        const size_t oldCapacity = m_capacity;
+
+        Allocate(capacity);
+        m_size = 0;
+        for (size_t i = 0; i < oldCapacity; ++i)
+        {
+            if (oldMeta[i].distance > 0)
+            {
+                Insert(Entry(TakeKey(oldSlots[i]), std::move(oldSlots[i].second)), oldMeta[i].hash);
+                oldSlots[i].~value_type();
+            }
+        }
+
+        Free(oldMeta, oldSlots, oldCapacity);
+    }
+
+    void Allocate(size_t capacity)
+    {
+        assert((capacity & (capacity - 1)) == 0 && "FlatHashMap: capacity must be a power of two");
+        m_meta = new Meta[capacity];
+        m_slots = std::allocator<value_type>().allocate(capacity);
+        m_capacity = capacity;
+    }
+
+    static void Free(Meta* meta, value_type* slots, size_t capacity)
+    {
+        delete[] meta;
+        if (slots) { std::allocator<value_type>().deallocate(slots, capacity); }
+    }
+
+    void Destroy()
+    {
+        clear();
+        Free(m_meta, m_slots, m_capacity);
+        m_meta = nullptr;
+        m_slots = nullptr;
+        m_capacity = 0;
+    }
+
+    Meta* m_meta = nullptr;
+    value_type* m_slots = nullptr;
+    size_t m_capacity = 0;
+    size_t m_size = 0;
+};
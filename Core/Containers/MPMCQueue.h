@@ -0,0 +1,183 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+
+// Bounded lock free multi producer / multi consumer queue (Vyukov).
+// Every slot carries a sequence number telling producers and consumers
+// whose turn it is, so a push or pop is one CAS on the shared index plus
+// a store to the slot. Same interface as ThreadSafeQueue; push waits
+// while the queue is full, use try_push to fail instead.
+template<typename T>
+class MPMCQueue
+{
+public:
+    // rounded up to a power of two.
+    explicit MPMCQueue(size_t capacity = 1024)
+    {
+        size_t size = 2;
+        while (size < capacity) { size <<= 1; }
+
+        m_mask = size - 1;
+        m_cells = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MPMCQueue()
+    {
+        while (Dequeue([](T&) {})) {}
+    }
+
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    bool try_push(T val)
+    {
+        return Enqueue(val);
+    }
+
+    void push(T val)
+    {
+        for (unsigned int spin = 0; !Enqueue(val); ++spin)
+        {
+            Backoff(spin);
+        }
+    }
+
+    bool try_pop(T& val)
+    {
+        return Dequeue([&val](T& data) { val = std::move(data); });
+    }
+
+    std::shared_ptr<T> try_pop()
+    {
+        std::shared_ptr<T> val;
+        Dequeue([&val](T& data) { val = std::make_shared<T>(std::move(data)); });
+        return val;
+    }
+
+    void wait_pop(T& val)
+    {
+        for (unsigned int spin = 0; !try_pop(val); ++spin)
+        {
+            Backoff(spin);
+        }
+    }
+
+    std::shared_ptr<T> wait_pop()
+    {
+        std::shared_ptr<T> val;
+        for (unsigned int spin = 0; !(val = try_pop()); ++spin)
+        {
+            Backoff(spin);
+        }
+        return val;
+    }
+
+    // snapshots, may be stale by the time the caller looks at them.
+    bool empty() const { return size() == 0; }
+
+    unsigned int size() const
+    {
+        const size_t enqueued = m_enqueuePos.load(std::memory_order_relaxed);
+        const size_t dequeued = m_dequeuePos.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? static_cast<unsigned int>(enqueued - dequeued) : 0u;
+    }
+
+    size_t capacity() const { return m_mask + 1; }
+
+private:
+    // moves from val only once a slot is claimed.
+    bool Enqueue(T& val)
+    {
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell& cell = m_cells[pos & m_mask];
+            const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    new (cell.Data()) T(std::move(val));
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                // the slot still holds an element from the previous lap, full.
+                return false;
+            }
+            else
+            {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    template<typename Take>
+    bool Dequeue(Take&& take)
+    {
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell& cell = m_cells[pos & m_mask];
+            const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    T* data = cell.Data();
+                    take(*data);
+                    data->~T();
+                    // free for the producer one lap ahead.
+                    cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                // nothing published in this slot yet, empty.
+                return false;
+            }
+            else
+            {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    struct alignas(64) Cell
+    {
+        T* Data() { return reinterpret_cast<T*>(&storage); }
+
+        std::atomic<size_t> sequence{ 0 };
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    static void Backoff(unsigned int spin)
+    {
+        if (spin > 64)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask = 0;
+
+    // producers and consumers on their own cache lines.
+    alignas(64) std::atomic<size_t> m_enqueuePos{ 0 };
+    alignas(64) std::atomic<size_t> m_dequeuePos{ 0 };
+};
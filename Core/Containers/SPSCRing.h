@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <utility>
+
+// Wait free ring for exactly one producer thread and one consumer thread.
+// Storage is allocated once at construction. Each side keeps its own
+// index on its own cache line plus a cached copy of the other side's,
+// so the shared lines are only touched when the cached view runs out.
+// push_n / pop_n move a whole batch with a single release / acquire.
+template<typename T>
+class SPSCRing
+{
+public:
+    // rounded up to a power of two.
+    explicit SPSCRing(size_t capacity = 1024)
+    {
+        size_t size = 2;
+        while (size < capacity) { size <<= 1; }
+
+        m_mask = size - 1;
+        m_items = std::make_unique<T[]>(size);
+    }
+
+    SPSCRing(const SPSCRing&) = delete;
+    SPSCRing& operator=(const SPSCRing&) = delete;
+
+    // producer side.
+    bool try_push(T val)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead > m_mask)
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead > m_mask) { return false; }
+        }
+
+        m_items[tail & m_mask] = std::move(val);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    void push(T val)
+    {
+        while (!try_push(val))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // pushes as many of items as fit, returns how many.
+    size_t push_n(const T* items, size_t count)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t space = capacity() - (tail - m_cachedHead);
+        if (space < count)
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            space = capacity() - (tail - m_cachedHead);
+        }
+
+        const size_t n = std::min(count, space);
+        for (size_t i = 0; i < n; ++i)
+        {
+            m_items[(tail + i) & m_mask] = items[i];
+        }
+
+        if (n > 0)
+        {
+            m_tail.store(tail + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    // consumer side.
+    bool try_pop(T& val)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) { return false; }
+        }
+
+        val = std::move(m_items[head & m_mask]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    void wait_pop(T& val)
+    {
+        while (!try_pop(val))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // pops up to maxCount items into out, returns how many.
+    size_t pop_n(T* out, size_t maxCount)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        size_t available = m_cachedTail - head;
+        if (available < maxCount)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            available = m_cachedTail - head;
+        }
+
+        const size_t n = std::min(maxCount, available);
+        for (size_t i = 0; i < n; ++i)
+        {
+            out[i] = std::move(m_items[(head + i) & m_mask]);
+        }
+
+        if (n > 0)
+        {
+            m_head.store(head + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    // snapshots, exact only on the side that is not racing.
+    size_t size() const
+    {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+    size_t capacity() const { return m_mask + 1; }
+
+private:
+    std::unique_ptr<T[]> m_items;
+    size_t m_mask = 0;
+
+    // consumer owned.
+    alignas(64) std::atomic<size_t> m_head{ 0 };
+    size_t m_cachedTail = 0;
+
+    // producer owned.
+    alignas(64) std::atomic<size_t> m_tail{ 0 };
+    size_t m_cachedHead = 0;
+};
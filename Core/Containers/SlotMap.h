@@ -0,0 +1,177 @@
+#pragma once
+
+#include <assert.h>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Index into a SlotMap's slot table plus the generation the slot had when
+// the value was inserted. Erasing bumps the generation, so old handles to
+// a reused slot are rejected instead of reading someone else's value.
+struct SlotHandle
+{
+    static constexpr uint32_t kInvalidIndex = 0xFFFFFFFFu;
+
+    uint32_t index = kInvalidIndex;
+    uint32_t generation = 0;
+
+    bool IsValid() const { return index != kInvalidIndex; }
+
+    bool operator==(const SlotHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+};
+
+// Values packed in one dense array, reached through generation checked
+// handles. Insert, erase and lookup are O(1); erase moves the last value
+// into the hole, so iteration order changes and pointers into the map are
+// only good until the next insert or erase. Handles stay valid until
+// their value is erased. Not thread safe.
+template<typename T>
+class SlotMap
+{
+public:
+    using value_type = T;
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    SlotMap() = default;
+
+    explicit SlotMap(size_t capacity)
+    {
+        reserve(capacity);
+    }
+
+    template<typename... Args>
+    SlotHandle emplace(Args&&... args)
+    {
+        uint32_t slotIndex = m_freeHead;
+        if (slotIndex != SlotHandle::kInvalidIndex)
+        {
+            m_freeHead = m_slots[slotIndex].index;
+        }
+        else
+        {
+            slotIndex = static_cast<uint32_t>(m_slots.size());
+            m_slots.push_back(Slot{});
+        }
+
+        Slot& slot = m_slots[slotIndex];
+        slot.index = static_cast<uint32_t>(m_values.size());
+        m_values.emplace_back(std::forward<Args>(args)...);
+        m_valueSlots.push_back(slotIndex);
+
+        return SlotHandle{ slotIndex, slot.generation };
+    }
+
+    SlotHandle insert(const T& value) { return emplace(value); }
+    SlotHandle insert(T&& value) { return emplace(std::move(value)); }
+
+    // false if the handle was already erased or never came from this map.
+    bool erase(SlotHandle handle)
+    {
+        if (!contains(handle))
+        {
+            return false;
+        }
+
+        Slot& slot = m_slots[handle.index];
+        const uint32_t hole = slot.index;
+        const uint32_t last = static_cast<uint32_t>(m_values.size() - 1);
+        if (hole != last)
+        {
+            m_values[hole] = std::move(m_values[last]);
+            m_valueSlots[hole] = m_valueSlots[last];
+            m_slots[m_valueSlots[hole]].index = hole;
+        }
+        m_values.pop_back();
+        m_valueSlots.pop_back();
+
+        ++slot.generation;
+        slot.index = m_freeHead;
+        m_freeHead = handle.index;
+        return true;
+    }
+
+    bool contains(SlotHandle handle) const
+    {
+        return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation;
+    }
+
+    // nullptr for stale handles.
+    T* get(SlotHandle handle)
+    {
+        return contains(handle) ? &m_values[m_slots[handle.index].index] : nullptr;
+    }
+
+    const T* get(SlotHandle handle) const
+    {
+        return contains(handle) ? &m_values[m_slots[handle.index].index] : nullptr;
+    }
+
+    T& operator[](SlotHandle handle)
+    {
+        assert(contains(handle) && "SlotMap: stale handle");
+        return m_values[m_slots[handle.index].index];
+    }
+
+    const T& operator[](SlotHandle handle) const
+    {
+        assert(contains(handle) && "SlotMap: stale handle");
+        return m_values[m_slots[handle.index].index];
+    }
+
+    // handle of the value at a dense position, for erasing while iterating by index.
+    SlotHandle handle_at(size_t denseIndex) const
+    {
+        const uint32_t slotIndex = m_valueSlots[denseIndex];
+        return SlotHandle{ slotIndex, m_slots[slotIndex].generation };
+    }
+
+    // every handle handed out so far goes stale, slots are kept for reuse.
+    void clear()
+    {
+        for (uint32_t slotIndex : m_valueSlots)
+        {
+            Slot& slot = m_slots[slotIndex];
+            ++slot.generation;
+            slot.index = m_freeHead;
+            m_freeHead = slotIndex;
+        }
+        m_values.clear();
+        m_valueSlots.clear();
+    }
+
+    void reserve(size_t capacity)
+    {
+        m_values.reserve(capacity);
+        m_valueSlots.reserve(capacity);
+        m_slots.reserve(capacity);
+    }
+
+    size_t size() const { return m_values.size(); }
+    bool empty() const { return m_values.empty(); }
+
+    // the packed values, in no particular order.
+    const std::vector<T>& values() const { return m_values; }
+    T* data() { return m_values.data(); }
+    const T* data() const { return m_values.data(); }
+
+    iterator begin() { return m_values.begin(); }
+    iterator end() { return m_values.end(); }
+    const_iterator begin() const { return m_values.begin(); }
+    const_iterator end() const { return m_values.end(); }
+
+private:
+    struct Slot
+    {
+        // position in m_values while occupied, next free slot once erased.
+        uint32_t index = 0;
+        uint32_t generation = 0;
+    };
+
+    std::vector<T> m_values;
+    std::vector<uint32_t> m_valueSlots; // slot of each value, parallel to m_values
+    std::vector<Slot> m_slots;
+    uint32_t m_freeHead = SlotHandle::kInvalidIndex;
+};
@@ -0,0 +1,311 @@
+#pragma once
+
+#include <algorithm>
+#include <assert.h>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Vector that keeps its first N elements in the object itself and only
+// goes to Allocator once it outgrows them. Meant for the per entity and
+// per query lists (neighbors, search results) that are short almost
+// every time: those never allocate. Same invalidation rules as
+// std::vector, plus moving an inline SmallVector moves its elements,
+// so iterators into it don't follow.
+template<typename T, size_t N, typename Allocator = std::allocator<T>>
+class SmallVector
+{
+    static_assert(N > 0, "SmallVector: inline capacity must be at least 1");
+
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = size_t;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static constexpr size_t kInlineCapacity = N;
+
+    SmallVector() = default;
+
+    explicit SmallVector(const Allocator& allocator)
+        : m_allocator(allocator)
+    {
+    }
+
+    explicit SmallVector(size_t count)
+    {
+        resize(count);
+    }
+
+    SmallVector(size_t count, const T& value)
+    {
+        resize(count, value);
+    }
+
+    SmallVector(std::initializer_list<T> values)
+    {
+        assign_from_span(values.begin(), values.size());
+    }
+
+    ~SmallVector()
+    {
+        clear();
+        FreeHeap();
+    }
+
+    SmallVector(const SmallVector& other)
+        : m_allocator(AllocTraits::select_on_container_copy_construction(other.m_allocator))
+    {
+        assign_from_span(other.data(), other.size());
+    }
+
+    SmallVector& operator=(const SmallVector& other)
+    {
+        if (this != &other)
+        {
+            assign_from_span(other.data(), other.size());
+        }
+        return *this;
+    }
+
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value)
+        : m_allocator(std::move(other.m_allocator))
+    {
+        TakeFrom(other);
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value)
+    {
+        if (this != &other)
+        {
+            clear();
+            FreeHeap();
+            m_allocator = std::move(other.m_allocator);
+            TakeFrom(other);
+        }
+        return *this;
+    }
+
+    template<typename... Args>
+    reference emplace_back(Args&&... args)
+    {
+        if (m_size == m_capacity)
+        {
+            return GrowAndEmplace(std::forward<Args>(args)...);
+        }
+
+        T* slot = new (m_data + m_size) T(std::forward<Args>(args)...);
+        ++m_size;
+        return *slot;
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    void pop_back()
+    {
+        assert(m_size > 0 && "SmallVector: pop_back on empty");
+        m_data[--m_size].~T();
+    }
+
+    // replaces the contents with count elements copied from data. One
+    // memcpy for trivially copyable types, the buffer is reused when it fits.
+    void assign_from_span(const T* data, size_t count)
+    {
+        clear();
+        reserve(count);
+        if (std::is_trivially_copyable<T>::value)
+        {
+            if (count > 0) { std::memcpy(static_cast<void*>(m_data), data, count * sizeof(T)); }
+        }
+        else
+        {
+            std::uninitialized_copy(data, data + count, m_data);
+        }
+        m_size = count;
+    }
+
+    template<typename Container>
+    void assign_from_span(const Container& container)
+    {
+        assign_from_span(std::data(container), std::size(container));
+    }
+
+    template<typename InputIt>
+    void assign(InputIt first, InputIt last)
+    {
+        clear();
+        for (; first != last; ++first) { emplace_back(*first); }
+    }
+
+    void resize(size_t count)
+    {
+        reserve(count);
+        while (m_size > count) { pop_back(); }
+        for (; m_size < count; ++m_size) { new (m_data + m_size) T(); }
+    }
+
+    void resize(size_t count, const T& value)
+    {
+        reserve(count);
+        while (m_size > count) { pop_back(); }
+        for (; m_size < count; ++m_size) { new (m_data + m_size) T(value); }
+    }
+
+    void reserve(size_t capacity)
+    {
+        if (capacity > m_capacity)
+        {
+            T* memory = AllocTraits::allocate(m_allocator, capacity);
+            Relocate(m_data, m_size, memory);
+            FreeHeap();
+            m_data = memory;
+            m_capacity = capacity;
+        }
+    }
+
+    // keeps the heap buffer if there is one.
+    void clear()
+    {
+        if (!std::is_trivially_destructible<T>::value)
+        {
+            for (size_t i = 0; i < m_size; ++i) { m_data[i].~T(); }
+        }
+        m_size = 0;
+    }
+
+    iterator erase(const_iterator position)
+    {
+        return erase(position, position + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        T* begin = m_data + (first - m_data);
+        T* end = m_data + (last - m_data);
+        if (begin != end)
+        {
+            T* newEnd = std::move(end, m_data + m_size, begin);
+            while (m_data + m_size != newEnd) { pop_back(); }
+        }
+        return begin;
+    }
+
+    reference operator[](size_t index)
+    {
+        assert(index < m_size && "SmallVector: outside range");
+        return m_data[index];
+    }
+
+    const_reference operator[](size_t index) const
+    {
+        assert(index < m_size && "SmallVector: outside range");
+        return m_data[index];
+    }
+
+    reference front() { return (*this)[0]; }
+    const_reference front() const { return (*this)[0]; }
+    reference back() { return (*this)[m_size - 1]; }
+    const_reference back() const { return (*this)[m_size - 1]; }
+
+    T* data() { return m_data; }
+    const T* data() const { return m_data; }
+
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_capacity; }
+    bool empty() const { return m_size == 0; }
+
+    // false once the elements had to go to the allocator.
+    bool is_inline() const { return m_data == InlineData(); }
+
+    allocator_type get_allocator() const { return m_allocator; }
+
+    iterator begin() { return m_data; }
+    iterator end() { return m_data + m_size; }
+    const_iterator begin() const { return m_data; }
+    const_iterator end() const { return m_data + m_size; }
+
+private:
+    T* InlineData() { return reinterpret_cast<T*>(m_inline); }
+    const T* InlineData() const { return reinterpret_cast<const T*>(m_inline); }
+
+    // moves count elements from source into uninitialized destination and destroys the sources.
+    static void Relocate(T* source, size_t count, T* destination)
+    {
+        if (std::is_trivially_copyable<T>::value)
+        {
+            if (count > 0) { std::memcpy(static_cast<void*>(destination), source, count * sizeof(T)); }
+            return;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            new (destination + i) T(std::move(source[i]));
+            source[i].~T();
+        }
+    }
+
+    template<typename... Args>
+    reference GrowAndEmplace(Args&&... args)
+    {
+        const size_t capacity = m_capacity * 2;
+        T* memory = AllocTraits::allocate(m_allocator, capacity);
+
+        // built before the old elements move, args may point into them.
+        new (memory + m_size) T(std::forward<Args>(args)...);
+        Relocate(m_data, m_size, memory);
+        FreeHeap();
+
+        m_data = memory;
+        m_capacity = capacity;
+        return m_data[m_size++];
+    }
+
+    // the elements must already be gone.
+    void FreeHeap()
+    {
+        if (!is_inline())
+        {
+            AllocTraits::deallocate(m_allocator, m_data, m_capacity);
+            m_data = InlineData();
+            m_capacity = N;
+        }
+    }
+
+    // other must be the same type, leaves it empty and inline.
+    void TakeFrom(SmallVector& other)
+    {
+        if (other.is_inline())
+        {
+            Relocate(other.m_data, other.m_size, m_data);
+            m_size = other.m_size;
+        }
+        else
+        {
+            m_data = other.m_data;
+            m_size = other.m_size;
+            m_capacity = other.m_capacity;
+            other.m_data = other.InlineData();
+            other.m_capacity = N;
+        }
+        other.m_size = 0;
+    }
+
+    alignas(T) unsigned char m_inline[N * sizeof(T)];
+    T* m_data = InlineData();
+    size_t m_size = 0;
+    size_t m_capacity = N;
+    Allocator m_allocator;
+};
@@ -1,12 +1,13 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <queue>
 #include <mutex>
 #include <condition_variable>
-#include "../CustomMutex.h"
-
-#define USE_CRIT 0
 
+// Unbounded queue behind a single lock. See MPMCQueue for a bounded
+// lock free version with the same interface.
 template<typename T, typename Mutex = std::mutex>
 class ThreadSafeQueue
 {
@@ -14,140 +15,84 @@ public:
     ThreadSafeQueue() {}
     ThreadSafeQueue(const ThreadSafeQueue& copy)
     {
-#if USE_CRIT
-        mutex.lock();
-#else
-        std::lock_guard<std::mutex> lock(m_mutex);
-#endif
+        std::lock_guard<Mutex> lock(copy.m_mutex);
         m_data = copy.m_data;
-        m_size = copy.m_size;
-#if USE_CRIT
-        mutex.unlock();
-#endif
+        m_size.store(copy.m_size.load());
     }
 
     void push(T val)
     {
-#if USE_CRIT
-        mutex.lock();
-#else
-        std::lock_guard<std::mutex> lock(m_mutex);
-#endif
-        m_data.push(val);
-        ++m_size;
+        {
+            std::lock_guard<Mutex> lock(m_mutex);
+            m_data.push(std::move(val));
+            m_size.fetch_add(1, std::memory_order_relaxed);
+        }
         m_cvar.notify_one();
-#if USE_CRIT
-        mutex.unlock();
-#endif
     }
 
     void wait_pop(T& val)
     {
-#if USE_CRIT
-        mutex.lock();
-#else
-        std::lock_guard<std::mutex> lock(m_mutex);
-#endif
-        m_cvar.wait([this]() { return m_size > 0; });
-
-        val = m_data.front();
+        std::unique_lock<Mutex> lock(m_mutex);
+        m_cvar.wait(lock, [this]() { return !m_data.empty(); });
+
+        val = std::move(m_data.front());
         m_data.pop();
-        --m_size;
-#if USE_CRIT
-        mutex.unlock();
-#endif
+        m_size.fetch_sub(1, std::memory_order_relaxed);
     }
 
     std::shared_ptr<T> wait_pop()
     {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        m_cvar.wait([this]() { return !m_data.empty(); });
+        std::unique_lock<Mutex> lock(m_mutex);
+        m_cvar.wait(lock, [this]() { return !m_data.empty(); });
 
-        std::shared_ptr<T> val(std::make_shared<T>(m_data.front()));
+        std::shared_ptr<T> val(std::make_shared<T>(std::move(m_data.front())));
         m_data.pop();
-        --m_size;
-#if USE_CRIT
-        mutex.unlock();
-#endif
+        m_size.fetch_sub(1, std::memory_order_relaxed);
         return val;
     }
 
     bool try_pop(T& val)
     {
-        if (!m_size) { return false; }
-#if USE_CRIT
-        mutex.lock();
-#else
-        std::lock_guard<std::mutex> lock(m_mutex);
-#endif
-
-        val = m_data.front();
-        m_data.pop();
-        --m_size;
+        // cheap early out, checked again under the lock.
+        if (m_size.load(std::memory_order_relaxed) == 0) { return false; }
+
+        std::lock_guard<Mutex> lock(m_mutex);
+        if (m_data.empty()) { return false; }
 
-#if USE_CRIT
-        mutex.unlock();
-#endif
+        val = std::move(m_data.front());
+        m_data.pop();
+        m_size.fetch_sub(1, std::memory_order_relaxed);
         return true;
     }
 
     std::shared_ptr<T> try_pop()
     {
-        if (m_size == 0) { return std::shared_ptr<T>(); }
-#if USE_CRIT
-        mutex.lock();
-#else
-        std::lock_guard<std::mutex> lock(m_mutex);
-#endif
-        std::shared_ptr<T> val(std::make_shared<T>(m_data.front()));
+        if (m_size.load(std::memory_order_relaxed) == 0) { return std::shared_ptr<T>(); }
+
+        std::lock_guard<Mutex> lock(m_mutex);
+        if (m_data.empty()) { return std::shared_ptr<T>(); }
+
+        std::shared_ptr<T> val(std::make_shared<T>(std::move(m_data.front())));
         m_data.pop();
-        --m_size;
-#if USE_CRIT
-        mutex.unlock();
-#endif
+        m_size.fetch_sub(1, std::memory_order_relaxed);
         return val;
     }
 
-    bool empty()
+    // a snapshot, may be stale by the time the caller looks at it.
+    bool empty() const
     {
-        return m_size == 0;
-#if 0
-#if USE_CRIT
-        mutex.lock();
-#else
-        std::lock_guard<std::mutex> lock(m_mutex);
-#endif
-        const bool isEmpty = m_data.empty();
-#if USE_CRIT
-        mutex.unlock();
-#endif
-        return isEmpty;
-#endif
+        return m_size.load(std::memory_order_relaxed) == 0;
     }
 
-    unsigned int size()
+    unsigned int size() const
     {
-        return m_size;
-#if 0
-#if USE_CRIT
-        mutex.lock();
-#else
-        std::lock_guard<std::mutex> lock(m_mutex);
-#endif
-        const unsigned int s = static_cast<unsigned int>(m_data.size());
-
-#if USE_CRIT
-        mutex.unlock();
-#endif
-        return s;
-#endif
+        return m_size.load(std::memory_order_relaxed);
     }
 
 private:
-    CustomMutex mutex;
-    std::mutex m_mutex;
+    mutable Mutex m_mutex;
     std::queue<T> m_data;
-    std::condition_variable m_cvar;
+    std::condition_variable_any m_cvar;
 
-    unsigned int m_size = 0;
-};
\ No newline at end of file
+    std::atomic<unsigned int> m_size{ 0 };
+};
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "../Memory/StackAllocator.h"
+#include "Engine/Utils/Logger.h"
 
 template<typename T>
 struct VectorContainer
@@ -28,7 +28,7 @@ struct VectorContainer
 
     void insert(value_type data)
     {
-        if (m_currentIndex >= m_size - 1) {
+        if (m_currentIndex >= m_size) {
             LOG_ERROR("VectorContainer: buffer is full");
             return;
         }
@@ -38,7 +38,7 @@ struct VectorContainer
 
     value_type get(size_t index)
     {
-        if (index > m_currentIndex) {
+        if (index >= m_currentIndex) {
             LOG_ERROR("VectorContainer: outside range");
             return T();
         }
@@ -51,7 +51,7 @@ struct VectorContainer
     }
 
     pointer begin() { return m_data; }
-    pointer end() { return m_data + m_size - 1; }
+    pointer end() { return m_data + m_currentIndex; }
 
     size_t size() const { return m_currentIndex; }
     size_t capacity() const { return m_size; }
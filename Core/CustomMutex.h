@@ -1,5 +1,8 @@
 #pragma once
 
+#include "AdaptiveMutex.h"
+
+#if defined(_WIN32)
 #define NOMINMAX
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -25,8 +28,7 @@ public:
 
 	bool try_lock()
 	{
-		lock();
-		return true;
+		return TryEnterCriticalSection((CRITICAL_SECTION*)mMutexBuffer) != 0;
 	}
 
 	void unlock() 
@@ -41,3 +43,10 @@ protected:
 	uint32_t mMutexBuffer[24 / sizeof(uint32_t)]; // CRITICAL_SECTION is 24 bytes on Win32.
 #endif
 };
+#else
+// no CRITICAL_SECTION outside Windows, the futex based lock is the closest match.
+class CustomMutex
+	: public AdaptiveMutex
+{
+};
+#endif
@@ -0,0 +1,145 @@
+#include "BehaviorScheduler.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <chrono>
+
+BehaviorScheduler::Handle BehaviorScheduler::Add(Behavior behavior, unsigned int frequency, unsigned int phase,
+	BehaviorPriority priority)
+{
+	assert(behavior);
+	assert(priority < BehaviorPriority::Count);
+
+	std::unique_ptr<Record> record = std::make_unique<Record>();
+	record->fn = std::move(behavior);
+	record->frequency = std::max(frequency, 1u);
+	record->phase = phase % record->frequency;
+	record->priority = priority;
+	return m_records.insert(std::move(record));
+}
+
+void BehaviorScheduler::Remove(Handle handle)
+{
+	assert(!m_isRunning && "BehaviorScheduler: behaviors can't be removed from inside Run");
+	const std::unique_ptr<Record>* record = m_records.get(handle);
+	if (!record)
+	{
+		return;
+	}
+
+	if ((*record)->pending)
+	{
+		auto& pending = m_pending[static_cast<size_t>((*record)->priority)];
+		pending.erase(std::remove(pending.begin(), pending.end(), handle), pending.end());
+	}
+	m_records.erase(handle);
+}
+
+void BehaviorScheduler::Clear()
+{
+	m_records.clear();
+	for (auto& pending : m_pending)
+	{
+		pending.clear();
+	}
+}
+
+void BehaviorScheduler::Run(float budgetMs)
+{
+	using Clock = std::chrono::steady_clock;
+	const Clock::time_point frameStart = Clock::now();
+	auto elapsedMs = [&frameStart]() {
+		return std::chrono::duration<double, std::milli>(Clock::now() - frameStart).count();
+	};
+
+	// queue behaviors that became due this frame behind the ones carried over.
+	for (size_t i = 0; i < m_records.size(); ++i)
+	{
+		Record& record = *m_records.values()[i];
+		if ((m_frame + record.phase) % record.frequency != 0)
+		{
+			continue;
+		}
+
+		if (record.pending)
+		{
+			// still waiting from an earlier slot, don't queue it twice.
+			continue;
+		}
+
+		record.pending = true;
+		m_pending[static_cast<size_t>(record.priority)].push_back(m_records.handle_at(i));
+	}
+
+	m_isRunning = true;
+
+	FrameStats frame;
+	bool outOfBudget = false;
+	for (auto& pending : m_pending)
+	{
+		size_t kept = 0;
+		for (size_t i = 0; i < pending.size(); ++i)
+		{
+			const Handle handle = pending[i];
+			Record& record = *m_records[handle];
+
+			// waited too long, runs over budget rather than starve.
+			const bool starved = record.deferredFrames >= kMaxDeferredFrames;
+			double used = 0.0;
+			bool fits = false;
+			if (!outOfBudget || starved)
+			{
+				used = elapsedMs();
+				outOfBudget = outOfBudget || used >= budgetMs;
+
+				// leave room for cheaper work.
+				fits = !outOfBudget && (frame.ran == 0 || used + record.stats.AverageMs() <= budgetMs);
+			}
+
+			if (fits || starved)
+			{
+				const Clock::time_point start = Clock::now();
+				record.fn(static_cast<float>(std::max(budgetMs - used, 0.0)));
+				const double cost = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+				record.pending = false;
+				record.deferredFrames = 0;
+				record.stats.runs++;
+				record.stats.lastMs = cost;
+				record.stats.totalMs += cost;
+				frame.ran++;
+				continue;
+			}
+
+			// carries over to the next frame, keeping its place in line.
+			record.deferredFrames++;
+			record.stats.skips++;
+			pending[kept++] = handle;
+		}
+
+		pending.resize(kept);
+		frame.deferred += kept;
+	}
+
+	m_isRunning = false;
+
+	frame.usedMs = elapsedMs();
+	m_lastFrame = frame;
+	++m_frame;
+}
+
+size_t BehaviorScheduler::GetPendingCount() const
+{
+	size_t count = 0;
+	for (const auto& pending : m_pending)
+	{
+		count += pending.size();
+	}
+	return count;
+}
+
+const BehaviorStats* BehaviorScheduler::GetStats(Handle handle) const
+{
+	const std::unique_ptr<Record>* record = m_records.get(handle);
+	return record ? &(*record)->stats : nullptr;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "../Containers/SlotMap.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+enum class BehaviorPriority : unsigned int
+{
+	High = 0,
+	Normal,
+	Low,
+
+	Count
+};
+
+struct BehaviorStats
+{
+	uint64_t runs = 0;
+	// frames the behavior was due but deferred because the budget ran out.
+	uint64_t skips = 0;
+	double totalMs = 0.0;
+	double lastMs = 0.0;
+
+	double AverageMs() const { return runs > 0 ? totalMs / static_cast<double>(runs) : 0.0; }
+};
+
+// Spreads recurring work over frames (frequency / phase scheduling).
+// A behavior with frequency F and phase P is due on frames where
+// (frame + P) % F == 0. Due behaviors run in priority order, oldest first,
+// until the frame budget is spent; the rest carry over to later frames.
+class BehaviorScheduler
+{
+public:
+	// receives the milliseconds left in this frame's budget.
+	using Behavior = std::function<void(float)>;
+	// generation checked, a removed behavior's handle stays stale after
+	// its slot is reused.
+	using Handle = SlotHandle;
+	static constexpr Handle InvalidHandle = {};
+	static constexpr unsigned int kMaxDeferredFrames = 8;
+
+	struct FrameStats
+	{
+		size_t ran = 0;
+		size_t deferred = 0;
+		double usedMs = 0.0;
+	};
+
+	Handle Add(Behavior behavior, unsigned int frequency, unsigned int phase,
+		BehaviorPriority priority = BehaviorPriority::Normal);
+	void Remove(Handle handle);
+	void Clear();
+
+	// runs due behaviors until budgetMs is used. a behavior whose average
+	// cost would overrun the budget is passed over for cheaper ones, unless
+	// nothing ran yet this frame. one deferred kMaxDeferredFrames times runs
+	// even once the budget is spent, so low priority work can't starve.
+	void Run(float budgetMs);
+
+	size_t Size() const { return m_records.size(); }
+	bool Empty() const { return m_records.empty(); }
+	size_t GetPendingCount() const;
+	uint64_t GetFrame() const { return m_frame; }
+
+	const BehaviorStats* GetStats(Handle handle) const;
+	const FrameStats& GetLastFrameStats() const { return m_lastFrame; }
+
+	template<typename Fn>
+	void ForEachStats(Fn&& fn) const
+	{
+		for (size_t i = 0; i < m_records.size(); ++i)
+		{
+			const Record& record = *m_records.values()[i];
+			fn(m_records.handle_at(i), record.priority, record.stats);
+		}
+	}
+
+private:
+	struct Record
+	{
+		Behavior fn;
+		unsigned int frequency = 1;
+		unsigned int phase = 0;
+		BehaviorPriority priority = BehaviorPriority::Normal;
+		bool pending = false;
+		unsigned int deferredFrames = 0;
+		BehaviorStats stats;
+	};
+
+	// boxed, so behaviors can add others while they run.
+	SlotMap<std::unique_ptr<Record>> m_records;
+
+	// per priority, due behaviors in the order they became due.
+	std::vector<Handle> m_pending[static_cast<size_t>(BehaviorPriority::Count)];
+
+	uint64_t m_frame = 0;
+	FrameStats m_lastFrame;
+	bool m_isRunning = false;
+};
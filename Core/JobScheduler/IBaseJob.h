@@ -1,17 +1,29 @@
 #pragma once
-#include <functional>
+#include "InlineFunction.h"
 #include <assert.h>
 
+struct JobCounter;
+
 struct IBaseJob
 {
     virtual void Execute() = 0;
+
+    // called by the scheduler after Execute, before the counter is released.
+    // pooled jobs return themselves to their pool here.
+    virtual void Finish() {}
+
+    // set by JobScheduler::AddJob, decremented once Execute returns.
+    JobCounter* m_counter = nullptr;
 };
 
+// captures are stored inline, a lambda capturing more than this won't compile.
+using JobFunction = InlineFunction<void(), 64>;
+
 struct GenericJob
     : IBaseJob
 {
-    GenericJob(std::function<void(void)> func)
-        : fn(func)
+    GenericJob(JobFunction func)
+        : fn(std::move(func))
     {
         assert(fn);
     }
@@ -21,6 +33,5 @@ struct GenericJob
         fn();
     }
 
-    std::function<void(void)> fn{};
+    JobFunction fn{};
 };
-   
\ No newline at end of file
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <assert.h>
+
+// std::function replacement that never allocates: the callable is stored
+// in a fixed inline buffer and anything larger fails to compile.
+template<typename Signature, size_t Capacity = 64>
+class InlineFunction;
+
+template<typename R, typename... Args, size_t Capacity>
+class InlineFunction<R(Args...), Capacity>
+{
+public:
+	InlineFunction() = default;
+
+	InlineFunction(std::nullptr_t) {}
+
+	template<typename F, typename Fn = std::decay_t<F>,
+		typename = std::enable_if_t<!std::is_same<Fn, InlineFunction>::value>>
+	InlineFunction(F&& f)
+	{
+		static_assert(sizeof(Fn) <= Capacity, "InlineFunction: callable too large, capture less or raise Capacity");
+		static_assert(alignof(Fn) <= alignof(std::max_align_t), "InlineFunction: callable is over aligned");
+
+		new (&m_storage) Fn(std::forward<F>(f));
+		m_invoke = &Invoke<Fn>;
+		m_manage = &Manage<Fn>;
+	}
+
+	// move only, so move only callables (a job owning a buffer) can be stored.
+	InlineFunction(const InlineFunction&) = delete;
+	InlineFunction& operator=(const InlineFunction&) = delete;
+
+	InlineFunction(InlineFunction&& other) noexcept
+	{
+		if (other.m_manage)
+		{
+			other.m_manage(Operation::Move, &m_storage, &other.m_storage);
+			m_invoke = other.m_invoke;
+			m_manage = other.m_manage;
+			other.Reset();
+		}
+	}
+
+	InlineFunction& operator=(InlineFunction&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Reset();
+			if (other.m_manage)
+			{
+				other.m_manage(Operation::Move, &m_storage, &other.m_storage);
+				m_invoke = other.m_invoke;
+				m_manage = other.m_manage;
+				other.Reset();
+			}
+		}
+		return *this;
+	}
+
+	InlineFunction& operator=(std::nullptr_t)
+	{
+		Reset();
+		return *this;
+	}
+
+	~InlineFunction()
+	{
+		Reset();
+	}
+
+	R operator()(Args... args)
+	{
+		assert(m_invoke && "InlineFunction: calling an empty function");
+		return m_invoke(&m_storage, std::forward<Args>(args)...);
+	}
+
+	explicit operator bool() const { return m_invoke != nullptr; }
+
+	void Reset()
+	{
+		if (m_manage)
+		{
+			m_manage(Operation::Destroy, &m_storage, nullptr);
+		}
+		m_invoke = nullptr;
+		m_manage = nullptr;
+	}
+
+	static constexpr size_t capacity() { return Capacity; }
+
+private:
+	using Storage = std::aligned_storage_t<Capacity, alignof(std::max_align_t)>;
+
+	enum class Operation { Move, Destroy };
+
+	template<typename Fn>
+	static R Invoke(void* storage, Args&&... args)
+	{
+		return (*static_cast<Fn*>(storage))(std::forward<Args>(args)...);
+	}
+
+	template<typename Fn>
+	static void Manage(Operation op, void* dst, void* src)
+	{
+		switch (op)
+		{
+		case Operation::Move:
+			new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+			break;
+		case Operation::Destroy:
+			static_cast<Fn*>(dst)->~Fn();
+			break;
+		}
+	}
+
+	Storage m_storage;
+	R(*m_invoke)(void*, Args&&...) = nullptr;
+	void(*m_manage)(Operation, void*, void*) = nullptr;
+};
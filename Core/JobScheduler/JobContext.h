@@ -0,0 +1,142 @@
+#pragma once
+
+#include "../Memory/MemoryResource.h"
+
+#include <cstddef>
+#include <memory_resource>
+
+// What a job can reach on the thread it runs on. Scratch() is a bump
+// arena owned by the calling thread, so temporaries built inside a job
+// take no lock and never touch the global heap. The scheduler rolls the
+// arena back when each job returns, so nothing taken from it may outlive
+// the job. Outside of jobs use a ScratchScope, or the memory is released
+// when JobScheduler::Run starts the next frame on that thread.
+class JobContext
+{
+public:
+	// per thread, only touched pages are ever committed.
+	static constexpr size_t kScratchBytes = static_cast<size_t>(DefaultSize::OneMB) * 4;
+
+	// falls back to the heap when the arena is full.
+	static std::pmr::memory_resource* Scratch() { return &Get().resource; }
+	static LinearAllocator& ScratchArena() { return Get().arena; }
+
+	// true while the calling thread is running a job.
+	static bool InJob() { return Get().jobDepth > 0; }
+
+	// gives back everything the calling thread took from its arena since construction.
+	class ScratchScope
+	{
+	public:
+		ScratchScope()
+			: m_arena(ScratchArena())
+			, m_marker(m_arena.GetMarker())
+		{
+		}
+
+		~ScratchScope()
+		{
+			m_arena.Rollback(m_marker);
+		}
+
+		ScratchScope(const ScratchScope&) = delete;
+		ScratchScope& operator=(const ScratchScope&) = delete;
+
+	private:
+		LinearAllocator& m_arena;
+		LinearAllocator::Marker m_marker;
+	};
+
+	// frees the whole arena of the calling thread, ignored inside a job.
+	static void ResetScratch()
+	{
+		ThreadScratch& scratch = Get();
+		if (scratch.jobDepth == 0)
+		{
+			scratch.arena.Reset();
+		}
+	}
+
+private:
+	friend class JobScheduler;
+
+	struct ThreadScratch
+	{
+		LinearAllocator arena{ kScratchBytes };
+		LinearMemoryResource resource{ arena };
+		// jobs nest when a job waits and runs others meanwhile.
+		int jobDepth = 0;
+	};
+
+	static ThreadScratch& Get()
+	{
+		thread_local ThreadScratch scratch;
+		return scratch;
+	}
+
+public:
+	// marks a job running on this thread, its scratch goes when it returns.
+	// also for job bodies run directly by the caller (ParallelFor's chunks).
+	class JobScope
+	{
+	public:
+		JobScope()
+			: m_scratch(Get())
+			, m_marker(m_scratch.arena.GetMarker())
+		{
+			++m_scratch.jobDepth;
+		}
+
+		~JobScope()
+		{
+			--m_scratch.jobDepth;
+			m_scratch.arena.Rollback(m_marker);
+		}
+
+		JobScope(const JobScope&) = delete;
+		JobScope& operator=(const JobScope&) = delete;
+
+	private:
+		ThreadScratch& m_scratch;
+		LinearAllocator::Marker m_marker;
+	};
+};
+
+// std allocator on the scratch of the thread that created it, for
+// containers that live inside one job or one ScratchScope:
+// std::vector<int, ScratchAllocator<int>> values;
+// Copies of the container start on the copying thread's scratch.
+template<typename T>
+class ScratchAllocator
+{
+public:
+	using value_type = T;
+
+	ScratchAllocator() : m_resource(JobContext::Scratch()) {}
+
+	template<typename U>
+	ScratchAllocator(const ScratchAllocator<U>& other) : m_resource(other.m_resource) {}
+
+	T* allocate(size_t count)
+	{
+		return static_cast<T*>(m_resource->allocate(count * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* data, size_t count)
+	{
+		m_resource->deallocate(data, count * sizeof(T), alignof(T));
+	}
+
+	ScratchAllocator select_on_container_copy_construction() const { return ScratchAllocator(); }
+
+	template<typename U>
+	bool operator==(const ScratchAllocator<U>& other) const { return m_resource == other.m_resource; }
+	template<typename U>
+	bool operator!=(const ScratchAllocator<U>& other) const { return m_resource != other.m_resource; }
+
+private:
+	template<typename U>
+	friend class ScratchAllocator;
+
+	std::pmr::memory_resource* m_resource;
+};
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <atomic>
+
+// Counts outstanding jobs submitted against it. Submitting increments it,
+// finishing a job decrements it, JobScheduler::WaitForCounter waits for it
+// to drop to a target value while running other jobs.
+// Must outlive every job submitted against it.
+struct JobCounter
+{
+	JobCounter() = default;
+	JobCounter(const JobCounter&) = delete;
+	JobCounter& operator=(const JobCounter&) = delete;
+
+	int Get() const { return m_value.load(std::memory_order_acquire); }
+	bool IsDone() const { return Get() == 0; }
+
+	std::atomic<int> m_value{ 0 };
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "IBaseJob.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+class JobPool;
+
+// Job slot handed out by JobScheduler::AddJob(fn). Goes back to its pool
+// once it has run.
+struct alignas(64) PooledJob
+    : IBaseJob
+{
+    void Execute() override { fn(); }
+    void Finish() override;
+
+    JobFunction fn;
+    JobPool* pool = nullptr;
+    PooledJob* next = nullptr;
+};
+
+// Fixed set of job slots, allocated once. Only the owning thread allocates
+// (or any thread while holding the lock for the shared pool). Any thread can
+// free: freed slots go to a lock free list the owner takes over in one go
+// once its local list runs out.
+class JobPool
+{
+public:
+    explicit JobPool(size_t capacity)
+        : m_slots(std::make_unique<PooledJob[]>(capacity))
+        , m_capacity(capacity)
+    {
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            m_slots[i].pool = this;
+            m_slots[i].next = i + 1 < capacity ? &m_slots[i + 1] : nullptr;
+        }
+        m_localFree = capacity > 0 ? &m_slots[0] : nullptr;
+    }
+
+    JobPool(const JobPool&) = delete;
+    JobPool& operator=(const JobPool&) = delete;
+
+    // nullptr when every slot is in flight.
+    PooledJob* Allocate()
+    {
+        if (!m_localFree)
+        {
+            m_localFree = m_remoteFree.exchange(nullptr, std::memory_order_acquire);
+            if (!m_localFree)
+            {
+                return nullptr;
+            }
+        }
+
+        PooledJob* job = m_localFree;
+        m_localFree = job->next;
+        job->next = nullptr;
+        return job;
+    }
+
+    void Free(PooledJob* job)
+    {
+        job->fn.Reset();
+        job->m_counter = nullptr;
+
+        PooledJob* head = m_remoteFree.load(std::memory_order_relaxed);
+        do
+        {
+            job->next = head;
+        } while (!m_remoteFree.compare_exchange_weak(head, job,
+            std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    size_t capacity() const { return m_capacity; }
+
+    // guards Allocate for the pool shared by threads outside the scheduler.
+    std::mutex& GetMutex() { return m_mutex; }
+
+private:
+    std::unique_ptr<PooledJob[]> m_slots;
+    size_t m_capacity = 0;
+
+    PooledJob* m_localFree = nullptr;
+    alignas(64) std::atomic<PooledJob*> m_remoteFree{ nullptr };
+
+    std::mutex m_mutex;
+};
+
+inline void PooledJob::Finish()
+{
+    pool->Free(this);
+}
@@ -1,3 +1,449 @@
 #include "JobScheduler.h"
 
-JobScheduler JobScheduler::m_instance;
\ No newline at end of file
+#include "../Profiler.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CPU_RELAX() _mm_pause()
+#else
+#define CPU_RELAX() std::this_thread::yield()
+#endif
+
+JobScheduler JobScheduler::m_instance;
+
+namespace
+{
+	// spin iterations before a worker with nothing to do parks.
+	constexpr int kSpinCount = 256;
+	// jobs a full PushJob runs to make room can push too, past this many
+	// nested levels the new job runs inline instead.
+	constexpr int kMaxHelpDepth = 8;
+
+	thread_local const JobScheduler* t_owner = nullptr;
+	thread_local int t_workerIndex = -1;
+	thread_local unsigned int t_stealSeed = 0u;
+	thread_local int t_helpDepth = 0;
+
+	unsigned int NextVictim(unsigned int count)
+	{
+		// xorshift, only needs to spread thieves across queues.
+		unsigned int x = t_stealSeed ? t_stealSeed : 0x9E3779B9u;
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		t_stealSeed = x;
+		return x % count;
+	}
+}
+
+int JobScheduler::GetWorkerIndex() const
+{
+	return t_owner == this ? t_workerIndex : -1;
+}
+
+size_t JobScheduler::GetLocalQueueSize() const
+{
+	const int index = GetWorkerIndex();
+	if (index < 0 || index >= static_cast<int>(m_queues.size()))
+	{
+		return 0u;
+	}
+	return m_queues[index]->size();
+}
+
+void JobScheduler::Init(unsigned int numThreads)
+{
+#if ENABLE_MT_JS
+	if (m_running.load())
+	{
+		return;
+	}
+
+	unsigned int availableThreads = numThreads;
+	if (availableThreads == 0)
+	{
+		availableThreads = std::min(std::max(std::thread::hardware_concurrency(), 1u), MAX_THREADS);
+	}
+
+	m_queues.clear();
+	m_pools.clear();
+	for (unsigned int i = 0; i < availableThreads; i++)
+	{
+		m_queues.push_back(std::make_unique<JobQueue>());
+		m_pools.push_back(std::make_unique<JobPool>(JobPoolCapacity));
+	}
+	m_pools.push_back(std::make_unique<JobPool>(JobPoolCapacity));
+
+	m_injected.assign(InjectCapacity, nullptr);
+	m_injectedHead = 0;
+	m_injectedCount.store(0);
+	m_inlineJobs.store(0);
+
+	// calling thread owns queue 0 and helps out whenever it waits on jobs.
+	t_owner = this;
+	t_workerIndex = 0;
+	t_stealSeed = 0x9E3779B9u;
+
+	m_running.store(true);
+	m_startedWorkers.store(0);
+	for (unsigned int i = 1; i < availableThreads; i++)
+	{
+		m_runningThreads.emplace_back([this, i]() { WorkLoop(i); });
+	}
+
+	// so nothing a worker sets up on its first run lands in the first frame.
+	while (m_startedWorkers.load(std::memory_order_acquire) < availableThreads - 1)
+	{
+		std::this_thread::yield();
+	}
+#endif
+}
+
+void JobScheduler::Cleanup()
+{
+#if ENABLE_MT_JS
+	if (!m_running.exchange(false))
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_parkMutex);
+		m_parkCvar.notify_all();
+	}
+
+	for (size_t i = 0; i < m_runningThreads.size(); i++)
+	{
+		m_runningThreads[i].join();
+	}
+	m_runningThreads.clear();
+
+	// drain whatever was left so callers waiting on these jobs are not stranded.
+	while (TryRunPendingJob()) {}
+
+	m_queues.clear();
+	m_pools.clear();
+	if (t_owner == this)
+	{
+		t_owner = nullptr;
+		t_workerIndex = -1;
+	}
+#endif
+}
+
+void JobScheduler::AddJob(IBaseJob* job)
+{
+	AddJob(job, nullptr);
+}
+
+void JobScheduler::AddJob(IBaseJob* job, JobCounter* counter)
+{
+	assert(job);
+	job->m_counter = counter;
+	if (counter)
+	{
+		counter->m_value.fetch_add(1, std::memory_order_relaxed);
+	}
+	PushJob(job);
+}
+
+void JobScheduler::AddJobs(IBaseJob** jobs, size_t count, JobCounter* counter)
+{
+	if (counter)
+	{
+		counter->m_value.fetch_add(static_cast<int>(count), std::memory_order_relaxed);
+	}
+	for (size_t i = 0; i < count; ++i)
+	{
+		assert(jobs[i]);
+		jobs[i]->m_counter = counter;
+		PushJob(jobs[i]);
+	}
+}
+
+void JobScheduler::WaitForCounter(JobCounter* counter, int value)
+{
+	assert(counter);
+	int idleSpins = 0;
+	while (counter->Get() > value)
+	{
+		if (TryRunPendingJob())
+		{
+			idleSpins = 0;
+			continue;
+		}
+
+		// our jobs are running elsewhere, back off but stay responsive.
+		if (++idleSpins < kSpinCount)
+		{
+			CPU_RELAX();
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JobScheduler::ExecuteJob(IBaseJob* job)
+{
+	// the job may be released by a waiter as soon as the counter drops,
+	// so read it before running.
+	JobCounter* counter = job->m_counter;
+	{
+		// whatever the job took from its thread's scratch goes back here.
+		JobContext::JobScope scratch;
+		job->Execute();
+	}
+	job->Finish();
+	if (counter)
+	{
+		counter->m_value.fetch_sub(1, std::memory_order_release);
+	}
+}
+
+void JobScheduler::PushJob(IBaseJob* job)
+{
+#if ENABLE_MT_JS
+	if (!m_running.load(std::memory_order_relaxed))
+	{
+		ExecuteJob(job);
+		return;
+	}
+
+	// count first so a thief can never take the job before it is accounted for.
+	m_queuedJobs.fetch_add(1, std::memory_order_seq_cst);
+
+	const int index = t_owner == this ? t_workerIndex : -1;
+	JobQueue* own = index >= 0 && index < static_cast<int>(m_queues.size()) ? m_queues[index].get() : nullptr;
+	while (!(own && own->push(job)) && !PushInjected(job))
+	{
+		// everything is full: run a job that is already queued to make room
+		// rather than grow anything or run this one ahead of it.
+		if (t_helpDepth >= kMaxHelpDepth)
+		{
+			m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+			m_inlineJobs.fetch_add(1, std::memory_order_relaxed);
+			ExecuteJob(job);
+			return;
+		}
+
+		++t_helpDepth;
+		const bool ran = TryRunPendingJob();
+		--t_helpDepth;
+		if (!ran)
+		{
+			// taken by the workers in the meantime, there is room now.
+			std::this_thread::yield();
+		}
+	}
+
+	WakeOne();
+#else
+	ExecuteJob(job);
+#endif
+}
+
+void JobScheduler::Run(float budgetMs)
+{
+	// new frame, scratch taken outside of jobs on this thread is done with.
+	JobContext::ResetScratch();
+
+	{
+		std::lock_guard<std::mutex> lock(m_nextFrameMutex);
+		m_frameJobs.swap(m_nextFrameJobs);
+	}
+
+	for (JobFunction& fn : m_frameJobs)
+	{
+		AddJob(std::move(fn));
+	}
+	m_frameJobs.clear();
+	PROFILE_COUNTER("Queued Jobs", GetQueuedJobCount());
+
+	m_behaviors.Run(budgetMs);
+}
+
+bool JobScheduler::PushInjected(IBaseJob* job)
+{
+	std::lock_guard<std::mutex> lock(m_injectMutex);
+	const size_t count = static_cast<size_t>(m_injectedCount.load(std::memory_order_relaxed));
+	if (count >= m_injected.size())
+	{
+		return false;
+	}
+
+	m_injected[(m_injectedHead + count) % m_injected.size()] = job;
+	m_injectedCount.store(static_cast<int>(count + 1), std::memory_order_release);
+	return true;
+}
+
+PooledJob* JobScheduler::AllocateJob()
+{
+#if ENABLE_MT_JS
+	if (m_pools.empty())
+	{
+		return nullptr;
+	}
+
+	const int index = GetWorkerIndex();
+	const bool shared = index < 0 || index >= static_cast<int>(m_pools.size()) - 1;
+	JobPool& pool = shared ? *m_pools.back() : *m_pools[index];
+	for (;;)
+	{
+		PooledJob* job = nullptr;
+		if (shared)
+		{
+			std::lock_guard<std::mutex> lock(pool.GetMutex());
+			job = pool.Allocate();
+		}
+		else
+		{
+			job = pool.Allocate();
+		}
+		if (job)
+		{
+			return job;
+		}
+
+		// every slot is in flight: run queued jobs until one comes back,
+		// like a full PushJob.
+		if (t_helpDepth >= kMaxHelpDepth)
+		{
+			return nullptr;
+		}
+		++t_helpDepth;
+		const bool ran = TryRunPendingJob();
+		--t_helpDepth;
+		if (!ran)
+		{
+			std::this_thread::yield();
+		}
+	}
+#else
+	return nullptr;
+#endif
+}
+
+bool JobScheduler::TryRunPendingJob()
+{
+#if ENABLE_MT_JS
+	const int index = t_owner == this ? t_workerIndex : -1;
+	IBaseJob* job = FindJob(index >= 0 ? static_cast<unsigned int>(index) : 0u, index >= 0);
+	if (job)
+	{
+		ExecuteJob(job);
+		return true;
+	}
+#endif
+	return false;
+}
+
+void JobScheduler::WorkLoop(unsigned int index)
+{
+	t_owner = this;
+	t_workerIndex = static_cast<int>(index);
+	t_stealSeed = 0x9E3779B9u * (index + 1);
+	Profiler::GetInstance().SetThreadName("Job Worker");
+	m_startedWorkers.fetch_add(1, std::memory_order_release);
+
+	while (m_running.load(std::memory_order_acquire))
+	{
+		if (IBaseJob* job = FindJob(index, true))
+		{
+			ExecuteJob(job);
+			continue;
+		}
+
+		// briefly spin before parking, work tends to arrive in bursts.
+		bool hasWork = false;
+		for (int i = 0; i < kSpinCount && !hasWork; ++i)
+		{
+			CPU_RELAX();
+			hasWork = m_queuedJobs.load(std::memory_order_relaxed) > 0;
+		}
+
+		if (!hasWork)
+		{
+			Park();
+		}
+	}
+}
+
+IBaseJob* JobScheduler::FindJob(unsigned int index, bool isPoolThread)
+{
+	if (m_queuedJobs.load(std::memory_order_acquire) <= 0)
+	{
+		return nullptr;
+	}
+
+	IBaseJob* job = nullptr;
+	const unsigned int count = static_cast<unsigned int>(m_queues.size());
+
+	// own work first, newest first.
+	if (isPoolThread && index < count && m_queues[index]->pop(job))
+	{
+		m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+		return job;
+	}
+
+	if (m_injectedCount.load(std::memory_order_acquire) > 0)
+	{
+		std::lock_guard<std::mutex> lock(m_injectMutex);
+		const int injected = m_injectedCount.load(std::memory_order_relaxed);
+		if (injected > 0)
+		{
+			job = m_injected[m_injectedHead];
+			m_injectedHead = (m_injectedHead + 1) % m_injected.size();
+			m_injectedCount.store(injected - 1, std::memory_order_relaxed);
+		}
+	}
+	if (job)
+	{
+		m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+		return job;
+	}
+
+	// steal oldest work from a random victim.
+	if (count > 0)
+	{
+		const unsigned int start = NextVictim(count);
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			const unsigned int victim = (start + i) % count;
+			if (isPoolThread && victim == index)
+			{
+				continue;
+			}
+
+			if (m_queues[victim]->steal(job))
+			{
+				m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+				return job;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+void JobScheduler::Park()
+{
+	std::unique_lock<std::mutex> lock(m_parkMutex);
+	m_parkedWorkers.fetch_add(1, std::memory_order_seq_cst);
+	m_parkCvar.wait(lock, [this]() {
+		return !m_running.load() || m_queuedJobs.load(std::memory_order_seq_cst) > 0;
+		});
+	m_parkedWorkers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void JobScheduler::WakeOne()
+{
+	// m_queuedJobs is bumped before this check, so a worker that registered
+	// as parked after we read 0 here still sees the job in its wait predicate.
+	if (m_parkedWorkers.load(std::memory_order_seq_cst) > 0)
+	{
+		std::lock_guard<std::mutex> lock(m_parkMutex);
+		m_parkCvar.notify_one();
+	}
+}
@@ -1,24 +1,39 @@
 #pragma once
 
-#include "../Containers/ThreadSafeQueue.h"
 #include "IBaseJob.h"
+#include "JobContext.h"
+#include "JobCounter.h"
+#include "JobPool.h"
+#include "BehaviorScheduler.h"
+#include "WorkStealingQueue.h"
 
 #include <memory>
 #include <thread>
 #include <algorithm>
 #include <chrono>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
 #include <set>
 #include <map>
 
 #define MAX_THREADS 8u
 
-#define ENABLE_MT_JS 0
+// 0 runs every job inline on the submitting thread.
+#define ENABLE_MT_JS 1
 
 class JobScheduler
 {
 public:
-	using JobBehavior = std::function<void(int)>;
+	using JobBehavior = BehaviorScheduler::Behavior;
+
+	static constexpr size_t QueueCapacity = 4096;
+	using JobQueue = WorkStealingQueue<IBaseJob*, QueueCapacity>;
+
+	// pooled job slots per thread, and slots in the shared injection ring.
+	static constexpr size_t JobPoolCapacity = 4096;
+	static constexpr size_t InjectCapacity = 16384;
 
 	static JobScheduler& GetInstance()
 	{
@@ -32,141 +47,144 @@ public:
 
 	~JobScheduler()
 	{
-
+		Cleanup();
 	}
 
-	void Init()
-	{
-#if ENABLE_MT_JS
-		unsigned int availableThreads = std::min(std::thread::hardware_concurrency(), MAX_THREADS);
-		for (size_t i = 0; i < availableThreads; i++)
-		{
-			std::thread t([&]() { WorkLoop(); });
-			m_runningThreads.push_back(std::move(t));
-		}
-		m_running.store(true);
-#endif
-	}
+	// numThreads counts the calling thread, which owns queue 0.
+	// 0 picks min(hardware_concurrency, MAX_THREADS). Returns once every
+	// worker is running.
+	void Init(unsigned int numThreads = 0);
+	void Cleanup();
 
-	void Cleanup()
-	{
-#if ENABLE_MT_JS
-		m_running.store(false);
-		for (size_t i = 0; i < m_runningThreads.size(); i++)
-		{
-			m_runningThreads[i].join();
-		}
-#endif
-	}
+	void AddJob(IBaseJob* job);
 
-	void WorkLoop()
+	// counter is incremented now and decremented when the job finishes.
+	void AddJob(IBaseJob* job, JobCounter* counter);
+	void AddJobs(IBaseJob** jobs, size_t count, JobCounter* counter);
+
+	// runs fn on the pool without touching the heap: the job comes from the
+	// calling thread's JobPool and fn is stored inline (see JobFunction).
+	// if every slot is in flight the caller runs queued jobs until one is
+	// free, fn only runs right away when that nests too deep.
+	template<typename Fn, typename = std::enable_if_t<!std::is_convertible<Fn, IBaseJob*>::value>>
+	void AddJob(Fn&& fn, JobCounter* counter = nullptr)
 	{
-#if ENABLE_MT_JS
-		while (m_running.load())
+		PooledJob* job = AllocateJob();
+		if (!job)
 		{
-			if (!m_jobs.empty())
-			{
-				// grab a job and execute.
-				IBaseJob* job{};
-				if (m_jobs.try_pop(job))
-				{
-					job->Execute();
-				}
-			}
-			else
-			{
-				std::this_thread::sleep_for(std::chrono::milliseconds(10));
-			}
+			m_inlineJobs.fetch_add(1, std::memory_order_relaxed);
+			JobContext::JobScope scratch;
+			fn();
+			return;
 		}
-#endif
-	}
 
-	void AddJob(IBaseJob* job)
-	{
-#if ENABLE_MT_JS
-		m_jobs.push(job);
-#endif
+		job->fn = JobFunction(std::forward<Fn>(fn));
+		AddJob(job, counter);
 	}
 
+	// returns once counter <= value. the calling thread runs pending jobs
+	// meanwhile instead of blocking, so waiting from inside a job is fine.
+	void WaitForCounter(JobCounter* counter, int value = 0);
+
+	// pops/steals one job and runs it on the calling thread.
+	// returns false if no job could be found.
+	bool TryRunPendingJob();
+
 	bool HasJobs()
 	{
 #if ENABLE_MT_JS
-		return !m_jobs.empty();
+		if (m_queuedJobs.load(std::memory_order_acquire) > 0)
+		{
+			return true;
+		}
 #endif
-		return !behaviorRecords.empty();
+		return !m_behaviors.Empty();
 	}
 
-	size_t Size() const { return behaviorRecords.size(); }
-
+	size_t Size() const { return m_behaviors.Size(); }
 
-	void AddBehavior(JobBehavior function, int frequency, int phase)
-	{
-		BehaviorRecord br;
-		br.fn = function;
-		br.frequency = frequency;
-		br.phase = phase;
-		behaviorRecords.push_back(br);
-	}
+	// number of threads executing jobs, including the one that called Init.
+	unsigned int GetWorkerCount() const { return static_cast<unsigned int>(m_queues.size()); }
 
-	void Run(int timeToRun)
-	{
-		++frame;
+	// index of the calling thread's queue, or -1 for threads outside the pool.
+	int GetWorkerIndex() const;
 
-		std::vector<BehaviorRecord> toRunThisFrame;
-		for (auto it = behaviorRecords.begin(); it != behaviorRecords.end();)
-		{
-			if (it->frequency % (frame + it->phase)) 
-			{
-				toRunThisFrame.push_back(*it);
-				it = behaviorRecords.erase(it);
-			}
-			else
-			{
-				++it;
-			}
-		}
+	// approximate number of jobs waiting in the calling thread's own queue.
+	size_t GetLocalQueueSize() const;
 
-		auto currentTime = std::chrono::high_resolution_clock::now();
-		size_t behaviorsToRun = toRunThisFrame.size();
-		size_t ranBehaviors = 0u;
-		for (BehaviorRecord br : toRunThisFrame)
-		{
-			auto lastTime = currentTime;
-			currentTime = std::chrono::high_resolution_clock::now();
-			auto timeUsed = currentTime - lastTime;
+	// approximate number of jobs pushed and not yet picked up, all queues.
+	int GetQueuedJobCount() const { return m_queuedJobs.load(std::memory_order_relaxed); }
 
-			timeToRun -= static_cast<int>(std::chrono::duration_cast<std::chrono::duration<float>>(timeUsed).count());
-			int availableTime = static_cast<int>(timeToRun / (behaviorsToRun - ranBehaviors));
+	// jobs run right away on the thread that added them since Init: the
+	// queues or job slots were full while it was already making room for
+	// another job, see PushJob.
+	size_t GetInlineJobCount() const { return m_inlineJobs.load(std::memory_order_relaxed); }
 
-			br.fn(availableTime);
-			++ranBehaviors;
-		}
+	// amortized behaviors, see BehaviorScheduler.
+	BehaviorScheduler::Handle AddBehavior(JobBehavior function, unsigned int frequency, unsigned int phase,
+		BehaviorPriority priority = BehaviorPriority::Normal)
+	{
+		return m_behaviors.Add(std::move(function), frequency, phase, priority);
 	}
 
-private:
-	static JobScheduler m_instance;
+	void RemoveBehavior(BehaviorScheduler::Handle handle) { m_behaviors.Remove(handle); }
 
-	struct BehaviorRecord
+	// queues fn to go on the pool at the start of the next Run.
+	template<typename Fn>
+	void AddJobNextFrame(Fn&& fn)
 	{
-		JobBehavior fn;
-		size_t frequency;
-		size_t phase;
-	};
+		std::lock_guard<std::mutex> lock(m_nextFrameMutex);
+		m_nextFrameJobs.emplace_back(std::forward<Fn>(fn));
+	}
 
-	// frequency / sets
-	std::vector<BehaviorRecord> behaviorRecords;
+	// releases jobs queued for this frame, then runs the due behaviors within budgetMs.
+	void Run(float budgetMs);
 
-	size_t frame = 0u;
+	BehaviorScheduler& GetBehaviorScheduler() { return m_behaviors; }
 
-#if ENABLE_MT_JS
-	ThreadSafeQueue<IBaseJob*> m_jobs;
-	std::vector<std::thread> m_runningThreads;
-	std::atomic_bool m_running;
-#endif
+private:
+	static void ExecuteJob(IBaseJob* job);
+	void PushJob(IBaseJob* job);
+	bool PushInjected(IBaseJob* job);
+	PooledJob* AllocateJob();
+	void WorkLoop(unsigned int index);
+	IBaseJob* FindJob(unsigned int index, bool isPoolThread);
+	void Park();
+	void WakeOne();
 
+private:
+	static JobScheduler m_instance;
 
+	BehaviorScheduler m_behaviors;
 
-	int m_runningJobs;
+	// one deque per pool thread. index 0 belongs to the thread that called Init.
+	std::vector<std::unique_ptr<JobQueue>> m_queues;
+	std::vector<std::thread> m_runningThreads;
+	std::atomic_bool m_running{ false };
+	// workers past their per thread setup (profiler ring), Init waits for all.
+	std::atomic<unsigned int> m_startedWorkers{ 0 };
+
+	// jobs from threads outside the pool, or from a pool thread whose deque is full.
+	// fixed ring, sized once in Init.
+	std::mutex m_injectMutex;
+	std::vector<IBaseJob*> m_injected;
+	size_t m_injectedHead = 0;
+	std::atomic<int> m_injectedCount{ 0 };
+
+	// one per pool thread, plus a shared one (last) for threads outside the pool.
+	std::vector<std::unique_ptr<JobPool>> m_pools;
+
+	// jobs pushed but not yet picked up. workers only park when this reaches 0.
+	std::atomic<int> m_queuedJobs{ 0 };
+	// see GetInlineJobCount.
+	std::atomic<size_t> m_inlineJobs{ 0 };
+
+	// AddJobNextFrame, swapped out in Run so both keep their capacity.
+	std::mutex m_nextFrameMutex;
+	std::vector<JobFunction> m_nextFrameJobs;
+	std::vector<JobFunction> m_frameJobs;
+
+	std::mutex m_parkMutex;
+	std::condition_variable m_parkCvar;
+	std::atomic<int> m_parkedWorkers{ 0 };
 };
-
-
@@ -0,0 +1,192 @@
+#pragma once
+
+#include "JobScheduler.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// Data parallel loops on top of JobScheduler.
+//
+// Ranges are split lazily: a job keeps halving its range and pushing the
+// upper half only while its own queue is running dry, otherwise it works
+// through grainSize sized chunks. Busy pools split little, idle thieves
+// cause more splits, so callers only pick a minimum grain.
+
+// One padded slot per pool thread, plus one for a caller outside the pool.
+// Use it to hand each worker its own scratch buffers or partial results.
+template<typename T>
+class WorkerLocal
+{
+public:
+	explicit WorkerLocal(const T& init = T(), JobScheduler& scheduler = JobScheduler::GetInstance())
+		: m_scheduler(scheduler)
+		, m_slots(static_cast<size_t>(scheduler.GetWorkerCount()) + 1u, Slot{ init })
+	{
+	}
+
+	// slot of the calling thread.
+	T& Local()
+	{
+		const int index = m_scheduler.GetWorkerIndex();
+		const size_t slot = index >= 0 && static_cast<size_t>(index) < m_slots.size() - 1
+			? static_cast<size_t>(index)
+			: m_slots.size() - 1;
+		return m_slots[slot].value;
+	}
+
+	size_t size() const { return m_slots.size(); }
+	T& operator[](size_t index) { return m_slots[index].value; }
+	const T& operator[](size_t index) const { return m_slots[index].value; }
+
+	template<typename Fn>
+	void ForEach(Fn&& fn)
+	{
+		for (Slot& slot : m_slots)
+		{
+			fn(slot.value);
+		}
+	}
+
+private:
+	struct alignas(64) Slot
+	{
+		T value;
+	};
+
+	JobScheduler& m_scheduler;
+	std::vector<Slot> m_slots;
+};
+
+namespace ParallelDetail
+{
+	// split while the local queue holds fewer jobs than this.
+	constexpr size_t kSplitThreshold = 2;
+
+	template<typename RangeFn>
+	class RangeLoop
+	{
+	public:
+		RangeLoop(JobScheduler& scheduler, size_t grainSize, RangeFn& fn)
+			: m_scheduler(scheduler)
+			, m_grainSize(grainSize)
+			, m_fn(fn)
+		{
+		}
+
+		void Run(size_t begin, size_t end)
+		{
+			RunRange(begin, end);
+			m_scheduler.WaitForCounter(&m_counter);
+		}
+
+	private:
+		void RunRange(size_t begin, size_t end)
+		{
+			while (begin < end)
+			{
+				const size_t count = end - begin;
+				if (count > m_grainSize && m_scheduler.GetLocalQueueSize() < kSplitThreshold)
+				{
+					// pooled job, the upper half goes to whoever steals it.
+					const size_t mid = begin + count / 2;
+					m_scheduler.AddJob([this, mid, end]() { RunRange(mid, end); }, &m_counter);
+					end = mid;
+					continue;
+				}
+
+				const size_t chunkEnd = std::min(end, begin + m_grainSize);
+				{
+					// a job on the caller too, its scratch doesn't wait for the next frame.
+					JobContext::JobScope scope;
+					m_fn(begin, chunkEnd);
+				}
+				begin = chunkEnd;
+			}
+		}
+
+		JobScheduler& m_scheduler;
+		size_t m_grainSize;
+		RangeFn& m_fn;
+		JobCounter m_counter;
+	};
+
+	inline size_t ResolveGrainSize(JobScheduler& scheduler, size_t count, size_t grainSize)
+	{
+		if (grainSize > 0)
+		{
+			return grainSize;
+		}
+		// aim for a few chunks per worker so stealing can even out the load.
+		const size_t workers = std::max(1u, scheduler.GetWorkerCount());
+		return std::max<size_t>(1, count / (workers * 8));
+	}
+}
+
+// fn(size_t rangeBegin, size_t rangeEnd), called with chunks of at most grainSize.
+// grainSize 0 picks one based on the worker count.
+template<typename Fn>
+void ParallelForRange(size_t begin, size_t end, size_t grainSize, Fn&& fn,
+	JobScheduler& scheduler = JobScheduler::GetInstance())
+{
+	if (begin >= end)
+	{
+		return;
+	}
+
+	const size_t count = end - begin;
+	const size_t grain = ParallelDetail::ResolveGrainSize(scheduler, count, grainSize);
+	if (count <= grain || scheduler.GetWorkerCount() <= 1)
+	{
+		JobContext::JobScope scope;
+		fn(begin, end);
+		return;
+	}
+
+	ParallelDetail::RangeLoop<Fn> loop(scheduler, grain, fn);
+	loop.Run(begin, end);
+}
+
+// fn(size_t index)
+template<typename Fn>
+void ParallelFor(size_t begin, size_t end, size_t grainSize, Fn&& fn,
+	JobScheduler& scheduler = JobScheduler::GetInstance())
+{
+	ParallelForRange(begin, end, grainSize, [&fn](size_t rangeBegin, size_t rangeEnd) {
+		for (size_t i = rangeBegin; i < rangeEnd; ++i)
+		{
+			fn(i);
+		}
+		}, scheduler);
+}
+
+// fn(size_t index, Context& context), context is the calling worker's slot.
+template<typename Context, typename Fn>
+void ParallelFor(size_t begin, size_t end, size_t grainSize, WorkerLocal<Context>& context, Fn&& fn,
+	JobScheduler& scheduler = JobScheduler::GetInstance())
+{
+	ParallelForRange(begin, end, grainSize, [&fn, &context](size_t rangeBegin, size_t rangeEnd) {
+		Context& local = context.Local();
+		for (size_t i = rangeBegin; i < rangeEnd; ++i)
+		{
+			fn(i, local);
+		}
+		}, scheduler);
+}
+
+// fn(size_t index, T& accumulator) folds one element into the worker's partial,
+// reduce(const T&, const T&) combines partials in worker order.
+// Floating point results may differ run to run since the split is dynamic.
+template<typename T, typename Fn, typename Reduce>
+T ParallelReduce(size_t begin, size_t end, size_t grainSize, const T& identity, Fn&& fn, Reduce&& reduce,
+	JobScheduler& scheduler = JobScheduler::GetInstance())
+{
+	WorkerLocal<T> partials(identity, scheduler);
+	ParallelFor(begin, end, grainSize, partials, std::forward<Fn>(fn), scheduler);
+
+	T result = identity;
+	partials.ForEach([&result, &reduce](const T& partial) {
+		result = reduce(result, partial);
+		});
+	return result;
+}
@@ -0,0 +1,452 @@
+#pragma once
+
+// Coroutine tasks on top of JobScheduler. Needs C++20 coroutines, which
+// every project builds with; on an older standard this compiles away.
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L && __has_include(<coroutine>)
+#define ENABLE_JS_COROUTINES 1
+#else
+#define ENABLE_JS_COROUTINES 0
+#endif
+
+#if ENABLE_JS_COROUTINES
+
+#include "JobScheduler.h"
+#include "Utils/FileIO.h"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace TaskDetail
+{
+	// coroutine frames up to the largest class are recycled instead of going
+	// back to the heap. a frame always returns to the cache of the thread that
+	// allocated it, so a thread that only spawns does not drain its cache into
+	// the workers that finish the tasks.
+	constexpr size_t kFrameClasses[] = { 256, 512, 1024, 2048 };
+	constexpr size_t kFrameClassCount = sizeof(kFrameClasses) / sizeof(kFrameClasses[0]);
+	constexpr size_t kUncached = kFrameClassCount;
+
+	struct FrameNode
+	{
+		FrameNode* next;
+	};
+
+	struct FrameCache
+	{
+		// owner only.
+		FrameNode* free[kFrameClassCount] = {};
+		// frames freed by other threads, taken over in one go when free runs out.
+		std::atomic<FrameNode*> remote[kFrameClassCount] = {};
+
+		FrameCache* nextIdle = nullptr;
+	};
+
+	// in front of every frame, keeps the frame max aligned.
+	struct alignas(alignof(std::max_align_t)) FrameHeader
+	{
+		FrameCache* owner;
+		size_t frameClass;
+	};
+
+	// caches outlive their thread, frames may still be on their way back.
+	// a new thread picks up the cache of one that exited.
+	class FrameCacheRegistry
+	{
+	public:
+		static FrameCache* Acquire()
+		{
+			FrameCacheRegistry& registry = Instance();
+			std::lock_guard<std::mutex> lock(registry.m_mutex);
+			if (FrameCache* cache = registry.m_idle)
+			{
+				registry.m_idle = cache->nextIdle;
+				return cache;
+			}
+			return new FrameCache();
+		}
+
+		static void Release(FrameCache* cache)
+		{
+			FrameCacheRegistry& registry = Instance();
+			std::lock_guard<std::mutex> lock(registry.m_mutex);
+			cache->nextIdle = registry.m_idle;
+			registry.m_idle = cache;
+		}
+
+	private:
+		static FrameCacheRegistry& Instance()
+		{
+			static FrameCacheRegistry registry;
+			return registry;
+		}
+
+		std::mutex m_mutex;
+		FrameCache* m_idle = nullptr;
+	};
+
+	struct ThreadFrameCache
+	{
+		ThreadFrameCache() : cache(FrameCacheRegistry::Acquire()) {}
+		~ThreadFrameCache() { FrameCacheRegistry::Release(cache); }
+
+		FrameCache* cache;
+	};
+
+	inline thread_local ThreadFrameCache t_frameCache;
+
+	inline void* AllocateFrame(size_t size)
+	{
+		const size_t total = size + sizeof(FrameHeader);
+
+		size_t frameClass = 0;
+		while (frameClass < kFrameClassCount && kFrameClasses[frameClass] < total)
+		{
+			++frameClass;
+		}
+
+		FrameCache* cache = t_frameCache.cache;
+		void* block = nullptr;
+		if (frameClass < kFrameClassCount)
+		{
+			FrameNode*& free = cache->free[frameClass];
+			if (!free)
+			{
+				free = cache->remote[frameClass].exchange(nullptr, std::memory_order_acquire);
+			}
+
+			if (free)
+			{
+				block = free;
+				free = free->next;
+			}
+			else
+			{
+				block = ::operator new(kFrameClasses[frameClass]);
+			}
+		}
+		else
+		{
+			block = ::operator new(total);
+		}
+
+		FrameHeader* header = static_cast<FrameHeader*>(block);
+		header->owner = cache;
+		header->frameClass = frameClass;
+		return header + 1;
+	}
+
+	inline void FreeFrame(void* frame)
+	{
+		FrameHeader* header = static_cast<FrameHeader*>(frame) - 1;
+		const size_t frameClass = header->frameClass;
+		if (frameClass == kUncached)
+		{
+			::operator delete(header);
+			return;
+		}
+
+		FrameCache* owner = header->owner;
+		FrameNode* node = reinterpret_cast<FrameNode*>(header);
+		if (owner == t_frameCache.cache)
+		{
+			node->next = owner->free[frameClass];
+			owner->free[frameClass] = node;
+			return;
+		}
+
+		std::atomic<FrameNode*>& remote = owner->remote[frameClass];
+		node->next = remote.load(std::memory_order_relaxed);
+		while (!remote.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	struct PromiseBase
+	{
+		static void* operator new(size_t size) { return AllocateFrame(size); }
+		static void operator delete(void* frame) { FreeFrame(frame); }
+
+		std::suspend_always initial_suspend() noexcept { return {}; }
+
+		// hands the thread straight to whoever awaited this task.
+		struct FinalAwaiter
+		{
+			bool await_ready() noexcept { return false; }
+
+			template<typename Promise>
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+			{
+				std::coroutine_handle<> continuation = handle.promise().continuation;
+				return continuation ? continuation : std::noop_coroutine();
+			}
+
+			void await_resume() noexcept {}
+		};
+
+		FinalAwaiter final_suspend() noexcept { return {}; }
+		void unhandled_exception() { exception = std::current_exception(); }
+
+		std::coroutine_handle<> continuation;
+		std::exception_ptr exception;
+	};
+
+	template<typename T>
+	struct Promise
+		: PromiseBase
+	{
+		template<typename U>
+		void return_value(U&& value) { result.emplace(std::forward<U>(value)); }
+
+		T& Result()
+		{
+			if (exception) { std::rethrow_exception(exception); }
+			return *result;
+		}
+
+		std::optional<T> result;
+	};
+
+	template<>
+	struct Promise<void>
+		: PromiseBase
+	{
+		void return_void() {}
+
+		void Result()
+		{
+			if (exception) { std::rethrow_exception(exception); }
+		}
+	};
+}
+
+// Lazily started coroutine. Nothing runs until it is awaited, spawned
+// with SpawnTask or waited on with SyncWait.
+template<typename T = void>
+class Task
+{
+public:
+	struct promise_type
+		: TaskDetail::Promise<T>
+	{
+		Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+	};
+
+	using Handle = std::coroutine_handle<promise_type>;
+
+	Task() = default;
+	explicit Task(Handle handle) : m_handle(handle) {}
+
+	Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, {})) {}
+	Task& operator=(Task&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Destroy();
+			m_handle = std::exchange(other.m_handle, {});
+		}
+		return *this;
+	}
+
+	Task(const Task&) = delete;
+	Task& operator=(const Task&) = delete;
+
+	~Task() { Destroy(); }
+
+	bool IsValid() const { return static_cast<bool>(m_handle); }
+	bool IsDone() const { return !m_handle || m_handle.done(); }
+
+	// only once IsDone.
+	decltype(auto) Result() { return m_handle.promise().Result(); }
+
+	auto operator co_await() & noexcept { return Awaiter{ m_handle }; }
+	auto operator co_await() && noexcept { return Awaiter{ m_handle }; }
+
+private:
+	struct Awaiter
+	{
+		bool await_ready() noexcept { return !handle || handle.done(); }
+
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+		{
+			handle.promise().continuation = awaiting;
+			return handle;
+		}
+
+		decltype(auto) await_resume() { return handle.promise().Result(); }
+
+		Handle handle;
+	};
+
+	void Destroy()
+	{
+		if (m_handle)
+		{
+			m_handle.destroy();
+			m_handle = {};
+		}
+	}
+
+	Handle m_handle;
+};
+
+namespace TaskDetail
+{
+	// coroutine that runs straight away and frees itself at the end.
+	struct Detached
+	{
+		struct promise_type
+			: PromiseBase
+		{
+			Detached get_return_object() { return {}; }
+			std::suspend_never initial_suspend() noexcept { return {}; }
+			std::suspend_never final_suspend() noexcept { return {}; }
+			void unhandled_exception() { std::terminate(); }
+			void return_void() {}
+		};
+	};
+
+	inline void ResumeOn(JobScheduler& scheduler, std::coroutine_handle<> handle)
+	{
+		// pooled job, falls back to resuming inline when the pool is exhausted.
+		scheduler.AddJob([handle]() { handle.resume(); });
+	}
+}
+
+// co_await ScheduleOn() continues on a pool thread.
+struct ScheduleOn
+{
+	explicit ScheduleOn(JobScheduler& scheduler = JobScheduler::GetInstance()) : m_scheduler(scheduler) {}
+
+	bool await_ready() noexcept { return false; }
+	void await_suspend(std::coroutine_handle<> handle) { TaskDetail::ResumeOn(m_scheduler, handle); }
+	void await_resume() noexcept {}
+
+	JobScheduler& m_scheduler;
+};
+
+// co_await NextFrame() continues on a pool thread once the next
+// JobScheduler::Run starts.
+struct NextFrame
+{
+	explicit NextFrame(JobScheduler& scheduler = JobScheduler::GetInstance()) : m_scheduler(scheduler) {}
+
+	bool await_ready() noexcept { return false; }
+	void await_suspend(std::coroutine_handle<> handle)
+	{
+		m_scheduler.AddJobNextFrame([handle]() { handle.resume(); });
+	}
+	void await_resume() noexcept {}
+
+	JobScheduler& m_scheduler;
+};
+
+// co_await WhenAll(tasks) starts every task on the pool and continues
+// on whichever thread finishes the last one. Results stay in the tasks.
+template<typename T>
+class WhenAll
+{
+public:
+	explicit WhenAll(std::vector<Task<T>>& tasks, JobScheduler& scheduler = JobScheduler::GetInstance())
+		: m_tasks(tasks)
+		, m_scheduler(scheduler)
+	{
+	}
+
+	bool await_ready() noexcept { return m_tasks.empty(); }
+
+	bool await_suspend(std::coroutine_handle<> awaiting)
+	{
+		m_awaiting = awaiting;
+		// one extra so the last child can't resume us before every child is out.
+		m_remaining.store(static_cast<int>(m_tasks.size()) + 1, std::memory_order_relaxed);
+		for (Task<T>& task : m_tasks)
+		{
+			RunChild(task);
+		}
+		return !Arrive();
+	}
+
+	void await_resume() noexcept {}
+
+private:
+	bool Arrive() { return m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+
+	TaskDetail::Detached RunChild(Task<T>& task)
+	{
+		co_await ScheduleOn(m_scheduler);
+		try
+		{
+			co_await task;
+		}
+		catch (...)
+		{
+			// kept in the task, Result() rethrows it.
+		}
+
+		if (Arrive())
+		{
+			m_awaiting.resume();
+		}
+	}
+
+	std::vector<Task<T>>& m_tasks;
+	JobScheduler& m_scheduler;
+	std::coroutine_handle<> m_awaiting;
+	std::atomic<int> m_remaining{ 0 };
+};
+
+// runs fn on a pool thread, co_await the returned task for its result.
+template<typename Fn>
+auto RunAsync(Fn fn, JobScheduler& scheduler = JobScheduler::GetInstance()) -> Task<decltype(fn())>
+{
+	co_await ScheduleOn(scheduler);
+	co_return fn();
+}
+
+// reads the whole file on a pool thread.
+inline Task<std::string> ReadTextFileAsync(std::string path, JobScheduler& scheduler = JobScheduler::GetInstance())
+{
+	co_await ScheduleOn(scheduler);
+	co_return FileIO::ReadTextFile(path);
+}
+
+// fire and forget, the task starts on the pool and frees itself once done.
+inline void SpawnTask(Task<void> task, JobScheduler& scheduler = JobScheduler::GetInstance())
+{
+	[](Task<void> owned, JobScheduler& pool) -> TaskDetail::Detached {
+		co_await ScheduleOn(pool);
+		co_await owned;
+	}(std::move(task), scheduler);
+}
+
+// blocks until task is done, running pool jobs on this thread meanwhile.
+template<typename T>
+decltype(auto) SyncWait(Task<T>& task, JobScheduler& scheduler = JobScheduler::GetInstance())
+{
+	JobCounter counter;
+	counter.m_value.store(1, std::memory_order_relaxed);
+
+	[](Task<T>& awaited, JobCounter& done) -> TaskDetail::Detached {
+		try
+		{
+			co_await awaited;
+		}
+		catch (...)
+		{
+		}
+		done.m_value.fetch_sub(1, std::memory_order_release);
+	}(task, counter);
+
+	scheduler.WaitForCounter(&counter);
+	return task.Result();
+}
+
+#endif
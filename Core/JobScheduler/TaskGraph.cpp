@@ -0,0 +1,180 @@
+#include "TaskGraph.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <thread>
+
+TaskGraph::NodeId TaskGraph::AddNode(const char* name, Task task, TaskAffinity affinity,
+	std::initializer_list<NodeId> dependsOn)
+{
+	assert(!m_isRunning && "TaskGraph: nodes can't be added from inside Run");
+	assert(task);
+
+	const NodeId id = m_nodes.size();
+	m_nodes.emplace_back();
+
+	Node& node = m_nodes.back();
+	node.name = name;
+	node.task = std::move(task);
+	node.affinity = affinity;
+	if (affinity == TaskAffinity::MainThread)
+	{
+		node.previousMain = m_lastMain;
+		m_lastMain = id;
+	}
+
+	for (NodeId dependency : dependsOn)
+	{
+		AddDependency(dependency, id);
+	}
+	return id;
+}
+
+void TaskGraph::AddDependency(NodeId before, NodeId after)
+{
+	assert(!m_isRunning && "TaskGraph: dependencies can't change from inside Run");
+	assert(before < after && after < m_nodes.size() && "TaskGraph: a node can only depend on nodes declared before it");
+
+	std::vector<NodeId>& dependencies = m_nodes[after].dependencies;
+	if (std::find(dependencies.begin(), dependencies.end(), before) != dependencies.end())
+	{
+		return;
+	}
+
+	dependencies.push_back(before);
+	m_nodes[before].successors.push_back(after);
+}
+
+void TaskGraph::Clear()
+{
+	assert(!m_isRunning);
+	m_nodes.clear();
+	m_lastMain = InvalidNode;
+	m_frameMs = 0.0;
+}
+
+void TaskGraph::Run(JobScheduler& scheduler)
+{
+	assert(!m_isRunning && "TaskGraph: Run is not reentrant");
+	m_isRunning = true;
+	m_scheduler = &scheduler;
+	m_frameStart = std::chrono::steady_clock::now();
+
+	if (m_serial)
+	{
+		for (NodeId i = 0; i < m_nodes.size(); ++i)
+		{
+			Execute(i);
+		}
+	}
+	else
+	{
+		for (Node& node : m_nodes)
+		{
+			node.remaining.store(static_cast<int>(node.dependencies.size()), std::memory_order_relaxed);
+		}
+
+		// roots first, in declaration order.
+		for (NodeId i = 0; i < m_nodes.size(); ++i)
+		{
+			if (m_nodes[i].affinity == TaskAffinity::Any && m_nodes[i].dependencies.empty())
+			{
+				scheduler.AddJob([this, i]() { Execute(i); }, &m_counter);
+			}
+		}
+
+		// main thread nodes in declaration order, helping out while they wait.
+		for (NodeId i = 0; i < m_nodes.size(); ++i)
+		{
+			Node& node = m_nodes[i];
+			if (node.affinity != TaskAffinity::MainThread)
+			{
+				continue;
+			}
+
+			while (node.remaining.load(std::memory_order_acquire) > 0)
+			{
+				if (!scheduler.TryRunPendingJob())
+				{
+					std::this_thread::yield();
+				}
+			}
+			Execute(i);
+		}
+
+		scheduler.WaitForCounter(&m_counter);
+	}
+
+	m_frameMs = NowMs();
+	m_isRunning = false;
+}
+
+void TaskGraph::Execute(NodeId id)
+{
+	Node& node = m_nodes[id];
+	node.timing.worker = m_scheduler->GetWorkerIndex();
+	node.timing.startMs = NowMs();
+	node.task();
+	node.timing.endMs = NowMs();
+
+	if (!m_serial)
+	{
+		Release(id);
+	}
+}
+
+void TaskGraph::Release(NodeId id)
+{
+	for (NodeId successor : m_nodes[id].successors)
+	{
+		Node& next = m_nodes[successor];
+		if (next.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1 && next.affinity == TaskAffinity::Any)
+		{
+			// the counter can't reach zero before this add: an Any node's job
+			// still holds it, and Run only waits on it after the last main node.
+			m_scheduler->AddJob([this, successor]() { Execute(successor); }, &m_counter);
+		}
+	}
+}
+
+double TaskGraph::NowMs() const
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_frameStart).count();
+}
+
+std::vector<TaskGraph::NodeId> TaskGraph::GetCriticalPath() const
+{
+	std::vector<NodeId> path;
+	if (m_nodes.empty())
+	{
+		return path;
+	}
+
+	NodeId current = 0;
+	for (NodeId i = 1; i < m_nodes.size(); ++i)
+	{
+		if (m_nodes[i].timing.endMs > m_nodes[current].timing.endMs)
+		{
+			current = i;
+		}
+	}
+
+	// walk back through whichever dependency held each node up the longest.
+	while (current != InvalidNode)
+	{
+		path.push_back(current);
+
+		NodeId latest = m_nodes[current].previousMain;
+		for (NodeId dependency : m_nodes[current].dependencies)
+		{
+			if (latest == InvalidNode || m_nodes[dependency].timing.endMs > m_nodes[latest].timing.endMs)
+			{
+				latest = dependency;
+			}
+		}
+		current = latest;
+	}
+
+	std::reverse(path.begin(), path.end());
+	return path;
+}
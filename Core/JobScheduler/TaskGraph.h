@@ -0,0 +1,91 @@
+#pragma once
+
+#include "JobScheduler.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <vector>
+
+enum class TaskAffinity : unsigned int
+{
+	// any pool thread, as soon as its dependencies are done.
+	Any = 0,
+	// the thread calling Run, in declaration order (SDL, GL, ImGui).
+	MainThread,
+};
+
+// when a node ran in the last frame, relative to the start of Run.
+struct TaskTiming
+{
+	double startMs = 0.0;
+	double endMs = 0.0;
+	int worker = -1;
+
+	double DurationMs() const { return endMs - startMs; }
+};
+
+// Per frame graph of tasks run on the JobScheduler.
+// Nodes can only depend on nodes declared before them, so the declaration
+// order is always a valid order: main thread nodes run in it, and running
+// the graph serially gives the same order every frame.
+class TaskGraph
+{
+public:
+	using Task = std::function<void()>;
+	using NodeId = size_t;
+	static constexpr NodeId InvalidNode = static_cast<NodeId>(-1);
+
+	NodeId AddNode(const char* name, Task task, TaskAffinity affinity = TaskAffinity::Any,
+		std::initializer_list<NodeId> dependsOn = {});
+	void AddDependency(NodeId before, NodeId after);
+	void Clear();
+
+	// runs every node once and returns when all of them are done.
+	void Run(JobScheduler& scheduler = JobScheduler::GetInstance());
+
+	// everything on the calling thread in declaration order, for debugging.
+	void SetSerial(bool serial) { m_serial = serial; }
+	bool IsSerial() const { return m_serial; }
+
+	size_t Size() const { return m_nodes.size(); }
+	const char* GetName(NodeId node) const { return m_nodes[node].name; }
+	TaskAffinity GetAffinity(NodeId node) const { return m_nodes[node].affinity; }
+	const TaskTiming& GetTiming(NodeId node) const { return m_nodes[node].timing; }
+	double GetFrameMs() const { return m_frameMs; }
+
+	// chain of nodes that finished last in the last frame, first node first.
+	std::vector<NodeId> GetCriticalPath() const;
+
+private:
+	struct Node
+	{
+		const char* name = "";
+		Task task;
+		TaskAffinity affinity = TaskAffinity::Any;
+		std::vector<NodeId> dependencies;
+		std::vector<NodeId> successors;
+		// main thread nodes also wait on the one declared before them.
+		NodeId previousMain = InvalidNode;
+
+		std::atomic<int> remaining{ 0 };
+		TaskTiming timing;
+	};
+
+	void Execute(NodeId node);
+	void Release(NodeId node);
+	double NowMs() const;
+
+	// deque, nodes hold atomics and can't move.
+	std::deque<Node> m_nodes;
+	NodeId m_lastMain = InvalidNode;
+	JobScheduler* m_scheduler = nullptr;
+	JobCounter m_counter;
+
+	std::chrono::steady_clock::time_point m_frameStart;
+	double m_frameMs = 0.0;
+	bool m_serial = false;
+	bool m_isRunning = false;
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+// Bounded Chase-Lev deque (Le, Pop, Cohen, Zappa Nardelli 2013).
+// The owning thread pushes and pops at the bottom, any other thread
+// steals from the top. T must be trivially copyable (we store job pointers).
+template<typename T, size_t Capacity = 4096>
+class WorkStealingQueue
+{
+	static_assert((Capacity & (Capacity - 1)) == 0, "WorkStealingQueue: capacity must be a power of two");
+
+public:
+	WorkStealingQueue()
+	{
+		for (size_t i = 0; i < Capacity; ++i)
+		{
+			m_buffer[i].store(T{}, std::memory_order_relaxed);
+		}
+	}
+
+	WorkStealingQueue(const WorkStealingQueue&) = delete;
+	WorkStealingQueue& operator=(const WorkStealingQueue&) = delete;
+
+	// owner only. returns false when the deque is full.
+	bool push(T item)
+	{
+		const int64_t b = m_bottom.load(std::memory_order_relaxed);
+		const int64_t t = m_top.load(std::memory_order_acquire);
+		if (b - t >= static_cast<int64_t>(Capacity))
+		{
+			return false;
+		}
+
+		m_buffer[b & Mask].store(item, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		m_bottom.store(b + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	// owner only. LIFO end, keeps the most recently pushed work hot in cache.
+	bool pop(T& item)
+	{
+		const int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+		m_bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t t = m_top.load(std::memory_order_relaxed);
+
+		if (t > b)
+		{
+			// empty.
+			m_bottom.store(b + 1, std::memory_order_relaxed);
+			return false;
+		}
+
+		item = m_buffer[b & Mask].load(std::memory_order_relaxed);
+		if (t == b)
+		{
+			// last element, race against thieves for it.
+			const bool won = m_top.compare_exchange_strong(t, t + 1,
+				std::memory_order_seq_cst, std::memory_order_relaxed);
+			m_bottom.store(b + 1, std::memory_order_relaxed);
+			return won;
+		}
+		return true;
+	}
+
+	// any thread. FIFO end.
+	bool steal(T& item)
+	{
+		int64_t t = m_top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const int64_t b = m_bottom.load(std::memory_order_acquire);
+
+		if (t >= b)
+		{
+			return false;
+		}
+
+		T stolen = m_buffer[t & Mask].load(std::memory_order_relaxed);
+		if (!m_top.compare_exchange_strong(t, t + 1,
+			std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			// lost the race to the owner or another thief.
+			return false;
+		}
+
+		item = stolen;
+		return true;
+	}
+
+	// approximate, only meant for heuristics and stats.
+	size_t size() const
+	{
+		const int64_t b = m_bottom.load(std::memory_order_relaxed);
+		const int64_t t = m_top.load(std::memory_order_relaxed);
+		return b > t ? static_cast<size_t>(b - t) : 0u;
+	}
+
+	bool empty() const { return size() == 0; }
+	static constexpr size_t capacity() { return Capacity; }
+
+private:
+	static constexpr int64_t Mask = static_cast<int64_t>(Capacity) - 1;
+
+	alignas(64) std::atomic<int64_t> m_top{ 0 };
+	alignas(64) std::atomic<int64_t> m_bottom{ 0 };
+	alignas(64) std::atomic<T> m_buffer[Capacity];
+};
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <assert.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+enum class DefaultSize : size_t
+{
+    OneByte = 1,
+    OneKB = 1024,
+    OneMB = OneKB * OneKB,
+    TenMB = OneMB * 10,
+};
+
+// Bump allocator over one block reserved up front. Allocations are
+// aligned, individually never freed; roll back to a Marker or Reset
+// to release everything allocated after it at once. Not thread safe.
+class LinearAllocator
+{
+public:
+    using Marker = size_t;
+
+    explicit LinearAllocator(size_t bytes = static_cast<size_t>(DefaultSize::TenMB))
+        : m_begin(static_cast<uint8_t*>(std::malloc(bytes)))
+        , m_capacity(m_begin ? bytes : 0)
+    {
+    }
+
+    ~LinearAllocator()
+    {
+        std::free(m_begin);
+    }
+
+    LinearAllocator(const LinearAllocator&) = delete;
+    LinearAllocator& operator=(const LinearAllocator&) = delete;
+
+    // nullptr when the block is exhausted, nothing is allocated then.
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t))
+    {
+        assert(alignment > 0 && (alignment & (alignment - 1)) == 0 && "LinearAllocator: alignment must be a power of two");
+
+        const uintptr_t base = reinterpret_cast<uintptr_t>(m_begin);
+        const uintptr_t aligned = (base + m_offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+        const size_t start = static_cast<size_t>(aligned - base);
+        if (start + bytes > m_capacity || start + bytes < start)
+        {
+            ++m_failedAllocations;
+            return nullptr;
+        }
+
+        m_offset = start + bytes;
+        m_peak = m_offset > m_peak ? m_offset : m_peak;
+        return m_begin + start;
+    }
+
+    // uninitialized storage for count T.
+    template<typename T>
+    T* allocate_array(size_t count)
+    {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // destructors never run, keep it to types that don't need one.
+    template<typename T, typename... Args>
+    T* construct(Args&&... args)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "LinearAllocator: T would never be destroyed");
+        void* memory = allocate(sizeof(T), alignof(T));
+        return memory ? new (memory) T(std::forward<Args>(args)...) : nullptr;
+    }
+
+    Marker GetMarker() const { return m_offset; }
+
+    void Rollback(Marker marker)
+    {
+        assert(marker <= m_offset && "LinearAllocator: marker is newer than the top");
+        m_offset = marker;
+    }
+
+    void Reset() { m_offset = 0; }
+
+    bool owns(const void* data) const
+    {
+        const uint8_t* ptr = static_cast<const uint8_t*>(data);
+        return ptr >= m_begin && ptr < m_begin + m_capacity;
+    }
+
+    // bytes.
+    size_t used_size() const { return m_offset; }
+    size_t total_size() const { return m_capacity; }
+    size_t free_size() const { return m_capacity - m_offset; }
+    size_t peak_size() const { return m_peak; }
+    size_t failed_allocations() const { return m_failedAllocations; }
+
+private:
+    uint8_t* m_begin = nullptr;
+    size_t m_capacity = 0;
+    size_t m_offset = 0;
+    size_t m_peak = 0;
+    size_t m_failedAllocations = 0;
+};
+
+// Rolls the allocator back to where it was when the scope started.
+class ScopedLinearMarker
+{
+public:
+    explicit ScopedLinearMarker(LinearAllocator& allocator)
+        : m_allocator(allocator)
+        , m_marker(allocator.GetMarker())
+    {
+    }
+
+    ~ScopedLinearMarker()
+    {
+        m_allocator.Rollback(m_marker);
+    }
+
+    ScopedLinearMarker(const ScopedLinearMarker&) = delete;
+    ScopedLinearMarker& operator=(const ScopedLinearMarker&) = delete;
+
+private:
+    LinearAllocator& m_allocator;
+    LinearAllocator::Marker m_marker;
+};
+
+// Two linear blocks swapped every frame. Memory handed out during a frame
+// stays valid through the next one, so data built while simulating frame N
+// can still be read while frame N + 1 renders. Main thread only.
+class FrameAllocator
+{
+public:
+    explicit FrameAllocator(size_t bytesPerFrame = static_cast<size_t>(DefaultSize::OneMB) * 4)
+        : m_buffers{ LinearAllocator(bytesPerFrame), LinearAllocator(bytesPerFrame) }
+    {
+    }
+
+    static FrameAllocator& GetInstance()
+    {
+        static FrameAllocator instance;
+        return instance;
+    }
+
+    // frees everything from two frames ago.
+    void BeginFrame()
+    {
+        m_current ^= 1u;
+        m_buffers[m_current].Reset();
+        ++m_frame;
+    }
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t))
+    {
+        return m_buffers[m_current].allocate(bytes, alignment);
+    }
+
+    template<typename T>
+    T* allocate_array(size_t count) { return m_buffers[m_current].allocate_array<T>(count); }
+
+    LinearAllocator& Current() { return m_buffers[m_current]; }
+    const LinearAllocator& Previous() const { return m_buffers[m_current ^ 1u]; }
+    uint64_t GetFrame() const { return m_frame; }
+
+private:
+    LinearAllocator m_buffers[2];
+    unsigned int m_current = 0;
+    uint64_t m_frame = 0;
+};
+
+// std allocator over a LinearAllocator, for containers that only live
+// as long as the current marker or frame:
+// std::vector<int, LinearStlAllocator<int>> v{ LinearStlAllocator<int>(FrameAllocator::GetInstance().Current()) };
+template<typename T>
+class LinearStlAllocator
+{
+public:
+    using value_type = T;
+
+    explicit LinearStlAllocator(LinearAllocator& allocator) : m_allocator(&allocator) {}
+
+    template<typename U>
+    LinearStlAllocator(const LinearStlAllocator<U>& other) : m_allocator(other.m_allocator) {}
+
+    T* allocate(size_t count)
+    {
+        T* data = m_allocator->allocate_array<T>(count);
+        if (!data)
+        {
+            throw std::bad_alloc();
+        }
+        return data;
+    }
+
+    // released by Rollback / Reset.
+    void deallocate(T*, size_t) {}
+
+    template<typename U>
+    bool operator==(const LinearStlAllocator<U>& other) const { return m_allocator == other.m_allocator; }
+    template<typename U>
+    bool operator!=(const LinearStlAllocator<U>& other) const { return m_allocator != other.m_allocator; }
+
+private:
+    template<typename U>
+    friend class LinearStlAllocator;
+
+    LinearAllocator* m_allocator;
+};
@@ -0,0 +1,371 @@
+#pragma once
+
+#include "LinearAllocator.h"
+#include "VirtualArena.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+
+// std::pmr front ends for the engine allocators, so existing std::vector /
+// std::map code can move onto an arena by swapping in std::pmr containers.
+// Requests a resource can't serve go to its upstream. None of them are
+// thread safe.
+
+struct MemoryResourceStats
+{
+    // bytes handed out and not yet deallocated, whatever backs them.
+    size_t bytesInUse = 0;
+    size_t peakBytes = 0;
+    // requests passed on to the upstream resource.
+    size_t upstreamAllocations = 0;
+
+    void OnAllocate(size_t bytes)
+    {
+        bytesInUse += bytes;
+        peakBytes = bytesInUse > peakBytes ? bytesInUse : peakBytes;
+    }
+
+    void OnDeallocate(size_t bytes)
+    {
+        bytesInUse -= bytes < bytesInUse ? bytes : bytesInUse;
+    }
+};
+
+// Monotonic resource over a LinearAllocator: deallocate is free, memory
+// comes back all at once with Release. Either owns its arena or borrows
+// one, in which case Release rolls it back to where it was at construction.
+class LinearMemoryResource
+    : public std::pmr::memory_resource
+{
+public:
+    explicit LinearMemoryResource(size_t bytes, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : m_owned(std::make_unique<LinearAllocator>(bytes))
+        , m_arena(m_owned.get())
+        , m_start(m_arena->GetMarker())
+        , m_upstream(upstream)
+    {
+    }
+
+    explicit LinearMemoryResource(LinearAllocator& arena, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : m_arena(&arena)
+        , m_start(arena.GetMarker())
+        , m_upstream(upstream)
+    {
+    }
+
+    LinearMemoryResource(const LinearMemoryResource&) = delete;
+    LinearMemoryResource& operator=(const LinearMemoryResource&) = delete;
+
+    // containers using the resource must be gone or cleared by now.
+    void Release()
+    {
+        m_arena->Rollback(m_start);
+        m_stats.bytesInUse = 0;
+    }
+
+    const MemoryResourceStats& GetStats() const { return m_stats; }
+    std::pmr::memory_resource* GetUpstream() const { return m_upstream; }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        void* memory = m_arena->allocate(bytes, alignment);
+        if (!memory)
+        {
+            memory = m_upstream->allocate(bytes, alignment);
+            ++m_stats.upstreamAllocations;
+        }
+        m_stats.OnAllocate(bytes);
+        return memory;
+    }
+
+    void do_deallocate(void* memory, size_t bytes, size_t alignment) override
+    {
+        if (!m_arena->owns(memory))
+        {
+            m_upstream->deallocate(memory, bytes, alignment);
+        }
+        m_stats.OnDeallocate(bytes);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+private:
+    std::unique_ptr<LinearAllocator> m_owned;
+    LinearAllocator* m_arena = nullptr;
+    LinearAllocator::Marker m_start = 0;
+    std::pmr::memory_resource* m_upstream = nullptr;
+    MemoryResourceStats m_stats;
+};
+
+// Monotonic resource over a VirtualArena, for the big simulation arrays.
+// Same ownership and Release rules as LinearMemoryResource; past the
+// reservation requests go to upstream.
+class VirtualMemoryResource
+    : public std::pmr::memory_resource
+{
+public:
+    explicit VirtualMemoryResource(size_t reserveBytes, HugePages hugePages = HugePages::Transparent,
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : m_owned(std::make_unique<VirtualArena>(reserveBytes, hugePages))
+        , m_arena(m_owned.get())
+        , m_start(m_arena->GetMarker())
+        , m_upstream(upstream)
+    {
+    }
+
+    explicit VirtualMemoryResource(VirtualArena& arena, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : m_arena(&arena)
+        , m_start(arena.GetMarker())
+        , m_upstream(upstream)
+    {
+    }
+
+    VirtualMemoryResource(const VirtualMemoryResource&) = delete;
+    VirtualMemoryResource& operator=(const VirtualMemoryResource&) = delete;
+
+    // containers using the resource must be gone or cleared by now.
+    void Release()
+    {
+        m_arena->Rollback(m_start);
+        m_stats.bytesInUse = 0;
+    }
+
+    VirtualArena& GetArena() { return *m_arena; }
+    const MemoryResourceStats& GetStats() const { return m_stats; }
+    std::pmr::memory_resource* GetUpstream() const { return m_upstream; }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        void* memory = m_arena->allocate(bytes, alignment);
+        if (!memory)
+        {
+            memory = m_upstream->allocate(bytes, alignment);
+            ++m_stats.upstreamAllocations;
+        }
+        m_stats.OnAllocate(bytes);
+        return memory;
+    }
+
+    void do_deallocate(void* memory, size_t bytes, size_t alignment) override
+    {
+        if (!m_arena->owns(memory))
+        {
+            m_upstream->deallocate(memory, bytes, alignment);
+        }
+        m_stats.OnDeallocate(bytes);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+private:
+    std::unique_ptr<VirtualArena> m_owned;
+    VirtualArena* m_arena = nullptr;
+    VirtualArena::Marker m_start = 0;
+    std::pmr::memory_resource* m_upstream = nullptr;
+    MemoryResourceStats m_stats;
+};
+
+// Monotonic resource over the FrameAllocator's current frame. Memory stays
+// valid through the next frame, like everything else from FrameAllocator.
+// Main thread only.
+class FrameMemoryResource
+    : public std::pmr::memory_resource
+{
+public:
+    explicit FrameMemoryResource(FrameAllocator& frames, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : m_frames(frames)
+        , m_upstream(upstream)
+    {
+    }
+
+    static FrameMemoryResource& GetInstance()
+    {
+        static FrameMemoryResource instance(FrameAllocator::GetInstance());
+        return instance;
+    }
+
+    FrameMemoryResource(const FrameMemoryResource&) = delete;
+    FrameMemoryResource& operator=(const FrameMemoryResource&) = delete;
+
+    const MemoryResourceStats& GetStats() const { return m_stats; }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        void* memory = m_frames.allocate(bytes, alignment);
+        if (!memory)
+        {
+            memory = m_upstream->allocate(bytes, alignment);
+            ++m_stats.upstreamAllocations;
+        }
+        m_stats.OnAllocate(bytes);
+        return memory;
+    }
+
+    void do_deallocate(void* memory, size_t bytes, size_t alignment) override
+    {
+        if (!m_frames.Current().owns(memory) && !m_frames.Previous().owns(memory))
+        {
+            m_upstream->deallocate(memory, bytes, alignment);
+        }
+        m_stats.OnDeallocate(bytes);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+private:
+    FrameAllocator& m_frames;
+    std::pmr::memory_resource* m_upstream = nullptr;
+    MemoryResourceStats m_stats;
+};
+
+// Free lists per power of two size class, 16 to 4096 bytes, carved from
+// chunks taken from upstream. Freed blocks are reused by the next request
+// of their class; chunks go back to upstream with Release or on destruction.
+// Larger or over aligned requests go straight to upstream.
+class PoolMemoryResource
+    : public std::pmr::memory_resource
+{
+public:
+    static constexpr size_t kMinBlock = 16;
+    static constexpr size_t kMaxBlock = 4096;
+    static constexpr size_t kChunkSize = 64 * 1024;
+
+    explicit PoolMemoryResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : m_upstream(upstream)
+    {
+    }
+
+    ~PoolMemoryResource() override
+    {
+        Release();
+    }
+
+    PoolMemoryResource(const PoolMemoryResource&) = delete;
+    PoolMemoryResource& operator=(const PoolMemoryResource&) = delete;
+
+    // containers using the resource must be gone or cleared by now.
+    void Release()
+    {
+        while (m_chunks)
+        {
+            Chunk* next = m_chunks->next;
+            m_upstream->deallocate(m_chunks, kChunkSize, kHeaderSize);
+            m_chunks = next;
+        }
+
+        for (Class& sizeClass : m_classes)
+        {
+            sizeClass = Class{};
+        }
+        m_stats.bytesInUse = 0;
+    }
+
+    const MemoryResourceStats& GetStats() const { return m_stats; }
+    std::pmr::memory_resource* GetUpstream() const { return m_upstream; }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        m_stats.OnAllocate(bytes);
+
+        const size_t index = ClassIndex(bytes, alignment);
+        if (index == kClassCount)
+        {
+            ++m_stats.upstreamAllocations;
+            return m_upstream->allocate(bytes, alignment);
+        }
+
+        Class& sizeClass = m_classes[index];
+        if (Block* block = sizeClass.free)
+        {
+            sizeClass.free = block->next;
+            return block;
+        }
+
+        const size_t blockSize = kMinBlock << index;
+        if (sizeClass.cursor == nullptr || sizeClass.cursor + blockSize > sizeClass.end)
+        {
+            Chunk* chunk = static_cast<Chunk*>(m_upstream->allocate(kChunkSize, kHeaderSize));
+            ++m_stats.upstreamAllocations;
+            chunk->next = m_chunks;
+            m_chunks = chunk;
+
+            // chunks are 64 aligned and blocks start past the header, so each block is aligned to its size, up to 64.
+            sizeClass.cursor = reinterpret_cast<uint8_t*>(chunk) + kHeaderSize;
+            sizeClass.end = reinterpret_cast<uint8_t*>(chunk) + kChunkSize;
+        }
+
+        void* memory = sizeClass.cursor;
+        sizeClass.cursor += blockSize;
+        return memory;
+    }
+
+    void do_deallocate(void* memory, size_t bytes, size_t alignment) override
+    {
+        m_stats.OnDeallocate(bytes);
+
+        const size_t index = ClassIndex(bytes, alignment);
+        if (index == kClassCount)
+        {
+            m_upstream->deallocate(memory, bytes, alignment);
+            return;
+        }
+
+        Block* block = static_cast<Block*>(memory);
+        block->next = m_classes[index].free;
+        m_classes[index].free = block;
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+private:
+    static constexpr size_t kClassCount = 9; // 16 << 8 == 4096
+    static constexpr size_t kHeaderSize = 64;
+
+    struct Block { Block* next; };
+    struct Chunk { Chunk* next; };
+
+    struct Class
+    {
+        Block* free = nullptr;
+        uint8_t* cursor = nullptr;
+        uint8_t* end = nullptr;
+    };
+
+    static size_t ClassIndex(size_t bytes, size_t alignment)
+    {
+        if (bytes > kMaxBlock || alignment > kHeaderSize)
+        {
+            return kClassCount;
+        }
+
+        // blocks are aligned to min(size, 64), so round small over aligned requests up.
+        size_t size = bytes > alignment ? bytes : alignment;
+        size_t index = 0;
+        while ((kMinBlock << index) < size) { ++index; }
+        return index;
+    }
+
+    std::pmr::memory_resource* m_upstream = nullptr;
+    Chunk* m_chunks = nullptr;
+    Class m_classes[kClassCount];
+    MemoryResourceStats m_stats;
+};
@@ -0,0 +1,166 @@
+#include "MemoryTracker.h"
+
+#include "Engine/Utils/Logger.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+    constexpr size_t kTagCount = static_cast<size_t>(MemoryTag::Count);
+    constexpr float kBytesToMB = 1.0f / (1024.0f * 1024.0f);
+}
+
+const char* GetMemoryTagName(MemoryTag tag)
+{
+    switch (tag)
+    {
+    case MemoryTag::General: return "General";
+    case MemoryTag::Boids: return "Boids";
+    case MemoryTag::Spatial: return "Spatial";
+    case MemoryTag::Terrain: return "Terrain";
+    case MemoryTag::Meshes: return "Meshes";
+    case MemoryTag::Textures: return "Textures";
+    case MemoryTag::Rendering: return "Rendering";
+    default: return "Unknown";
+    }
+}
+
+MemoryTracker& MemoryTracker::GetInstance()
+{
+    static MemoryTracker* instance = new MemoryTracker();
+    return *instance;
+}
+
+bool MemoryTracker::LoadBudgets(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    std::string name;
+    double megabytes = 0.0;
+    while (file >> name >> megabytes)
+    {
+        for (size_t i = 0; i < kTagCount; ++i)
+        {
+            if (name == GetMemoryTagName(static_cast<MemoryTag>(i)))
+            {
+                m_counters[i].budgetBytes = static_cast<size_t>(megabytes * 1024.0 * 1024.0);
+            }
+        }
+    }
+    return true;
+}
+
+void MemoryTracker::EndFrame()
+{
+    for (size_t i = 0; i < kTagCount; ++i)
+    {
+        Counters& counters = m_counters[i];
+        counters.lastFrameAllocations = counters.frameAllocations.exchange(0, std::memory_order_relaxed);
+        counters.lastFrameBytes = counters.frameBytes.exchange(0, std::memory_order_relaxed);
+        counters.maxFrameAllocations = counters.lastFrameAllocations > counters.maxFrameAllocations
+            ? counters.lastFrameAllocations : counters.maxFrameAllocations;
+
+        const size_t live = counters.liveBytes.load(std::memory_order_relaxed);
+        counters.history[m_historyIndex] = static_cast<float>(live) * kBytesToMB;
+
+        const bool overBudget = counters.budgetBytes > 0 && live > counters.budgetBytes;
+        if (overBudget && !counters.overBudget)
+        {
+            LOG_WARNING("Memory: %s over budget, %.2f MB / %.2f MB", GetMemoryTagName(static_cast<MemoryTag>(i)),
+                static_cast<float>(live) * kBytesToMB, static_cast<float>(counters.budgetBytes) * kBytesToMB);
+        }
+        counters.overBudget = overBudget;
+    }
+
+    m_historyIndex = (m_historyIndex + 1) % kHistorySize;
+    ++m_frameCount;
+}
+
+MemoryTagStats MemoryTracker::GetStats(MemoryTag tag) const
+{
+    const Counters& counters = m_counters[static_cast<size_t>(tag)];
+
+    MemoryTagStats stats;
+    stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+    stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+    stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+    stats.frameAllocations = counters.lastFrameAllocations;
+    stats.maxFrameAllocations = counters.maxFrameAllocations;
+    stats.frameBytes = counters.lastFrameBytes;
+    stats.budgetBytes = counters.budgetBytes;
+    stats.overBudget = counters.overBudget;
+    return stats;
+}
+
+size_t MemoryTracker::GetTotalLiveBytes() const
+{
+    size_t total = 0;
+    for (const Counters& counters : m_counters)
+    {
+        total += counters.liveBytes.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+size_t MemoryTracker::GetTotalFrameBytes() const
+{
+    size_t total = 0;
+    for (const Counters& counters : m_counters)
+    {
+        total += counters.lastFrameBytes;
+    }
+    return total;
+}
+
+std::string MemoryTracker::ToJson() const
+{
+    std::stringstream stream;
+    stream << "{\n  \"frames\": " << m_frameCount << ",\n  \"tags\": [\n";
+    for (size_t i = 0; i < kTagCount; ++i)
+    {
+        const MemoryTagStats stats = GetStats(static_cast<MemoryTag>(i));
+        stream << "    { \"name\": \"" << GetMemoryTagName(static_cast<MemoryTag>(i)) << "\""
+            << ", \"liveBytes\": " << stats.liveBytes
+            << ", \"peakBytes\": " << stats.peakBytes
+            << ", \"allocations\": " << stats.allocations
+            << ", \"frameAllocations\": " << stats.frameAllocations
+            << ", \"maxFrameAllocations\": " << stats.maxFrameAllocations
+            << ", \"frameBytes\": " << stats.frameBytes
+            << ", \"budgetBytes\": " << stats.budgetBytes
+            << ", \"overBudget\": " << (stats.overBudget ? "true" : "false")
+            << " }" << (i + 1 < kTagCount ? ",\n" : "\n");
+    }
+    stream << "  ]\n}\n";
+    return stream.str();
+}
+
+bool MemoryTracker::DumpJson(const std::string& path) const
+{
+    std::ofstream file(path, std::ios_base::out | std::ios_base::trunc);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    file << ToJson();
+    return true;
+}
+
+TrackedMemoryResource* TrackedMemoryResource::Get(MemoryTag tag)
+{
+    static TrackedMemoryResource* resources[kTagCount] = {
+        new TrackedMemoryResource(MemoryTag::General),
+        new TrackedMemoryResource(MemoryTag::Boids),
+        new TrackedMemoryResource(MemoryTag::Spatial),
+        new TrackedMemoryResource(MemoryTag::Terrain),
+        new TrackedMemoryResource(MemoryTag::Meshes),
+        new TrackedMemoryResource(MemoryTag::Textures),
+        new TrackedMemoryResource(MemoryTag::Rendering),
+    };
+    return resources[static_cast<size_t>(tag)];
+}
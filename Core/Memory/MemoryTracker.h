@@ -0,0 +1,259 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+
+// counts allocations per tag, set to 0 to compile the hooks out.
+#define MEMORY_TRACKING 1
+
+// What a block of memory is for. Keep GetMemoryTagName in sync.
+enum class MemoryTag : uint8_t
+{
+    General = 0,
+    Boids,
+    Spatial,
+    Terrain,
+    Meshes,
+    Textures,
+    Rendering,
+    Count
+};
+
+const char* GetMemoryTagName(MemoryTag tag);
+
+struct MemoryTagStats
+{
+    size_t liveBytes = 0;
+    size_t peakBytes = 0;
+    size_t allocations = 0;
+    // allocations in the last finished frame, and the worst frame so far.
+    size_t frameAllocations = 0;
+    size_t maxFrameAllocations = 0;
+    // bytes allocated in the last finished frame, frees aren't subtracted.
+    size_t frameBytes = 0;
+    // 0 means no budget.
+    size_t budgetBytes = 0;
+    bool overBudget = false;
+};
+
+// Live bytes, peak and allocation counts per MemoryTag. Only memory that
+// goes through the hooks below is counted: TrackedAllocator, TrackedMemoryResource,
+// TrackedBytes, or OnAllocate/OnFree called directly (GPU buffers, textures).
+// The hooks are thread safe; EndFrame, the history and the budgets are
+// main thread only.
+class MemoryTracker
+{
+public:
+    static constexpr size_t kHistorySize = 350;
+
+    // never destroyed, tracked containers can still free during static destruction.
+    static MemoryTracker& GetInstance();
+
+    void OnAllocate(MemoryTag tag, size_t bytes)
+    {
+#if MEMORY_TRACKING
+        Counters& counters = m_counters[static_cast<size_t>(tag)];
+        const size_t live = counters.liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        counters.allocations.fetch_add(1, std::memory_order_relaxed);
+        counters.frameAllocations.fetch_add(1, std::memory_order_relaxed);
+        counters.frameBytes.fetch_add(bytes, std::memory_order_relaxed);
+
+        size_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+        while (live > peak && !counters.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+#endif
+    }
+
+    void OnFree(MemoryTag tag, size_t bytes)
+    {
+#if MEMORY_TRACKING
+        m_counters[static_cast<size_t>(tag)].liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+#endif
+    }
+
+    // warns once each time the tag's live bytes go over, 0 removes the budget.
+    void SetBudget(MemoryTag tag, size_t bytes) { m_counters[static_cast<size_t>(tag)].budgetBytes = bytes; }
+    size_t GetBudget(MemoryTag tag) const { return m_counters[static_cast<size_t>(tag)].budgetBytes; }
+
+    // "<Tag> <megabytes>" per line, unknown tags are skipped. False if the file can't be read.
+    bool LoadBudgets(const std::string& path);
+
+    // closes the frame: per frame counts, history and budget checks.
+    void EndFrame();
+
+    MemoryTagStats GetStats(MemoryTag tag) const;
+    size_t GetTotalLiveBytes() const;
+    // bytes allocated in the last finished frame, all tags.
+    size_t GetTotalFrameBytes() const;
+    uint64_t GetFrameCount() const { return m_frameCount; }
+
+    // live MB per frame, a ring starting at GetHistoryOffset, for ImGui::PlotLines.
+    const float* GetHistory(MemoryTag tag) const { return m_counters[static_cast<size_t>(tag)].history; }
+    int GetHistoryOffset() const { return static_cast<int>(m_historyIndex); }
+
+    std::string ToJson() const;
+    bool DumpJson(const std::string& path) const;
+
+private:
+    MemoryTracker() = default;
+
+    struct Counters
+    {
+        std::atomic<size_t> liveBytes{ 0 };
+        std::atomic<size_t> peakBytes{ 0 };
+        std::atomic<size_t> allocations{ 0 };
+        std::atomic<size_t> frameAllocations{ 0 };
+        std::atomic<size_t> frameBytes{ 0 };
+
+        size_t lastFrameAllocations = 0;
+        size_t lastFrameBytes = 0;
+        size_t maxFrameAllocations = 0;
+        size_t budgetBytes = 0;
+        bool overBudget = false;
+        float history[kHistorySize] = {};
+    };
+
+    Counters m_counters[static_cast<size_t>(MemoryTag::Count)];
+    size_t m_historyIndex = 0;
+    uint64_t m_frameCount = 0;
+};
+
+// std allocator that counts under Tag, for std containers that belong to a subsystem.
+template<typename T, MemoryTag Tag>
+struct TrackedAllocator
+{
+    using value_type = T;
+
+    template<typename U>
+    struct rebind { using other = TrackedAllocator<U, Tag>; };
+
+    TrackedAllocator() = default;
+
+    template<typename U>
+    TrackedAllocator(const TrackedAllocator<U, Tag>&) noexcept {}
+
+    T* allocate(size_t count)
+    {
+        T* memory = std::allocator<T>().allocate(count);
+        MemoryTracker::GetInstance().OnAllocate(Tag, count * sizeof(T));
+        return memory;
+    }
+
+    void deallocate(T* memory, size_t count)
+    {
+        MemoryTracker::GetInstance().OnFree(Tag, count * sizeof(T));
+        std::allocator<T>().deallocate(memory, count);
+    }
+
+    template<typename U>
+    bool operator==(const TrackedAllocator<U, Tag>&) const noexcept { return true; }
+    template<typename U>
+    bool operator!=(const TrackedAllocator<U, Tag>&) const noexcept { return false; }
+};
+
+// Counts what passes through it under one tag, then forwards to upstream.
+// Put it under a PoolMemoryResource to see how much the pool takes, not how much is in use.
+class TrackedMemoryResource
+    : public std::pmr::memory_resource
+{
+public:
+    explicit TrackedMemoryResource(MemoryTag tag, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : m_tag(tag)
+        , m_upstream(upstream)
+    {
+    }
+
+    // one per tag over new/delete, never destroyed.
+    static TrackedMemoryResource* Get(MemoryTag tag);
+
+    MemoryTag GetTag() const { return m_tag; }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        void* memory = m_upstream->allocate(bytes, alignment);
+        MemoryTracker::GetInstance().OnAllocate(m_tag, bytes);
+        return memory;
+    }
+
+    void do_deallocate(void* memory, size_t bytes, size_t alignment) override
+    {
+        MemoryTracker::GetInstance().OnFree(m_tag, bytes);
+        m_upstream->deallocate(memory, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+private:
+    MemoryTag m_tag;
+    std::pmr::memory_resource* m_upstream = nullptr;
+};
+
+// Size of something allocated elsewhere (a GL buffer, a texture), counted
+// while the owner is alive. Copies start empty since they share the
+// original's resource; moves take it over.
+class TrackedBytes
+{
+public:
+    explicit TrackedBytes(MemoryTag tag)
+        : m_tag(tag)
+    {
+    }
+
+    ~TrackedBytes() { Set(0); }
+
+    TrackedBytes(const TrackedBytes& other)
+        : m_tag(other.m_tag)
+    {
+    }
+
+    TrackedBytes& operator=(const TrackedBytes& other)
+    {
+        if (this != &other)
+        {
+            Set(0);
+            m_tag = other.m_tag;
+        }
+        return *this;
+    }
+
+    TrackedBytes(TrackedBytes&& other) noexcept
+        : m_tag(other.m_tag)
+        , m_bytes(other.m_bytes)
+    {
+        other.m_bytes = 0;
+    }
+
+    TrackedBytes& operator=(TrackedBytes&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Set(0);
+            m_tag = other.m_tag;
+            m_bytes = other.m_bytes;
+            other.m_bytes = 0;
+        }
+        return *this;
+    }
+
+    // the resource was (re)allocated with this size, 0 when it's released.
+    void Set(size_t bytes)
+    {
+        MemoryTracker& tracker = MemoryTracker::GetInstance();
+        if (bytes > 0) { tracker.OnAllocate(m_tag, bytes); }
+        if (m_bytes > 0) { tracker.OnFree(m_tag, m_bytes); }
+        m_bytes = bytes;
+    }
+
+    size_t Get() const { return m_bytes; }
+
+private:
+    MemoryTag m_tag;
+    size_t m_bytes = 0;
+};
@@ -0,0 +1,425 @@
+#pragma once
+
+#include <assert.h>
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// per thread free lists in front of the shared NodePool, so pooled
+// new/delete only takes the lock once per batch.
+#define POOL_THREAD_CACHE 1
+
+// How a PoolAllocator gets its nodes. HeapPerNode is the one heap
+// allocation per node the pool replaced, so benchmarks can run the real
+// trees both ways; Reset frees every node there.
+enum class PoolMode
+{
+    Slabs,
+    HeapPerNode,
+};
+
+// Fixed size slots for one node type, carved out of chunked slabs.
+// Slots are handed out in address order and freed ones are reused first,
+// so a tree built in one go ends up packed together. Reset drops every
+// node at once and keeps the slabs for the next build. Not thread safe.
+template<typename T>
+class PoolAllocator
+{
+public:
+    explicit PoolAllocator(size_t nodesPerSlab = 1024, PoolMode mode = PoolMode::Slabs)
+        : m_nodesPerSlab(nodesPerSlab > 0 ? nodesPerSlab : 1)
+        , m_mode(mode)
+    {
+    }
+
+    ~PoolAllocator()
+    {
+        FreeHeapNodes();
+    }
+
+    PoolAllocator(const PoolAllocator&) = delete;
+    PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+    PoolAllocator(PoolAllocator&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    PoolAllocator& operator=(PoolAllocator&& other) noexcept
+    {
+        if (this != &other)
+        {
+            FreeHeapNodes();
+            m_slabs = std::move(other.m_slabs);
+            m_heapNodes = std::move(other.m_heapNodes);
+            m_nodesPerSlab = other.m_nodesPerSlab;
+            m_mode = other.m_mode;
+            m_freeList = other.m_freeList;
+            m_currentSlab = other.m_currentSlab;
+            m_slabOffset = other.m_slabOffset;
+            m_size = other.m_size;
+            m_peak = other.m_peak;
+
+            other.m_slabs.clear();
+            other.m_heapNodes.clear();
+            other.m_freeList = nullptr;
+            other.m_currentSlab = 0;
+            other.m_slabOffset = 0;
+            other.m_size = 0;
+        }
+        return *this;
+    }
+
+    // uninitialized storage for one T, never nullptr.
+    T* allocate()
+    {
+        Slot* slot = m_freeList;
+        if (m_mode == PoolMode::HeapPerNode)
+        {
+            slot = new Slot;
+            m_heapNodes.push_back(slot);
+        }
+        else if (slot)
+        {
+            m_freeList = slot->next;
+        }
+        else
+        {
+            slot = Carve();
+        }
+
+        ++m_size;
+        m_peak = m_size > m_peak ? m_size : m_peak;
+        return reinterpret_cast<T*>(slot->storage);
+    }
+
+    void deallocate(T* node)
+    {
+        assert(node && owns(node) && "PoolAllocator: node is not from this pool");
+        Slot* slot = reinterpret_cast<Slot*>(node);
+        if (m_mode == PoolMode::HeapPerNode)
+        {
+            // linear, heap nodes are meant to go all at once in Reset.
+            m_heapNodes.erase(std::find(m_heapNodes.begin(), m_heapNodes.end(), slot));
+            delete slot;
+            --m_size;
+            return;
+        }
+        slot->next = m_freeList;
+        m_freeList = slot;
+        --m_size;
+    }
+
+    template<typename... Args>
+    T* construct(Args&&... args)
+    {
+        return new (allocate()) T(std::forward<Args>(args)...);
+    }
+
+    void destroy(T* node)
+    {
+        node->~T();
+        deallocate(node);
+    }
+
+    // makes room for count more nodes in as few slabs as possible.
+    void reserve(size_t count)
+    {
+        if (count <= m_size || m_mode == PoolMode::HeapPerNode)
+        {
+            return;
+        }
+
+        size_t available = 0;
+        for (size_t i = m_currentSlab; i < m_slabs.size(); ++i)
+        {
+            available += m_slabs[i].count - (i == m_currentSlab ? m_slabOffset : 0);
+        }
+
+        const size_t needed = count - m_size;
+        if (available < needed)
+        {
+            AddSlab(needed - available);
+        }
+    }
+
+    // forgets every node without running destructors, slabs are kept.
+    void Reset()
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "PoolAllocator: Reset would skip destructors, destroy nodes one by one");
+        FreeHeapNodes();
+        m_freeList = nullptr;
+        m_currentSlab = 0;
+        m_slabOffset = 0;
+        m_size = 0;
+    }
+
+    // Reset and hand the slabs back to the heap.
+    void Release()
+    {
+        Reset();
+        m_slabs.clear();
+    }
+
+    bool owns(const T* node) const
+    {
+        const Slot* slot = reinterpret_cast<const Slot*>(node);
+        if (m_mode == PoolMode::HeapPerNode)
+        {
+            return std::find(m_heapNodes.begin(), m_heapNodes.end(), slot) != m_heapNodes.end();
+        }
+        for (const Slab& slab : m_slabs)
+        {
+            if (slot >= slab.slots.get() && slot < slab.slots.get() + slab.count)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t size() const { return m_size; }
+    size_t peak_size() const { return m_peak; }
+    PoolMode mode() const { return m_mode; }
+    size_t slab_count() const { return m_slabs.size(); }
+
+    size_t capacity() const
+    {
+        size_t count = 0;
+        for (const Slab& slab : m_slabs) { count += slab.count; }
+        return count;
+    }
+
+private:
+    union Slot
+    {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    struct Slab
+    {
+        std::unique_ptr<Slot[]> slots;
+        size_t count = 0;
+    };
+
+    Slot* Carve()
+    {
+        while (m_currentSlab < m_slabs.size() && m_slabOffset == m_slabs[m_currentSlab].count)
+        {
+            ++m_currentSlab;
+            m_slabOffset = 0;
+        }
+
+        if (m_currentSlab == m_slabs.size())
+        {
+            AddSlab(m_nodesPerSlab);
+        }
+
+        return &m_slabs[m_currentSlab].slots[m_slabOffset++];
+    }
+
+    void AddSlab(size_t count)
+    {
+        Slab slab;
+        slab.slots = std::unique_ptr<Slot[]>(new Slot[count]);
+        slab.count = count;
+        m_slabs.push_back(std::move(slab));
+    }
+
+    void FreeHeapNodes()
+    {
+        for (Slot* slot : m_heapNodes) { delete slot; }
+        m_heapNodes.clear();
+    }
+
+    std::vector<Slab> m_slabs;
+    // HeapPerNode only, every live node.
+    std::vector<Slot*> m_heapNodes;
+    size_t m_nodesPerSlab = 1024;
+    PoolMode m_mode = PoolMode::Slabs;
+
+    Slot* m_freeList = nullptr;
+    size_t m_currentSlab = 0;
+    size_t m_slabOffset = 0;
+
+    size_t m_size = 0;
+    size_t m_peak = 0;
+};
+
+// Process wide pool for one node type, for nodes that are created and
+// deleted one at a time (see PoolAllocated). Any thread can allocate or
+// free; with POOL_THREAD_CACHE each thread keeps a small free list and
+// trades whole batches with the shared one. Slabs live until exit.
+template<typename T>
+class NodePool
+{
+public:
+    static constexpr size_t kBatchSize = 64;
+
+    static void* Allocate()
+    {
+#if POOL_THREAD_CACHE
+        Cache& cache = GetCache();
+        if (!cache.head)
+        {
+            cache.head = GetShared().TakeBatch(cache.count);
+        }
+
+        FreeNode* node = cache.head;
+        cache.head = node->next;
+        --cache.count;
+        return node;
+#else
+        Shared& shared = GetShared();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        FreeNode* node = shared.Pop();
+        return node ? node : shared.pool.allocate();
+#endif
+    }
+
+    static void Free(void* memory)
+    {
+        if (!memory)
+        {
+            return;
+        }
+
+        FreeNode* node = static_cast<FreeNode*>(memory);
+#if POOL_THREAD_CACHE
+        Cache& cache = GetCache();
+        node->next = cache.head;
+        cache.head = node;
+
+        // keep one batch around, give the rest back for other threads.
+        if (++cache.count >= 2 * kBatchSize)
+        {
+            FreeNode* last = cache.head;
+            for (size_t i = 1; i < kBatchSize; ++i) { last = last->next; }
+
+            FreeNode* batch = cache.head;
+            cache.head = last->next;
+            cache.count -= kBatchSize;
+            GetShared().GiveBatch(batch, last, kBatchSize);
+        }
+#else
+        Shared& shared = GetShared();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        node->next = shared.freeList;
+        shared.freeList = node;
+        ++shared.freeCount;
+#endif
+    }
+
+private:
+    union FreeNode
+    {
+        FreeNode* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    struct Shared
+    {
+        // hands out up to a batch of linked nodes, count receives how many.
+        FreeNode* TakeBatch(size_t& count)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            FreeNode* head = nullptr;
+            count = 0;
+            while (count < kBatchSize)
+            {
+                FreeNode* node = Pop();
+                if (!node)
+                {
+                    node = pool.allocate();
+                }
+                node->next = head;
+                head = node;
+                ++count;
+            }
+            return head;
+        }
+
+        void GiveBatch(FreeNode* first, FreeNode* last, size_t count)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            last->next = freeList;
+            freeList = first;
+            freeCount += count;
+        }
+
+        FreeNode* Pop()
+        {
+            FreeNode* node = freeList;
+            if (node)
+            {
+                freeList = node->next;
+                --freeCount;
+            }
+            return node;
+        }
+
+        std::mutex mutex;
+        PoolAllocator<FreeNode> pool{ 16 * kBatchSize };
+        FreeNode* freeList = nullptr;
+        size_t freeCount = 0;
+    };
+
+    struct Cache
+    {
+        ~Cache()
+        {
+            if (head)
+            {
+                FreeNode* last = head;
+                while (last->next) { last = last->next; }
+                GetShared().GiveBatch(head, last, count);
+            }
+        }
+
+        FreeNode* head = nullptr;
+        size_t count = 0;
+    };
+
+    // never destroyed, so nodes can still be freed during static destruction.
+    static Shared& GetShared()
+    {
+        static Shared* shared = new Shared();
+        return *shared;
+    }
+
+    static Cache& GetCache()
+    {
+        thread_local Cache cache;
+        return cache;
+    }
+};
+
+// Derive from this to route new/delete of T through NodePool<T>.
+// Types derived from T that are larger fall back to the global heap.
+template<typename T>
+struct PoolAllocated
+{
+    static void* operator new(size_t size)
+    {
+        return size == sizeof(T) ? NodePool<T>::Allocate() : ::operator new(size);
+    }
+
+    static void operator delete(void* memory, size_t size)
+    {
+        if (size == sizeof(T))
+        {
+            NodePool<T>::Free(memory);
+        }
+        else
+        {
+            ::operator delete(memory);
+        }
+    }
+};
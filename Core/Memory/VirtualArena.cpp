@@ -0,0 +1,190 @@
+#include "VirtualArena.h"
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // commit granularity with regular pages, keeps the number of calls down.
+    constexpr size_t kCommitChunk = 64 * 1024;
+
+    size_t RoundUp(size_t value, size_t multiple)
+    {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+
+    size_t GetPageSize()
+    {
+#if defined(_WIN32)
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return static_cast<size_t>(info.dwPageSize);
+#else
+        return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    }
+}
+
+VirtualArena::VirtualArena(size_t reserveBytes, HugePages hugePages)
+{
+#if defined(_WIN32)
+    if (hugePages == HugePages::Explicit)
+    {
+        // large pages can't be committed piecemeal, the whole range goes now.
+        const size_t largePage = GetLargePageMinimum();
+        if (largePage > 0)
+        {
+            const size_t bytes = RoundUp(reserveBytes, largePage);
+            m_begin = static_cast<uint8_t*>(VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE));
+            if (m_begin)
+            {
+                m_reserved = m_committed = m_mapped = bytes;
+                m_commitChunk = largePage;
+                m_hugePages = HugePages::Explicit;
+                return;
+            }
+        }
+    }
+
+    // no transparent huge pages on Windows.
+    m_reserved = m_mapped = RoundUp(reserveBytes, kCommitChunk);
+    m_begin = static_cast<uint8_t*>(VirtualAlloc(nullptr, m_reserved, MEM_RESERVE, PAGE_NOACCESS));
+    m_commitChunk = kCommitChunk;
+    m_hugePages = HugePages::None;
+#else
+#if defined(MAP_HUGETLB)
+    if (hugePages == HugePages::Explicit)
+    {
+        // hugetlb pages come from the pool as they're touched, no commit step.
+        // no MAP_NORESERVE: the whole range is reserved from the pool up front,
+        // so a short pool fails here instead of with SIGBUS on first touch.
+        const size_t bytes = RoundUp(reserveBytes, kHugePageSize);
+        void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (memory != MAP_FAILED)
+        {
+            m_begin = static_cast<uint8_t*>(memory);
+            m_reserved = m_committed = m_mapped = bytes;
+            m_commitChunk = kHugePageSize;
+            m_hugePages = HugePages::Explicit;
+            return;
+        }
+        hugePages = HugePages::Transparent;
+    }
+#endif
+
+    const bool huge = hugePages != HugePages::None;
+    const size_t chunk = huge ? kHugePageSize : kCommitChunk;
+    const size_t bytes = RoundUp(reserveBytes, chunk);
+
+    // over reserve by one huge page so the start can be aligned to one.
+    const size_t padded = bytes + (huge ? kHugePageSize : 0);
+    void* memory = mmap(nullptr, padded, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (memory == MAP_FAILED)
+    {
+        return;
+    }
+
+    uint8_t* begin = static_cast<uint8_t*>(memory);
+    if (huge)
+    {
+        uint8_t* aligned = reinterpret_cast<uint8_t*>(RoundUp(reinterpret_cast<uintptr_t>(begin), kHugePageSize));
+        const size_t head = static_cast<size_t>(aligned - begin);
+        if (head > 0) { munmap(begin, head); }
+        if (padded - head > bytes) { munmap(aligned + bytes, padded - head - bytes); }
+        begin = aligned;
+    }
+
+    m_begin = begin;
+    m_reserved = m_mapped = bytes;
+    m_commitChunk = chunk;
+    m_hugePages = HugePages::None;
+
+#if defined(MADV_HUGEPAGE)
+    if (huge && madvise(m_begin, m_reserved, MADV_HUGEPAGE) == 0)
+    {
+        m_hugePages = HugePages::Transparent;
+    }
+#endif
+#endif
+}
+
+VirtualArena::~VirtualArena()
+{
+    if (!m_begin)
+    {
+        return;
+    }
+
+#if defined(_WIN32)
+    VirtualFree(m_begin, 0, MEM_RELEASE);
+#else
+    munmap(m_begin, m_mapped);
+#endif
+}
+
+bool VirtualArena::Commit(size_t bytes)
+{
+    if (!m_begin)
+    {
+        return false;
+    }
+
+    const size_t target = RoundUp(bytes, m_commitChunk) < m_reserved ? RoundUp(bytes, m_commitChunk) : m_reserved;
+    const size_t grow = target - m_committed;
+#if defined(_WIN32)
+    if (!VirtualAlloc(m_begin + m_committed, grow, MEM_COMMIT, PAGE_READWRITE))
+    {
+        return false;
+    }
+#else
+    if (mprotect(m_begin + m_committed, grow, PROT_READ | PROT_WRITE) != 0)
+    {
+        return false;
+    }
+#endif
+    m_committed = target;
+    return true;
+}
+
+void VirtualArena::Decommit()
+{
+    m_offset = 0;
+    if (!m_begin || m_committed == 0)
+    {
+        return;
+    }
+
+    if (m_hugePages == HugePages::Explicit)
+    {
+        // committed at reservation, can only drop the pages' contents.
+#if !defined(_WIN32)
+        madvise(m_begin, m_committed, MADV_DONTNEED);
+#endif
+        return;
+    }
+
+#if defined(_WIN32)
+    VirtualFree(m_begin, m_committed, MEM_DECOMMIT);
+#else
+    madvise(m_begin, m_committed, MADV_DONTNEED);
+    mprotect(m_begin, m_committed, PROT_NONE);
+#endif
+    m_committed = 0;
+}
+
+void VirtualArena::TouchPages(void* data, size_t bytes)
+{
+    static const size_t pageSize = GetPageSize();
+
+    volatile uint8_t* begin = static_cast<uint8_t*>(data);
+    for (size_t offset = 0; offset < bytes; offset += pageSize)
+    {
+        begin[offset] = 0;
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <assert.h>
+#include <cstddef>
+#include <cstdint>
+
+enum class HugePages
+{
+    // regular 4 KB pages.
+    None,
+    // asks the kernel to back the range with 2 MB pages when it can (Linux THP).
+    Transparent,
+    // MAP_HUGETLB / MEM_LARGE_PAGES from the reserved huge page pool, falls
+    // back to Transparent when the pool is empty or the right is missing.
+    Explicit,
+};
+
+// Bump allocator over a range of address space reserved up front and
+// committed in chunks as allocations reach them, so it can be sized for
+// the biggest run without costing memory in the small ones. Meant for the
+// large simulation arrays (positions, velocities, neighbor lists, tree
+// points) that are walked at random and spend their time on TLB misses;
+// huge pages cover 512 times more memory per TLB entry.
+// Physical pages are placed on the NUMA node of the thread that first
+// writes them: fill, or TouchPages, each range from the worker that will
+// use it. Explicit huge pages on Windows need the "Lock pages in memory"
+// right and are committed all at once. Not thread safe.
+class VirtualArena
+{
+public:
+    using Marker = size_t;
+
+    static constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+    explicit VirtualArena(size_t reserveBytes, HugePages hugePages = HugePages::Transparent);
+    ~VirtualArena();
+
+    VirtualArena(const VirtualArena&) = delete;
+    VirtualArena& operator=(const VirtualArena&) = delete;
+
+    // nullptr once the reservation is used up or the system is out of memory.
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t))
+    {
+        assert(alignment > 0 && (alignment & (alignment - 1)) == 0 && "VirtualArena: alignment must be a power of two");
+
+        const size_t start = (m_offset + alignment - 1) & ~(alignment - 1);
+        if (start + bytes > m_reserved || start + bytes < start)
+        {
+            ++m_failedAllocations;
+            return nullptr;
+        }
+
+        if (start + bytes > m_committed && !Commit(start + bytes))
+        {
+            ++m_failedAllocations;
+            return nullptr;
+        }
+
+        m_offset = start + bytes;
+        m_peak = m_offset > m_peak ? m_offset : m_peak;
+        return m_begin + start;
+    }
+
+    // uninitialized storage for count T.
+    template<typename T>
+    T* allocate_array(size_t count)
+    {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    Marker GetMarker() const { return m_offset; }
+
+    void Rollback(Marker marker)
+    {
+        assert(marker <= m_offset && "VirtualArena: marker is newer than the top");
+        m_offset = marker;
+    }
+
+    // committed pages stay, the next run reuses them.
+    void Reset() { m_offset = 0; }
+
+    // Reset, and hands the physical memory back to the system.
+    void Decommit();
+
+    bool owns(const void* data) const
+    {
+        const uint8_t* ptr = static_cast<const uint8_t*>(data);
+        return ptr >= m_begin && ptr < m_begin + m_reserved;
+    }
+
+    // writes one byte per page of [data, data + bytes), from the calling thread.
+    static void TouchPages(void* data, size_t bytes);
+
+    // what the range actually got, after fallbacks.
+    HugePages GetHugePages() const { return m_hugePages; }
+
+    // bytes.
+    size_t used_size() const { return m_offset; }
+    size_t committed_size() const { return m_committed; }
+    size_t reserved_size() const { return m_reserved; }
+    size_t peak_size() const { return m_peak; }
+    size_t failed_allocations() const { return m_failedAllocations; }
+
+private:
+    // grows the committed part to cover at least bytes.
+    bool Commit(size_t bytes);
+
+    uint8_t* m_begin = nullptr;
+    size_t m_reserved = 0;
+    size_t m_committed = 0;
+    // what the reservation was made with, to release it.
+    size_t m_mapped = 0;
+    size_t m_commitChunk = 0;
+    size_t m_offset = 0;
+    size_t m_peak = 0;
+    size_t m_failedAllocations = 0;
+    HugePages m_hugePages = HugePages::None;
+};
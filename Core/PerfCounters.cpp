@@ -0,0 +1,202 @@
+#include "PerfCounters.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+const char* GetPerfCounterName(PerfCounter counter)
+{
+	switch (counter)
+	{
+	case PerfCounter::Cycles: return "cycles";
+	case PerfCounter::Instructions: return "instructions";
+	case PerfCounter::L1DMisses: return "L1D misses";
+	case PerfCounter::LLCMisses: return "LLC misses";
+	case PerfCounter::BranchMisses: return "branch misses";
+	default: return "unknown";
+	}
+}
+
+bool PerfCounters::Delta(const PerfCounterSample& begin, const PerfCounterSample& end, PerfCounterSample& delta)
+{
+	delta = PerfCounterSample{};
+	const uint64_t enabled = end.timeEnabled - begin.timeEnabled;
+	const uint64_t running = end.timeRunning - begin.timeRunning;
+	if (running == 0)
+	{
+		return false;
+	}
+
+	// only counted part of the time, estimate the rest at the same rate.
+	const double scale = running < enabled ? static_cast<double>(enabled) / static_cast<double>(running) : 1.0;
+	delta.mask = begin.mask & end.mask;
+	delta.timeEnabled = enabled;
+	delta.timeRunning = running;
+	for (size_t i = 0; i < kPerfCounterCount; ++i)
+	{
+		if (delta.mask & (1u << i))
+		{
+			const uint64_t counted = end.values[i] - begin.values[i];
+			delta.values[i] = scale > 1.0 ? static_cast<uint64_t>(static_cast<double>(counted) * scale) : counted;
+		}
+	}
+	return delta.mask != 0;
+}
+
+#if defined(__linux__)
+namespace
+{
+	struct ThreadCounters
+	{
+		~ThreadCounters()
+		{
+			Close();
+		}
+
+		void Close()
+		{
+			for (size_t i = 0; i < opened; ++i)
+			{
+				close(fds[i]);
+			}
+			opened = 0;
+		}
+
+		void Open()
+		{
+			tried = true;
+			// the group only goes on the PMU as a whole: one that got no time
+			// as soon as it's enabled doesn't fit, drop its last counter.
+			for (size_t limit = kPerfCounterCount; limit > 0; --limit)
+			{
+				OpenGroup(limit);
+				if (opened == 0)
+				{
+					return;
+				}
+
+				uint64_t buffer[3 + kPerfCounterCount];
+				const ssize_t bytes = read(fds[0], buffer, sizeof(buffer));
+				if (bytes >= static_cast<ssize_t>(3 * sizeof(uint64_t)) && (buffer[1] == 0 || buffer[2] > 0))
+				{
+					return;
+				}
+
+				const size_t count = opened;
+				Close();
+				limit = count;
+			}
+		}
+
+		// opens up to limit counters, in PerfCounter order.
+		void OpenGroup(size_t limit)
+		{
+			for (size_t i = 0; i < kPerfCounterCount && opened < limit; ++i)
+			{
+				perf_event_attr attr;
+				memset(&attr, 0, sizeof(attr));
+				attr.size = sizeof(attr);
+				attr.exclude_kernel = 1;
+				attr.exclude_hv = 1;
+				attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+				switch (static_cast<PerfCounter>(i))
+				{
+				case PerfCounter::Cycles:
+					attr.type = PERF_TYPE_HARDWARE;
+					attr.config = PERF_COUNT_HW_CPU_CYCLES;
+					break;
+				case PerfCounter::Instructions:
+					attr.type = PERF_TYPE_HARDWARE;
+					attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+					break;
+				case PerfCounter::L1DMisses:
+					attr.type = PERF_TYPE_HW_CACHE;
+					attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+					break;
+				case PerfCounter::LLCMisses:
+					attr.type = PERF_TYPE_HARDWARE;
+					attr.config = PERF_COUNT_HW_CACHE_MISSES;
+					break;
+				default:
+					attr.type = PERF_TYPE_HARDWARE;
+					attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+					break;
+				}
+
+				// whichever counter opens first leads the group, the rest
+				// are skipped one by one if the PMU doesn't have them.
+				const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, opened > 0 ? fds[0] : -1, 0));
+				if (fd >= 0)
+				{
+					fds[opened] = fd;
+					counters[opened] = static_cast<uint8_t>(i);
+					++opened;
+				}
+			}
+		}
+
+		bool tried = false;
+		size_t opened = 0;
+		int fds[kPerfCounterCount] = {};
+		// which PerfCounter each group slot reads.
+		uint8_t counters[kPerfCounterCount] = {};
+	};
+
+	thread_local ThreadCounters t_counters;
+}
+
+bool PerfCounters::Read(PerfCounterSample& sample)
+{
+	sample.mask = 0;
+	if (!t_counters.tried)
+	{
+		t_counters.Open();
+	}
+	if (t_counters.opened == 0)
+	{
+		return false;
+	}
+
+	// nr, time enabled, time running, then one value per opened counter.
+	uint64_t buffer[3 + kPerfCounterCount];
+	const ssize_t bytes = read(t_counters.fds[0], buffer, sizeof(buffer));
+	// a group that never got onto the PMU reads all zeros, that's no data.
+	if (bytes < static_cast<ssize_t>(3 * sizeof(uint64_t)) || buffer[2] == 0)
+	{
+		return false;
+	}
+
+	sample.timeEnabled = buffer[1];
+	sample.timeRunning = buffer[2];
+	const size_t count = static_cast<size_t>(buffer[0]) < t_counters.opened ? static_cast<size_t>(buffer[0]) : t_counters.opened;
+	for (size_t i = 0; i < count; ++i)
+	{
+		const uint8_t counter = t_counters.counters[i];
+		sample.values[counter] = buffer[3 + i];
+		sample.mask |= static_cast<uint8_t>(1u << counter);
+	}
+	return sample.mask != 0;
+}
+
+bool PerfCounters::IsAvailable()
+{
+	PerfCounterSample sample;
+	return Read(sample);
+}
+#else
+bool PerfCounters::Read(PerfCounterSample& sample)
+{
+	sample.mask = 0;
+	return false;
+}
+
+bool PerfCounters::IsAvailable()
+{
+	return false;
+}
+#endif
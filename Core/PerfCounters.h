@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Hardware counters the profiler can sample around a scope. Keep
+// GetPerfCounterName in sync.
+enum class PerfCounter : uint8_t
+{
+	Cycles = 0,
+	Instructions,
+	L1DMisses,
+	LLCMisses,
+	BranchMisses,
+	Count
+};
+
+constexpr size_t kPerfCounterCount = static_cast<size_t>(PerfCounter::Count);
+
+const char* GetPerfCounterName(PerfCounter counter);
+
+// One reading of the calling thread's counters. Bit i of mask is set when
+// values[i] is valid, a counter the CPU or the kernel won't give us stays 0.
+struct PerfCounterSample
+{
+	uint64_t values[kPerfCounterCount] = {};
+	// ns the group was enabled and actually on the PMU. running is behind
+	// enabled when the kernel multiplexes the group with other events.
+	uint64_t timeEnabled = 0;
+	uint64_t timeRunning = 0;
+	uint8_t mask = 0;
+};
+
+// Per thread counters through perf_event_open, opened as one group the
+// first time a thread reads them so a read is a single syscall. A group
+// the PMU can't fit never runs, so it is opened again without the last
+// counters until it does. Without perf (other platforms,
+// perf_event_paranoid, no PMU in a VM) Read just returns false with an
+// empty mask.
+namespace PerfCounters
+{
+	bool Read(PerfCounterSample& sample);
+
+	// end - begin, scaled by enabled / running time when the group was
+	// multiplexed in between. false with an empty mask if it never ran.
+	bool Delta(const PerfCounterSample& begin, const PerfCounterSample& end, PerfCounterSample& delta);
+
+	// whether the calling thread got any counter.
+	bool IsAvailable();
+}
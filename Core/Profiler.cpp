@@ -0,0 +1,463 @@
+#include "Profiler.h"
+
+#include "ProfilerTrace.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	thread_local void* t_buffer = nullptr;
+	thread_local bool t_exited = false;
+
+	// gives the thread's ring back when the thread exits.
+	struct ThreadBufferOwner
+	{
+		~ThreadBufferOwner()
+		{
+			t_buffer = nullptr;
+			t_exited = true;
+			if (inUse)
+			{
+				inUse->store(false, std::memory_order_release);
+			}
+		}
+
+		std::atomic<bool>* inUse = nullptr;
+	};
+	thread_local ThreadBufferOwner t_owner;
+
+	uint64_t GetOsThreadId()
+	{
+#if defined(_WIN32)
+		return static_cast<uint64_t>(GetCurrentThreadId());
+#elif defined(__linux__)
+		return static_cast<uint64_t>(syscall(SYS_gettid));
+#else
+		return static_cast<uint64_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+#endif
+	}
+
+	// drops what ended before since, the ring going further back isn't a loss.
+	void KeepRecent(std::vector<Profiler::ThreadCapture>& captures, uint64_t since)
+	{
+		for (Profiler::ThreadCapture& capture : captures)
+		{
+			auto old = std::remove_if(capture.events.begin(), capture.events.end(), [since](const ProfileEvent& event)
+			{
+				const uint64_t end = event.type == ProfileEventType::Scope ? event.start + event.duration : event.start;
+				return end < since;
+			});
+			capture.events.erase(old, capture.events.end());
+			capture.dropped = 0;
+		}
+	}
+}
+
+Profiler& Profiler::GetInstance()
+{
+	static Profiler* instance = new Profiler();
+	return *instance;
+}
+
+Profiler::Profiler()
+	: m_startTime(std::chrono::steady_clock::now())
+{
+}
+
+Profiler::~Profiler() = default;
+
+Profiler::ThreadBuffer::ThreadBuffer(uint64_t id)
+	: m_threadId(id)
+	, m_events(new ProfileEvent[kEventsPerThread])
+{
+}
+
+void Profiler::ThreadBuffer::Reset(uint64_t id)
+{
+	const uint64_t head = m_head.load(std::memory_order_relaxed);
+	m_previousOwners.push_back({ m_ownerBegin, m_threadId, m_name.load(std::memory_order_relaxed) });
+
+	// forget the owners with nothing left in the ring, each one's events end
+	// where the next one's begin.
+	const uint64_t oldest = head > kEventsPerThread ? head - kEventsPerThread : 0;
+	size_t kept = 0;
+	for (size_t o = 0; o < m_previousOwners.size(); ++o)
+	{
+		const uint64_t end = o + 1 < m_previousOwners.size() ? m_previousOwners[o + 1].begin : head;
+		if (end > oldest && end > m_previousOwners[o].begin)
+		{
+			m_previousOwners[kept++] = m_previousOwners[o];
+		}
+	}
+	m_previousOwners.resize(kept);
+
+	m_threadId = id;
+	m_name.store(nullptr, std::memory_order_relaxed);
+	m_ownerBegin = head;
+	m_inUse.store(true, std::memory_order_relaxed);
+}
+
+Profiler::ThreadBuffer* Profiler::GetThreadBuffer()
+{
+	if (!t_buffer)
+	{
+		// events from other thread_local destructors have nowhere to go.
+		if (t_exited)
+		{
+			return nullptr;
+		}
+
+		std::lock_guard<std::mutex> lock(m_threadsMutex);
+		ThreadBuffer* buffer = nullptr;
+		for (const std::unique_ptr<ThreadBuffer>& candidate : m_threads)
+		{
+			if (!candidate->m_inUse.load(std::memory_order_acquire))
+			{
+				buffer = candidate.get();
+				buffer->Reset(GetOsThreadId());
+				break;
+			}
+		}
+		if (!buffer)
+		{
+			m_threads.push_back(std::make_unique<ThreadBuffer>(GetOsThreadId()));
+			buffer = m_threads.back().get();
+		}
+		t_buffer = buffer;
+		t_owner.inUse = &buffer->m_inUse;
+	}
+	return static_cast<ThreadBuffer*>(t_buffer);
+}
+
+void Profiler::Record(const char* name, const char* detail, uint64_t start, uint64_t end, const PerfCounterSample* counters)
+{
+	ProfileEvent event;
+	event.name = name;
+	event.detail = detail;
+	event.start = start;
+	event.duration = end - start;
+	if (counters)
+	{
+		// 32 bits is seconds of cycles, past that a scope has bigger problems.
+		event.counterMask = counters->mask;
+		for (size_t i = 0; i < kPerfCounterCount; ++i)
+		{
+			event.counters[i] = static_cast<uint32_t>(std::min<uint64_t>(counters->values[i], UINT32_MAX));
+		}
+	}
+	if (ThreadBuffer* buffer = GetThreadBuffer())
+	{
+		buffer->Push(event);
+	}
+}
+
+void Profiler::RecordCounter(const char* name, double value)
+{
+	ProfileEvent event;
+	event.name = name;
+	event.start = Now();
+	event.value = value;
+	event.type = ProfileEventType::Counter;
+	if (ThreadBuffer* buffer = GetThreadBuffer())
+	{
+		buffer->Push(event);
+	}
+}
+
+void Profiler::SetThreadName(const char* name)
+{
+	if (ThreadBuffer* buffer = GetThreadBuffer())
+	{
+		buffer->m_name.store(name, std::memory_order_release);
+	}
+}
+
+std::vector<Profiler::ThreadCapture> Profiler::Capture() const
+{
+	CaptureCursor cursor;
+	return CaptureSince(cursor);
+}
+
+std::vector<Profiler::ThreadCapture> Profiler::CaptureSince(CaptureCursor& cursor) const
+{
+	std::vector<ThreadCapture> captures;
+	CaptureSince(cursor, captures);
+	return captures;
+}
+
+void Profiler::CaptureSince(CaptureCursor& cursor, std::vector<ThreadCapture>& captures) const
+{
+	std::lock_guard<std::mutex> lock(m_threadsMutex);
+
+	cursor.next.resize(m_threads.size(), 0);
+	size_t used = 0;
+	for (size_t t = 0; t < m_threads.size(); ++t)
+	{
+		const ThreadBuffer& buffer = *m_threads[t];
+		const uint64_t from = cursor.next[t];
+		const uint64_t end = buffer.m_head.load(std::memory_order_acquire);
+		const uint64_t oldest = end > kEventsPerThread ? end - kEventsPerThread : 0;
+		uint64_t begin = std::max(from, oldest);
+
+		// copied into this ring's first capture, other owners' events are
+		// moved out of it below.
+		if (captures.size() <= used)
+		{
+			captures.emplace_back();
+		}
+		{
+			std::vector<ProfileEvent>& events = captures[used].events;
+			events.clear();
+			events.reserve(static_cast<size_t>(end - begin));
+			for (uint64_t i = begin; i < end; ++i)
+			{
+				events.push_back(buffer.m_events[i & (kEventsPerThread - 1)]);
+			}
+
+			// the owner keeps recording while we copy, whatever it lapped since is
+			// torn. The fence keeps the copy above from moving past the head load,
+			// and the slot of event head may be mid write, so it goes too.
+			std::atomic_thread_fence(std::memory_order_acquire);
+			const uint64_t head = buffer.m_head.load(std::memory_order_relaxed);
+			const uint64_t overwritten = head + 1 > kEventsPerThread ? head + 1 - kEventsPerThread : 0;
+			if (overwritten > begin)
+			{
+				const uint64_t torn = std::min(overwritten, end) - begin;
+				events.erase(events.begin(), events.begin() + static_cast<size_t>(torn));
+				begin += torn;
+			}
+		}
+
+		// the events go to the threads that recorded them, what was lost
+		// before the first one's counts as its dropped. Walked twice: once
+		// to size captures, once to fill them.
+		const size_t owners = buffer.m_previousOwners.size();
+		auto forEachOwner = [&](auto&& fn) {
+			uint64_t counted = from;
+			for (size_t o = 0; o <= owners; ++o)
+			{
+				const bool current = o == owners;
+				const uint64_t ownerEnd = current ? end : (o + 1 < owners ? buffer.m_previousOwners[o + 1].begin : buffer.m_ownerBegin);
+				if (!current && ownerEnd <= from)
+				{
+					continue;
+				}
+				const uint64_t ownerBegin = current ? buffer.m_ownerBegin : buffer.m_previousOwners[o].begin;
+				const uint64_t first = std::min(std::max(ownerBegin, begin), ownerEnd);
+				const uint64_t last = std::max(first, std::min(ownerEnd, end));
+				const uint64_t dropped = ownerEnd - counted - (last - first);
+				counted = ownerEnd;
+
+				if (current || last > first || dropped > 0)
+				{
+					fn(o, first, last, dropped);
+				}
+			}
+		};
+
+		size_t count = 0;
+		forEachOwner([&count](size_t, uint64_t, uint64_t, uint64_t) { ++count; });
+		if (captures.size() < used + count)
+		{
+			captures.resize(used + count);
+		}
+
+		uint64_t keepFirst = begin;
+		uint64_t keepLast = end;
+		size_t slot = used;
+		forEachOwner([&](size_t o, uint64_t first, uint64_t last, uint64_t dropped) {
+			const bool current = o == owners;
+			ThreadCapture& capture = captures[slot];
+			capture.threadId = current ? buffer.m_threadId : buffer.m_previousOwners[o].threadId;
+			const char* name = current ? buffer.m_name.load(std::memory_order_acquire) : buffer.m_previousOwners[o].name;
+			capture.threadName.assign(name ? name : "");
+			capture.dropped = dropped;
+			if (slot == used)
+			{
+				keepFirst = first;
+				keepLast = last;
+			}
+			else
+			{
+				const std::vector<ProfileEvent>& events = captures[used].events;
+				capture.events.assign(events.begin() + static_cast<size_t>(first - begin), events.begin() + static_cast<size_t>(last - begin));
+			}
+			++slot;
+		});
+
+		std::vector<ProfileEvent>& events = captures[used].events;
+		events.erase(events.begin() + static_cast<size_t>(keepLast - begin), events.end());
+		events.erase(events.begin(), events.begin() + static_cast<size_t>(keepFirst - begin));
+
+		used += count;
+		cursor.next[t] = end;
+	}
+	captures.resize(used);
+}
+
+std::string Profiler::ToChromeTrace() const
+{
+	std::stringstream os;
+	ProfilerTrace::WriteChromeJson(os, Capture());
+	return os.str();
+}
+
+bool Profiler::WriteChromeTrace(const std::string& path) const
+{
+	std::ofstream file(path, std::ios_base::out | std::ios_base::trunc);
+	if (!file.is_open())
+	{
+		return false;
+	}
+	ProfilerTrace::WriteChromeJson(file, Capture());
+	return true;
+}
+
+bool Profiler::StartStreaming(const std::string& path, uint32_t flushMs)
+{
+	StopStreaming();
+
+	std::unique_ptr<ProfilerTrace::FileWriter> writer = std::make_unique<ProfilerTrace::FileWriter>();
+	if (!writer->Open(path))
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_streamMutex);
+	m_streamWriter = std::move(writer);
+	// skip what's already in the rings, the stream starts now.
+	m_streamCursor = CaptureCursor();
+	CaptureSince(m_streamCursor);
+	m_streaming = true;
+	m_streamThread = std::thread(&Profiler::StreamLoop, this, flushMs);
+	return true;
+}
+
+void Profiler::StopStreaming()
+{
+	WaitForDump();
+	{
+		std::lock_guard<std::mutex> lock(m_streamMutex);
+		if (!m_streaming)
+		{
+			return;
+		}
+		m_streaming = false;
+	}
+	m_streamWake.notify_one();
+	m_streamThread.join();
+
+	// whatever came in since the last flush.
+	m_streamWriter->Write(CaptureSince(m_streamCursor));
+	m_streamWriter->Close();
+	m_streamWriter.reset();
+}
+
+bool Profiler::IsStreaming() const
+{
+	std::lock_guard<std::mutex> lock(m_streamMutex);
+	return m_streaming;
+}
+
+void Profiler::StreamLoop(uint32_t flushMs)
+{
+	SetThreadName("Profiler Stream");
+
+	// reused every flush, the events vectors keep their capacity.
+	std::vector<ThreadCapture> captures;
+	std::unique_lock<std::mutex> lock(m_streamMutex);
+	while (m_streaming)
+	{
+		m_streamWake.wait_for(lock, std::chrono::milliseconds(flushMs));
+		if (!m_streaming)
+		{
+			break;
+		}
+
+		// no one else touches the writer or cursor while streaming.
+		lock.unlock();
+		{
+			PROFILE_SCOPE("Profiler Flush");
+			CaptureSince(m_streamCursor, captures);
+			m_streamWriter->Write(captures);
+			m_streamWriter->Flush();
+		}
+		lock.lock();
+	}
+}
+
+void Profiler::SetSpikeCapture(float thresholdMs, float seconds)
+{
+	m_spikeThresholdMs = thresholdMs;
+	m_spikeSeconds = seconds;
+}
+
+void Profiler::EndFrame(float frameMs)
+{
+	if (m_spikeThresholdMs <= 0.0f || frameMs < m_spikeThresholdMs)
+	{
+		return;
+	}
+
+	const uint64_t now = Now();
+	const uint64_t window = static_cast<uint64_t>(m_spikeSeconds * 1e9f);
+	if (m_spikeCount > 0 && now - m_lastSpike < window)
+	{
+		return;
+	}
+	m_lastSpike = now;
+
+	// copy the rings now, before the spike gets overwritten, and write them
+	// on the side so the next frame doesn't pay for the file too.
+	WaitForDump();
+	const std::string path = "profiler_spike_" + std::to_string(m_spikeCount++) + ".ptrace";
+	std::vector<ThreadCapture> captures = Capture();
+	m_dumpThread = std::thread([path, window, now, captures = std::move(captures)]() mutable
+	{
+		KeepRecent(captures, now > window ? now - window : 0);
+
+		ProfilerTrace::FileWriter writer;
+		if (writer.Open(path))
+		{
+			writer.Write(captures);
+		}
+	});
+}
+
+bool Profiler::DumpRecent(const std::string& path, float seconds) const
+{
+	const uint64_t now = Now();
+	const uint64_t window = static_cast<uint64_t>(seconds * 1e9f);
+
+	std::vector<ThreadCapture> captures = Capture();
+	KeepRecent(captures, now > window ? now - window : 0);
+
+	ProfilerTrace::FileWriter writer;
+	if (!writer.Open(path))
+	{
+		return false;
+	}
+	writer.Write(captures);
+	return true;
+}
+
+void Profiler::WaitForDump()
+{
+	if (m_dumpThread.joinable())
+	{
+		m_dumpThread.join();
+	}
+}
@@ -1,225 +1,251 @@
 #pragma once
 
-#define NOMINMAX
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
-
-#include <string>
-#include <sstream>
-#include <vector>
-
-#include <cassert>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <unordered_map>
+#include <thread>
 #include <vector>
 
-using namespace std::chrono;
-typedef duration<steady_clock::rep, steady_clock::period> DurationType;
-typedef std::pair<std::string, DurationType> NameAndDuration;
+#include "PerfCounters.h"
+
+// 0 compiles PROFILE_SCOPE out.
+#define PROFILING 1
 
-#include "Utils/FileIO.h"
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
 
-#define PROFILE_SCOPE(label, detail) ProfileMoment(label, detail);
-#define PROFILE_SCOPE(label) ProfileMoment(label, "");
+#if PROFILING
+// PROFILE_SCOPE("Name") or PROFILE_SCOPE("Name", "detail"), both string literals.
+#define PROFILE_SCOPE(...) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(__VA_ARGS__)
+// samples a value onto the "Name" counter track, e.g. a queue depth or a byte count.
+#define PROFILE_COUNTER(name, value) Profiler::GetInstance().RecordCounter(name, static_cast<double>(value))
+#else
+#define PROFILE_SCOPE(...)
+#define PROFILE_COUNTER(name, value) ((void)0)
+#endif
 
-struct ProfileData
+enum class ProfileEventType : uint8_t
 {
-	LARGE_INTEGER start;
-	LARGE_INTEGER end;
-	std::string label;
+	// timed, start and duration.
+	Scope,
+	// a value sampled at start.
+	Counter,
 };
 
-struct Entry {
-	time_point<steady_clock> Start;
-	DurationType Duration;
-	std::string Name;
-	std::string Detail;
+// One finished scope or counter sample. name and detail aren't copied,
+// they have to outlive the capture: string literals.
+struct ProfileEvent
+{
+	const char* name = nullptr;
+	const char* detail = nullptr;
+	// nanoseconds since the profiler started.
+	uint64_t start = 0;
+	union
+	{
+		uint64_t duration = 0;
+		double value;
+	};
+	ProfileEventType type = ProfileEventType::Scope;
+	// a scope's PerfCounter deltas while the profiler counts hardware
+	// events, bit i of counterMask marks counters[i] valid.
+	uint8_t counterMask = 0;
+	uint32_t counters[kPerfCounterCount] = {};
 };
 
-
-#define MILLISECONDS 1000
-#define MICROSECONDS 1000000
-#define TIME_FORMAT MILLISECONDS
-
-
-static std::string EscapeString(const char* src) {
-	std::string os;
-	while (*src) {
-		char c = *src;
-		switch (c) {
-		case '"':
-		case '\\':
-		case '\b':
-		case '\f':
-		case '\n':
-		case '\r':
-		case '\t':
-			os += '\\';
-			os += c;
-			break;
-		default:
-			if (c >= 32 && c < 126) {
-				os += c;
-			}
-		}
-		++src;
-	}
-	return os;
+namespace ProfilerTrace
+{
+	class FileWriter;
 }
 
+// Every thread records into its own ring of ProfileEvents, written only by
+// that thread, so recording takes no lock and allocates nothing past the
+// thread's first event. A full ring overwrites its oldest events, and the
+// ring of an exited thread goes to the next thread that starts. Capture
+// copies the rings out from any thread, and WriteChromeTrace turns them
+// into Chrome trace JSON (chrome://tracing, ui.perfetto.dev) with one
+// track per OS thread, and one track per counter name.
+//
+// For long sessions StartStreaming drains the rings into a binary trace
+// (ProfilerTrace.h) from a background thread, and SetSpikeCapture keeps
+// only the rings and dumps their last seconds when a frame runs long.
 class Profiler
 {
 public:
-	Profiler() 
-	{
-		QueryPerformanceFrequency(&freq);
+	// per thread, a power of two.
+	static constexpr size_t kEventsPerThread = 1 << 16;
 
-		Stack.reserve(8);
-		Entries.reserve(128);
-		StartTime = steady_clock::now();
-	}
-	~Profiler()
+	struct ThreadCapture
 	{
-		std::stringstream stream;
-		Write(stream);
-		FileIO::SaveTextFile("profiler_capture.json", stream.str());
-	}
-
-	size_t Start(const std::string& label)
+		uint64_t threadId = 0;
+		std::string threadName;
+		std::vector<ProfileEvent> events;
+		// events overwritten before they could be captured.
+		uint64_t dropped = 0;
+	};
+	// a ring that went from an exited thread to a new one captures as one
+	// ThreadCapture per thread, the new thread's last.
+
+	// how far each thread's ring has been captured, see CaptureSince.
+	struct CaptureCursor
 	{
-		ProfileData data;
-		data.label = label;
-		QueryPerformanceCounter(&data.start);
+		std::vector<uint64_t> next;
+	};
 
-		m_data.push_back(data);
-		return m_data.size() - 1;
-	}
+	// never destroyed, worker threads can still record while statics go away.
+	static Profiler& GetInstance();
 
-	void Stop(size_t index)
+	// nanoseconds since the profiler started.
+	uint64_t Now() const
 	{
-		auto& data = m_data[index];
-		QueryPerformanceCounter(&data.end);
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - m_startTime).count());
 	}
 
-	void Begin(const std::string& name, const std::string& detail) {
-		Entry e = { steady_clock::now(), {}, name, detail };
-		Stack.emplace_back(e);
-	}
+	// counters are the scope's deltas, if it sampled any.
+	void Record(const char* name, const char* detail, uint64_t start, uint64_t end, const PerfCounterSample* counters = nullptr);
+	void RecordCounter(const char* name, double value);
+
+	// scopes sample PerfCounters at begin and end, two syscalls each, so
+	// it's off by default. Without counters scopes just don't get any.
+	void SetHardwareCounters(bool enabled) { m_hardwareCounters.store(enabled, std::memory_order_relaxed); }
+	bool IsCountingHardware() const { return m_hardwareCounters.load(std::memory_order_relaxed); }
+
+	// names the calling thread's track.
+	void SetThreadName(const char* name);
+
+	// a copy of every thread's ring, oldest event first.
+	std::vector<ThreadCapture> Capture() const;
+	// only the events recorded since the cursor last moved, then moves it.
+	std::vector<ThreadCapture> CaptureSince(CaptureCursor& cursor) const;
+	// same, into captures, whose events vectors keep their capacity.
+	void CaptureSince(CaptureCursor& cursor, std::vector<ThreadCapture>& captures) const;
+
+	std::string ToChromeTrace() const;
+	bool WriteChromeTrace(const std::string& path) const;
+
+	// writes everything recorded from now on to a binary trace, flushing
+	// every flushMs. Rings have to be drained faster than they fill.
+	bool StartStreaming(const std::string& path, uint32_t flushMs = 50);
+	// also waits for a spike dump in flight.
+	void StopStreaming();
+	bool IsStreaming() const;
+
+	// frames over thresholdMs dump the last seconds of the rings to
+	// profiler_spike_<n>.ptrace, at most one dump per seconds. 0 turns it off.
+	void SetSpikeCapture(float thresholdMs, float seconds);
+	// once per frame, from the thread that owns the frame.
+	void EndFrame(float frameMs);
+	// the last seconds of the rings, as far back as they reach.
+	bool DumpRecent(const std::string& path, float seconds) const;
 
-	void End() {
-		assert(!Stack.empty() && "Must call Begin first");
-		auto& e = Stack.back();
-		e.Duration = steady_clock::now() - e.Start;
-
-		// only include sections longer than 500us
-		if (duration_cast<microseconds>(e.Duration).count() > 500)
-			Entries.emplace_back(e);
-
-		// track total time taken by each "name", but only the topmost levels of them;
-		// e.g. if there's a template instantiation that instantiates other templates
-		// from within, we only want to add the topmost one.
-		// "topmost" happens to be the ones that don't have any currently open
-		// entries above itself.
-		if (std::find_if(
-			++Stack.rbegin(), Stack.rend(),
-			[&](const Entry& val) { return val.Name == e.Name; }) == Stack.rend()) {
-			TotalPerName[e.Name] += e.Duration;
-			CountPerName[e.Name]++;
-		}
-
-		Stack.pop_back();
-	}
-
-	void Write(std::stringstream& os) {
-		assert(Stack.empty() &&
-			"All profiler sections should be ended when calling Write");
+private:
+	Profiler();
+	~Profiler();
 
-		os << "{ \"traceEvents\": [\n";
+	struct ThreadBuffer
+	{
+		explicit ThreadBuffer(uint64_t id);
 
-		// emit all events for the main flame graph
-		for (const auto& e : Entries) {
-			auto startUs = duration_cast<microseconds>(e.Start - StartTime).count();
-			auto durUs = duration_cast<microseconds>(e.Duration).count();
-			os << "{ \"pid\":1, \"tid\":0, \"ph\":\"X\", \"ts\":" << startUs
-				<< ", \"dur\":" << durUs << ", \"name\":\""
-				<< EscapeString(e.Name.c_str()) << "\", \"args\":{ \"detail\":\""
-				<< EscapeString(e.Detail.c_str()) << "\"} },\n";
-		}
+		// hands the ring of an exited thread to a new one, under m_threadsMutex.
+		void Reset(uint64_t id);
 
-		// emit totals by section name as additional "thread" events, sorted from
-		// longest one
-		int tid = 1;
-		std::vector<NameAndDuration> sortedTotals;
-		sortedTotals.reserve(TotalPerName.size());
-		for (const auto& e : TotalPerName) {
-			sortedTotals.push_back(e);
-		}
-		std::sort(sortedTotals.begin(), sortedTotals.end(), [](const NameAndDuration& a, const NameAndDuration& b) { return a.second > b.second; });
-		for (const auto& e : sortedTotals) {
-			auto durUs = duration_cast<microseconds>(e.second).count();
-			os << "{ \"pid\":1, \"tid\":" << tid << ", \"ph\":\"X\", \"ts\":" << 0
-				<< ", \"dur\":" << durUs << ", \"name\":\"Total "
-				<< EscapeString(e.first.c_str()) << "\", \"args\":{ \"count\":"
-				<< CountPerName[e.first] << ", \"avg ms\":"
-				<< (durUs / CountPerName[e.first] / 1000)
-				<< "} },\n";
-			++tid;
+		void Push(const ProfileEvent& event)
+		{
+			const uint64_t head = m_head.load(std::memory_order_relaxed);
+			m_events[head & (kEventsPerThread - 1)] = event;
+			m_head.store(head + 1, std::memory_order_release);
 		}
 
-		// emit metadata event with process name
-		os << "{ \"cat\":\"\", \"pid\":1, \"tid\":0, \"ts\":0, \"ph\":\"M\", "
-			"\"name\":\"process_name\", \"args\":{ \"name\":\"clang\" } }\n";
-		os << "] }\n";
-	}
-
-	std::vector<Entry> Stack;
-	std::vector<Entry> Entries;
-	std::unordered_map<std::string, DurationType> TotalPerName;
-	std::unordered_map<std::string, size_t> CountPerName;
-	time_point<steady_clock> StartTime;
+		// a thread that had the ring before, from its first event on.
+		struct Owner
+		{
+			uint64_t begin;
+			uint64_t threadId;
+			const char* name;
+		};
+
+		uint64_t m_threadId;
+		std::atomic<const char*> m_name{ nullptr };
+		// events ever pushed, the ring index is head % kEventsPerThread.
+		std::atomic<uint64_t> m_head{ 0 };
+		// head when the current thread took the ring.
+		uint64_t m_ownerBegin = 0;
+		// oldest first, as long as some of their events are still in the ring.
+		std::vector<Owner> m_previousOwners;
+		// cleared when the owning thread exits.
+		std::atomic<bool> m_inUse{ true };
+		std::unique_ptr<ProfileEvent[]> m_events;
+	};
+
+	// null once the calling thread is exiting, its ring may be someone else's.
+	ThreadBuffer* GetThreadBuffer();
+
+	const std::chrono::steady_clock::time_point m_startTime;
+	std::atomic<bool> m_hardwareCounters{ false };
+
+	void StreamLoop(uint32_t flushMs);
+	void WaitForDump();
+
+	// buffers outlive their threads so late captures still see them, until
+	// a new thread takes the ring over.
+	mutable std::mutex m_threadsMutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> m_threads;
+
+	mutable std::mutex m_streamMutex;
+	std::condition_variable m_streamWake;
+	std::thread m_streamThread;
+	std::unique_ptr<ProfilerTrace::FileWriter> m_streamWriter;
+	CaptureCursor m_streamCursor;
+	bool m_streaming = false;
+
+	float m_spikeThresholdMs = 0.0f;
+	float m_spikeSeconds = 0.0f;
+	uint64_t m_lastSpike = 0;
+	uint32_t m_spikeCount = 0;
+	std::thread m_dumpThread;
+};
 
-	size_t GetStartTime(size_t index)
+// Times its own lifetime, see PROFILE_SCOPE.
+struct ProfileScope
+{
+	// the counter reads are syscalls, they stay outside the timed span.
+	explicit ProfileScope(const char* name, const char* detail = nullptr)
+		: m_name(name)
+		, m_detail(detail)
 	{
-		auto& data = m_data[index];
-		return (data.start.QuadPart / TIME_FORMAT);
+		Profiler& profiler = Profiler::GetInstance();
+		if (profiler.IsCountingHardware())
+		{
+			PerfCounters::Read(m_counters);
+		}
+		m_start = profiler.Now();
 	}
 
-	size_t GetEndTime(size_t index)
+	~ProfileScope()
 	{
-		auto& data = m_data[index];
-		return (data.end.QuadPart / TIME_FORMAT);
-	}
+		Profiler& profiler = Profiler::GetInstance();
+		const uint64_t end = profiler.Now();
+		if (m_counters.mask == 0)
+		{
+			profiler.Record(m_name, m_detail, m_start, end);
+			return;
+		}
 
-	size_t GetDuration(size_t index)
-	{
-		auto& data = m_data[index];
-		return ((data.end.QuadPart - data.start.QuadPart) * TIME_FORMAT / freq.QuadPart);
+		PerfCounterSample sample, delta;
+		PerfCounters::Read(sample);
+		PerfCounters::Delta(m_counters, sample, delta);
+		profiler.Record(m_name, m_detail, m_start, end, &delta);
 	}
 
-	static Profiler& Instance() { return m_instance; }
-	std::vector<ProfileData>& GetData() { return m_data; }
-
-private:
-	LARGE_INTEGER freq;
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
 
-	std::vector<ProfileData> m_data;
-
-	static Profiler m_instance;
+	const char* m_name;
+	const char* m_detail;
+	uint64_t m_start = 0;
+	PerfCounterSample m_counters;
 };
-
-Profiler Profiler::m_instance = Profiler();
-
-struct ProfileMoment
-{
-	ProfileMoment(const std::string& label, const std::string& detail)
-	{
-		Profiler::Instance().Begin(label, detail);
-	}
-
-	~ProfileMoment()
-	{
-		Profiler::Instance().End();
-	}
-};
-
@@ -0,0 +1,224 @@
+#include "ProfilerStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string_view>
+
+namespace
+{
+	// nearest rank, sorted holds at least one sample.
+	float Percentile(const std::vector<float>& sorted, float percent)
+	{
+		const size_t rank = static_cast<size_t>(std::ceil(percent * static_cast<float>(sorted.size())));
+		return sorted[std::min(std::max(rank, size_t(1)), sorted.size()) - 1];
+	}
+}
+
+ProfilerStats::ProfilerStats(float windowSeconds, float refreshSeconds)
+	: m_windowSeconds(windowSeconds)
+	, m_refreshSeconds(refreshSeconds)
+{
+	// start from now, not from whatever the rings still hold.
+	Profiler::GetInstance().CaptureSince(m_cursor);
+}
+
+void ProfilerStats::Update()
+{
+	Profiler& profiler = Profiler::GetInstance();
+	profiler.CaptureSince(m_cursor, m_captures);
+	const uint64_t now = profiler.Now();
+	++m_updates;
+
+	for (const Profiler::ThreadCapture& capture : m_captures)
+	{
+		m_dropped += capture.dropped;
+		for (const ProfileEvent& event : capture.events)
+		{
+			if (event.type != ProfileEventType::Scope || !event.name)
+			{
+				continue;
+			}
+
+			Samples& samples = m_samples[GetSamplesIndex(event.name)];
+			Sample& sample = samples.ring[(samples.tail + samples.size) % kMaxSamples];
+			sample.end = event.start + event.duration;
+			sample.ms = static_cast<float>(event.duration) * 1e-6f;
+
+			if (samples.lastUpdate != m_updates)
+			{
+				samples.lastUpdate = m_updates;
+				samples.batches.emplace_back();
+			}
+			Batch& batch = samples.batches.back();
+			batch.end = std::max(batch.end, sample.end);
+			++batch.calls;
+			batch.totalMs += static_cast<double>(event.duration) * 1e-6;
+
+			sample.counterMask = event.counterMask;
+			std::copy(event.counters, event.counters + kPerfCounterCount, sample.counters);
+			if (samples.size < kMaxSamples)
+			{
+				++samples.size;
+			}
+			else
+			{
+				samples.tail = (samples.tail + 1) % kMaxSamples;
+			}
+		}
+	}
+
+	// threads drain one after another, so the ring is only roughly in time
+	// order; close enough to age out the window.
+	const uint64_t window = static_cast<uint64_t>(m_windowSeconds * 1e9f);
+	const uint64_t since = now > window ? now - window : 0;
+	for (Samples& samples : m_samples)
+	{
+		while (samples.size > 0 && samples.ring[samples.tail].end < since)
+		{
+			samples.tail = (samples.tail + 1) % kMaxSamples;
+			--samples.size;
+		}
+
+		while (samples.firstBatch < samples.batches.size() && samples.batches[samples.firstBatch].end < since)
+		{
+			++samples.firstBatch;
+		}
+		// drop aged batches once they're half the vector, it stops growing.
+		if (samples.firstBatch > 0 && samples.firstBatch * 2 >= samples.batches.size())
+		{
+			samples.batches.erase(samples.batches.begin(), samples.batches.begin() + static_cast<std::ptrdiff_t>(samples.firstBatch));
+			samples.firstBatch = 0;
+		}
+	}
+
+	if (now - m_lastRefresh >= static_cast<uint64_t>(m_refreshSeconds * 1e9f))
+	{
+		Refresh();
+	}
+}
+
+void ProfilerStats::Refresh()
+{
+	m_lastRefresh = Profiler::GetInstance().Now();
+	m_stats.clear();
+
+	for (const Samples& samples : m_samples)
+	{
+		if (samples.size == 0)
+		{
+			continue;
+		}
+
+		ScopeStats stats;
+		double counterSums[kPerfCounterCount] = {};
+		size_t counterCalls[kPerfCounterCount] = {};
+
+		m_sorted.clear();
+		for (size_t i = 0; i < samples.size; ++i)
+		{
+			const Sample& sample = samples.ring[(samples.tail + i) % kMaxSamples];
+			m_sorted.push_back(sample.ms);
+			for (size_t c = 0; c < kPerfCounterCount; ++c)
+			{
+				if (sample.counterMask & (1u << c))
+				{
+					counterSums[c] += sample.counters[c];
+					++counterCalls[c];
+				}
+			}
+		}
+		std::sort(m_sorted.begin(), m_sorted.end());
+
+		for (size_t c = 0; c < kPerfCounterCount; ++c)
+		{
+			if (counterCalls[c] > 0)
+			{
+				stats.counterMask |= static_cast<uint8_t>(1u << c);
+				stats.counters[c] = static_cast<float>(counterSums[c] / static_cast<double>(counterCalls[c]));
+			}
+		}
+		const size_t cycles = static_cast<size_t>(PerfCounter::Cycles);
+		const size_t instructions = static_cast<size_t>(PerfCounter::Instructions);
+		if (counterSums[cycles] > 0.0 && counterCalls[instructions] == counterCalls[cycles])
+		{
+			stats.ipc = static_cast<float>(counterSums[instructions] / counterSums[cycles]);
+		}
+
+		double totalMs = 0.0;
+		for (size_t b = samples.firstBatch; b < samples.batches.size(); ++b)
+		{
+			stats.count += samples.batches[b].calls;
+			totalMs += samples.batches[b].totalMs;
+		}
+		if (stats.count == 0)
+		{
+			continue;
+		}
+
+		stats.name = samples.name;
+		stats.totalMs = static_cast<float>(totalMs);
+		stats.minMs = m_sorted.front();
+		stats.maxMs = m_sorted.back();
+		stats.meanMs = stats.totalMs / static_cast<float>(stats.count);
+		stats.p50Ms = Percentile(m_sorted, 0.50f);
+		stats.p95Ms = Percentile(m_sorted, 0.95f);
+		stats.p99Ms = Percentile(m_sorted, 0.99f);
+		m_stats.push_back(std::move(stats));
+	}
+
+	std::sort(m_stats.begin(), m_stats.end(), [](const ScopeStats& a, const ScopeStats& b) { return a.totalMs > b.totalMs; });
+}
+
+void ProfilerStats::Reset()
+{
+	Profiler::GetInstance().CaptureSince(m_cursor);
+	for (Samples& samples : m_samples)
+	{
+		samples.tail = 0;
+		samples.size = 0;
+		samples.batches.clear();
+		samples.firstBatch = 0;
+	}
+	m_stats.clear();
+	m_dropped = 0;
+}
+
+const ProfilerStats::ScopeStats* ProfilerStats::Find(const char* name) const
+{
+	for (const ScopeStats& stats : m_stats)
+	{
+		if (stats.name == name)
+		{
+			return &stats;
+		}
+	}
+	return nullptr;
+}
+
+size_t ProfilerStats::GetSamplesIndex(const char* name)
+{
+	auto byPointer = m_byPointer.find(name);
+	if (byPointer != m_byPointer.end())
+	{
+		return byPointer->second;
+	}
+
+	size_t index = m_samples.size();
+	auto byName = m_byName.find(std::string_view(name));
+	if (byName != m_byName.end())
+	{
+		index = byName->second;
+	}
+	else
+	{
+		// a name's ring is allocated once, the first time it shows up.
+		Samples samples;
+		samples.name = name;
+		samples.ring.resize(kMaxSamples);
+		m_samples.push_back(std::move(samples));
+		m_byName[m_samples.back().name] = index;
+	}
+
+	m_byPointer[name] = index;
+	return index;
+}
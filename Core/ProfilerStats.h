@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Profiler.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Containers/FlatHashMap.h"
+
+// Rolling per scope statistics over the last few seconds of the profiler
+// rings. Recording doesn't change: threads still only push into their own
+// ring, Update drains them from one thread through its own cursor, so it
+// runs beside streaming. Percentiles are recomputed every refresh, reading
+// them in between is free.
+class ProfilerStats
+{
+public:
+	// samples kept per scope name for min, max and percentiles, older ones
+	// go first when a scope runs more often than this over the window.
+	// count, total and mean see every call.
+	static constexpr size_t kMaxSamples = 4096;
+
+	struct ScopeStats
+	{
+		std::string name;
+		// calls in the window.
+		size_t count = 0;
+		float totalMs = 0.0f;
+		// mean over every call, the rest over the last kMaxSamples.
+		float minMs = 0.0f;
+		float meanMs = 0.0f;
+		float p50Ms = 0.0f;
+		float p95Ms = 0.0f;
+		float p99Ms = 0.0f;
+		float maxMs = 0.0f;
+		// PerfCounter means per call, over the calls that sampled them; bit
+		// i of counterMask marks counters[i]. 0 with hardware counters off.
+		uint8_t counterMask = 0;
+		float counters[kPerfCounterCount] = {};
+		// instructions per cycle, 0 without both counters.
+		float ipc = 0.0f;
+	};
+
+	explicit ProfilerStats(float windowSeconds = 2.0f, float refreshSeconds = 0.25f);
+
+	// drains what was recorded since the last call, once per frame.
+	void Update();
+	// recomputes the stats now instead of at the next refresh.
+	void Refresh();
+	void Reset();
+
+	// scopes seen in the window, most total time first.
+	const std::vector<ScopeStats>& GetAll() const { return m_stats; }
+	// nullptr if name didn't run in the window.
+	const ScopeStats* Find(const char* name) const;
+
+	float GetWindowSeconds() const { return m_windowSeconds; }
+	void SetWindowSeconds(float seconds) { m_windowSeconds = seconds; }
+	// events the profiler overwrote before Update got to them.
+	uint64_t GetDropped() const { return m_dropped; }
+
+private:
+	struct Sample
+	{
+		uint64_t end = 0;
+		float ms = 0.0f;
+		uint8_t counterMask = 0;
+		uint32_t counters[kPerfCounterCount] = {};
+	};
+
+	// calls and time of one name in one Update, aged out as a whole.
+	struct Batch
+	{
+		uint64_t end = 0;
+		size_t calls = 0;
+		double totalMs = 0.0;
+	};
+
+	struct Samples
+	{
+		std::string name;
+		// a ring, oldest at tail.
+		std::vector<Sample> ring;
+		size_t tail = 0;
+		size_t size = 0;
+
+		// every call in the window, oldest from firstBatch.
+		std::vector<Batch> batches;
+		size_t firstBatch = 0;
+		uint64_t lastUpdate = 0;
+	};
+
+	size_t GetSamplesIndex(const char* name);
+
+	float m_windowSeconds;
+	float m_refreshSeconds;
+	uint64_t m_lastRefresh = 0;
+	uint64_t m_dropped = 0;
+
+	Profiler::CaptureCursor m_cursor;
+	// reused by every Update.
+	std::vector<Profiler::ThreadCapture> m_captures;
+	uint64_t m_updates = 0;
+	std::vector<Samples> m_samples;
+	// labels are literals, the pointer finds a name's samples without hashing
+	// its text; the text merges the same label from different places.
+	FlatHashMap<const char*, size_t> m_byPointer;
+	FlatHashMap<std::string, size_t, StringHash, std::equal_to<>> m_byName;
+
+	std::vector<ScopeStats> m_stats;
+	std::vector<float> m_sorted;
+};
@@ -0,0 +1,469 @@
+#include "ProfilerTrace.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+
+namespace ProfilerTrace
+{
+	namespace
+	{
+		void WriteEscaped(std::ostream& os, const char* src)
+		{
+			for (; src && *src; ++src)
+			{
+				const char c = *src;
+				switch (c)
+				{
+				case '"': os << "\\\""; break;
+				case '\\': os << "\\\\"; break;
+				case '\n': os << "\\n"; break;
+				case '\t': os << "\\t"; break;
+				default:
+					if (c >= 32 && c < 127) { os << c; }
+					break;
+				}
+			}
+		}
+
+		// chrome trace timestamps are microseconds, fractions keep the nanoseconds.
+		void WriteMicroseconds(std::ostream& os, uint64_t ns)
+		{
+			char text[32];
+			snprintf(text, sizeof(text), "%llu.%03llu",
+				static_cast<unsigned long long>(ns / 1000), static_cast<unsigned long long>(ns % 1000));
+			os << text;
+		}
+
+		// the scope's PerfCounter deltas as args, after a detail if there's one.
+		void WriteCounters(std::ostream& os, const ProfileEvent& event)
+		{
+			bool first = !(event.detail && *event.detail);
+			for (size_t i = 0; i < kPerfCounterCount; ++i)
+			{
+				if (event.counterMask & (1u << i))
+				{
+					os << (first ? "" : ", ") << "\"" << GetPerfCounterName(static_cast<PerfCounter>(i)) << "\":" << event.counters[i];
+					first = false;
+				}
+			}
+
+			const uint8_t ipcMask = (1u << static_cast<size_t>(PerfCounter::Cycles)) | (1u << static_cast<size_t>(PerfCounter::Instructions));
+			const uint32_t cycles = event.counters[static_cast<size_t>(PerfCounter::Cycles)];
+			if ((event.counterMask & ipcMask) == ipcMask && cycles > 0)
+			{
+				char ipc[32];
+				snprintf(ipc, sizeof(ipc), "%.3f", static_cast<double>(event.counters[static_cast<size_t>(PerfCounter::Instructions)]) / cycles);
+				os << ", \"IPC\":" << ipc;
+			}
+		}
+
+		// longer than any label or thread name, a bigger length is a broken file.
+		constexpr uint64_t kMaxStringLength = 64 * 1024;
+
+		uint64_t ToBits(double value)
+		{
+			uint64_t bits = 0;
+			memcpy(&bits, &value, sizeof(bits));
+			return bits;
+		}
+
+		double FromBits(uint64_t bits)
+		{
+			double value = 0.0;
+			memcpy(&value, &bits, sizeof(value));
+			return value;
+		}
+	}
+
+	bool FileWriter::Open(const std::string& path)
+	{
+		Close();
+		m_file.open(path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+		if (!m_file.is_open())
+		{
+			return false;
+		}
+
+		const FileHeader header;
+		m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		return true;
+	}
+
+	void FileWriter::Close()
+	{
+		if (m_file.is_open())
+		{
+			m_file.close();
+		}
+		m_strings.clear();
+		m_threads.clear();
+		m_lastStringId = 0;
+	}
+
+	void FileWriter::Write(const std::vector<Profiler::ThreadCapture>& captures)
+	{
+		if (!m_file.is_open())
+		{
+			return;
+		}
+
+		m_buffer.clear();
+		for (size_t t = 0; t < captures.size(); ++t)
+		{
+			const Profiler::ThreadCapture& capture = captures[t];
+			const uint32_t thread = static_cast<uint32_t>(t);
+
+			// (re)define the thread when it's new, got its name since, or its
+			// ring went to another thread.
+			if (t >= m_threads.size())
+			{
+				m_threads.resize(t + 1);
+			}
+			if (!m_threads[t].defined || m_threads[t].threadId != capture.threadId || m_threads[t].name != capture.threadName)
+			{
+				m_threads[t].defined = true;
+				m_threads[t].threadId = capture.threadId;
+				m_threads[t].name = capture.threadName;
+				Record record;
+				record.type = RecordType::Thread;
+				record.thread = thread;
+				record.name = capture.threadName.empty() ? 0 : DefineString(capture.threadName.c_str(), capture.threadName.size());
+				record.start = capture.threadId;
+				WriteRecord(record);
+			}
+
+			if (capture.dropped > 0)
+			{
+				Record record;
+				record.type = RecordType::Dropped;
+				record.thread = thread;
+				record.payload = capture.dropped;
+				WriteRecord(record);
+			}
+
+			for (const ProfileEvent& event : capture.events)
+			{
+				Record record;
+				record.thread = thread;
+				record.name = GetStringId(event.name);
+				record.start = event.start;
+				if (event.type == ProfileEventType::Counter)
+				{
+					record.type = RecordType::Counter;
+					record.payload = ToBits(event.value);
+				}
+				else
+				{
+					record.type = RecordType::Scope;
+					record.detail = GetStringId(event.detail);
+					record.payload = event.duration;
+				}
+				WriteRecord(record);
+
+				if (event.counterMask != 0)
+				{
+					CountersRecord counters;
+					counters.mask = event.counterMask;
+					counters.thread = thread;
+					memcpy(counters.values, event.counters, sizeof(counters.values));
+					m_buffer.insert(m_buffer.end(), reinterpret_cast<const char*>(&counters), reinterpret_cast<const char*>(&counters) + sizeof(counters));
+				}
+			}
+		}
+
+		m_file.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+	}
+
+	uint32_t FileWriter::GetStringId(const char* text)
+	{
+		if (!text)
+		{
+			return 0;
+		}
+
+		auto found = m_strings.find(text);
+		if (found != m_strings.end())
+		{
+			return found->second;
+		}
+
+		const uint32_t id = DefineString(text, strlen(text));
+		m_strings[text] = id;
+		return id;
+	}
+
+	uint32_t FileWriter::DefineString(const char* text, size_t length)
+	{
+		Record record;
+		record.type = RecordType::String;
+		record.name = ++m_lastStringId;
+		record.payload = length;
+		WriteRecord(record);
+		m_buffer.insert(m_buffer.end(), text, text + length);
+		return record.name;
+	}
+
+	void FileWriter::WriteRecord(const Record& record)
+	{
+		const char* bytes = reinterpret_cast<const char*>(&record);
+		m_buffer.insert(m_buffer.end(), bytes, bytes + sizeof(record));
+	}
+
+	ChromeJsonWriter::ChromeJsonWriter(std::ostream& os)
+		: m_os(os)
+	{
+		m_os << "{ \"traceEvents\": [\n";
+	}
+
+	void ChromeJsonWriter::Event(uint64_t threadId, const ProfileEvent& event)
+	{
+		if (event.type == ProfileEventType::Counter)
+		{
+			// counters are per process, samples from every thread land on one track.
+			char value[32];
+			snprintf(value, sizeof(value), "%.15g", event.value);
+			m_os << "{ \"pid\":1, \"ph\":\"C\", \"ts\":";
+			WriteMicroseconds(m_os, event.start);
+			m_os << ", \"name\":\"";
+			WriteEscaped(m_os, event.name);
+			m_os << "\", \"args\":{ \"value\":" << value << " } },\n";
+			return;
+		}
+
+		m_os << "{ \"pid\":1, \"tid\":" << threadId << ", \"ph\":\"X\", \"ts\":";
+		WriteMicroseconds(m_os, event.start);
+		m_os << ", \"dur\":";
+		WriteMicroseconds(m_os, event.duration);
+		m_os << ", \"name\":\"";
+		WriteEscaped(m_os, event.name);
+		m_os << "\"";
+		if (event.detail && *event.detail)
+		{
+			m_os << ", \"args\":{ \"detail\":\"";
+			WriteEscaped(m_os, event.detail);
+			m_os << "\"";
+			WriteCounters(m_os, event);
+			m_os << " }";
+		}
+		else if (event.counterMask != 0)
+		{
+			m_os << ", \"args\":{ ";
+			WriteCounters(m_os, event);
+			m_os << " }";
+		}
+		m_os << " },\n";
+
+		std::pair<uint64_t, size_t>& total = m_totals[event.name ? event.name : ""];
+		total.first += event.duration;
+		++total.second;
+	}
+
+	void ChromeJsonWriter::ThreadName(uint64_t threadId, const char* name)
+	{
+		m_threadNames.emplace_back(threadId, name ? name : "");
+	}
+
+	void ChromeJsonWriter::Dropped(uint64_t, uint64_t count)
+	{
+		m_dropped += count;
+	}
+
+	void ChromeJsonWriter::End()
+	{
+		for (const auto& thread : m_threadNames)
+		{
+			m_os << "{ \"pid\":1, \"tid\":" << thread.first << ", \"ph\":\"M\", \"name\":\"thread_name\", \"args\":{ \"name\":\"";
+			WriteEscaped(m_os, thread.second.c_str());
+			m_os << "\" } },\n";
+		}
+
+		// totals by name as a second process, one track each, longest first.
+		std::vector<std::pair<std::string, std::pair<uint64_t, size_t>>> sortedTotals;
+		sortedTotals.reserve(m_totals.size());
+		for (const auto& total : m_totals)
+		{
+			sortedTotals.emplace_back(total.first, total.second);
+		}
+		std::sort(sortedTotals.begin(), sortedTotals.end(), [](const auto& a, const auto& b) { return a.second.first > b.second.first; });
+		int tid = 1;
+		for (const auto& total : sortedTotals)
+		{
+			m_os << "{ \"pid\":2, \"tid\":" << tid++ << ", \"ph\":\"X\", \"ts\":0, \"dur\":";
+			WriteMicroseconds(m_os, total.second.first);
+			m_os << ", \"name\":\"Total ";
+			WriteEscaped(m_os, total.first.c_str());
+			m_os << "\", \"args\":{ \"count\":" << total.second.second << ", \"avg ms\":"
+				<< static_cast<double>(total.second.first) / static_cast<double>(total.second.second) * 1e-6 << " } },\n";
+		}
+
+		m_os << "{ \"pid\":2, \"tid\":0, \"ph\":\"M\", \"name\":\"process_name\", \"args\":{ \"name\":\"Totals\" } },\n";
+		m_os << "{ \"pid\":1, \"tid\":0, \"ph\":\"M\", \"name\":\"process_name\", \"args\":{ \"name\":\"Game\", \"dropped events\":"
+			<< m_dropped << " } }\n";
+		m_os << "] }\n";
+	}
+
+	void WriteChromeJson(std::ostream& os, const std::vector<Profiler::ThreadCapture>& captures)
+	{
+		ChromeJsonWriter writer(os);
+		for (const Profiler::ThreadCapture& capture : captures)
+		{
+			for (const ProfileEvent& event : capture.events)
+			{
+				writer.Event(capture.threadId, event);
+			}
+			if (!capture.threadName.empty())
+			{
+				writer.ThreadName(capture.threadId, capture.threadName.c_str());
+			}
+			writer.Dropped(capture.threadId, capture.dropped);
+		}
+		writer.End();
+	}
+
+	bool ConvertToChromeJson(const std::string& tracePath, const std::string& jsonPath)
+	{
+		std::ifstream input(tracePath, std::ios_base::in | std::ios_base::binary);
+		FileHeader header;
+		if (!input.read(reinterpret_cast<char*>(&header), sizeof(header))
+			|| memcmp(header.magic, FileHeader().magic, sizeof(header.magic)) != 0 || header.version != kVersion)
+		{
+			return false;
+		}
+
+		std::ofstream output(jsonPath, std::ios_base::out | std::ios_base::trunc);
+		if (!output.is_open())
+		{
+			return false;
+		}
+
+		// events point at these, a deque keeps them in place as it grows.
+		std::deque<std::string> strings(1);
+		std::vector<uint64_t> threadIds;
+		std::vector<uint32_t> threadNames;
+		auto text = [&strings](uint32_t id) { return id < strings.size() && id > 0 ? strings[id].c_str() : nullptr; };
+
+		ChromeJsonWriter writer(output);
+
+		// a scope waits for the counters record that may follow it.
+		ProfileEvent pending;
+		uint64_t pendingThread = 0;
+		bool hasPending = false;
+		auto flushPending = [&]()
+		{
+			if (hasPending)
+			{
+				writer.Event(pendingThread, pending);
+				hasPending = false;
+			}
+		};
+
+		// a bad record ends the conversion, what came before it still goes out.
+		bool valid = true;
+		Record record;
+		while (valid && input.read(reinterpret_cast<char*>(&record), sizeof(record)))
+		{
+			if (record.type == RecordType::ScopeCounters)
+			{
+				if (hasPending)
+				{
+					CountersRecord counters;
+					memcpy(static_cast<void*>(&counters), &record, sizeof(counters));
+					pending.counterMask = counters.mask;
+					memcpy(pending.counters, counters.values, sizeof(pending.counters));
+				}
+				flushPending();
+				continue;
+			}
+			flushPending();
+
+			if (record.type == RecordType::String)
+			{
+				// ids are handed out in order, each one defined once.
+				if (record.name != strings.size() || record.payload > kMaxStringLength)
+				{
+					valid = false;
+					break;
+				}
+				std::string& string = strings.emplace_back(static_cast<size_t>(record.payload), '\0');
+				valid = string.empty() || input.read(&string[0], static_cast<std::streamsize>(string.size()));
+				continue;
+			}
+
+			// thread slots too, a record may only use a slot that was defined.
+			if (record.type == RecordType::Thread && record.thread == threadIds.size())
+			{
+				threadIds.push_back(0);
+				threadNames.push_back(0);
+			}
+			if (record.thread >= threadIds.size())
+			{
+				valid = false;
+				break;
+			}
+
+			switch (record.type)
+			{
+			case RecordType::Thread:
+				// the slot's ring went to another thread, name the old track now.
+				if (threadNames[record.thread] != 0 && threadIds[record.thread] != record.start)
+				{
+					writer.ThreadName(threadIds[record.thread], text(threadNames[record.thread]));
+				}
+				threadIds[record.thread] = record.start;
+				threadNames[record.thread] = record.name;
+				break;
+			case RecordType::Dropped:
+				writer.Dropped(threadIds[record.thread], record.payload);
+				break;
+			case RecordType::Scope:
+			case RecordType::Counter:
+			{
+				ProfileEvent event;
+				event.name = text(record.name);
+				event.detail = text(record.detail);
+				event.start = record.start;
+				if (record.type == RecordType::Counter)
+				{
+					event.type = ProfileEventType::Counter;
+					event.value = FromBits(record.payload);
+				}
+				else
+				{
+					event.duration = record.payload;
+				}
+
+				if (event.type == ProfileEventType::Scope)
+				{
+					pending = event;
+					pendingThread = threadIds[record.thread];
+					hasPending = true;
+				}
+				else
+				{
+					writer.Event(threadIds[record.thread], event);
+				}
+				break;
+			}
+			default:
+				valid = false;
+				break;
+			}
+		}
+		// a read cut short mid record is a truncated file.
+		valid = valid && input.eof() && input.gcount() == 0;
+		flushPending();
+
+		for (size_t t = 0; t < threadIds.size(); ++t)
+		{
+			if (threadNames[t] != 0)
+			{
+				writer.ThreadName(threadIds[t], text(threadNames[t]));
+			}
+		}
+		writer.End();
+		output.flush();
+		return valid && output.good();
+	}
+}
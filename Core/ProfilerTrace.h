@@ -0,0 +1,132 @@
+#pragma once
+
+#include "Profiler.h"
+
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Containers/FlatHashMap.h"
+
+// Binary profiler trace, the streamed and dumped format. A FileHeader, then
+// 32 byte Records in the order they were written. String records
+// are followed by their bytes and define an id before any record uses it;
+// thread records do the same for a thread index. TraceConverter turns a
+// file into Chrome trace JSON.
+namespace ProfilerTrace
+{
+	constexpr uint32_t kVersion = 1;
+
+	struct FileHeader
+	{
+		char magic[4] = { 'P', 'T', 'R', 'C' };
+		uint32_t version = kVersion;
+	};
+
+	enum class RecordType : uint8_t
+	{
+		// start and duration in payload.
+		Scope,
+		// start, value bits in payload.
+		Counter,
+		// defines string name, payload bytes follow.
+		String,
+		// defines thread index: OS id in start, name string in name.
+		Thread,
+		// payload events of thread were lost before they could be written.
+		Dropped,
+		// PerfCounter deltas of the Scope record right before it, a CountersRecord.
+		ScopeCounters,
+	};
+
+	struct Record
+	{
+		RecordType type = RecordType::Scope;
+		uint8_t reserved[3] = {};
+		uint32_t thread = 0;
+		// string ids, 0 is none.
+		uint32_t name = 0;
+		uint32_t detail = 0;
+		// nanoseconds since the profiler started.
+		uint64_t start = 0;
+		uint64_t payload = 0;
+	};
+	static_assert(sizeof(Record) == 32, "trace records are 32 bytes");
+
+	struct CountersRecord
+	{
+		RecordType type = RecordType::ScopeCounters;
+		uint8_t mask = 0;
+		uint8_t reserved[2] = {};
+		uint32_t thread = 0;
+		uint32_t values[kPerfCounterCount] = {};
+		uint8_t padding[24 - 4 * kPerfCounterCount] = {};
+	};
+	static_assert(sizeof(CountersRecord) == sizeof(Record), "counter records are read as records");
+	static_assert(std::is_trivially_copyable<Record>::value && std::is_trivially_copyable<CountersRecord>::value,
+		"records are copied as bytes");
+
+	// Encodes captures into a trace file, defining strings and threads the
+	// first time they show up. One writer per file, not thread safe.
+	class FileWriter
+	{
+	public:
+		bool Open(const std::string& path);
+		void Close();
+		bool IsOpen() const { return m_file.is_open(); }
+
+		// captures[i] is written as thread slot i, as Profiler::Capture orders them.
+		// a slot is redefined when its thread id or name changes (recycled rings).
+		void Write(const std::vector<Profiler::ThreadCapture>& captures);
+		void Flush() { m_file.flush(); }
+
+	private:
+		struct ThreadState
+		{
+			bool defined = false;
+			uint64_t threadId = 0;
+			std::string name;
+		};
+
+		uint32_t GetStringId(const char* text);
+		uint32_t DefineString(const char* text, size_t length);
+		void WriteRecord(const Record& record);
+
+		std::ofstream m_file;
+		// label pointers are stable, so they're the key, not their text.
+		FlatHashMap<const char*, uint32_t> m_strings;
+		uint32_t m_lastStringId = 0;
+		std::vector<ThreadState> m_threads;
+		// flushed later in one write.
+		std::vector<char> m_buffer;
+	};
+
+	// Writes Chrome trace JSON one event at a time, totals per scope name
+	// and thread names go out with End.
+	class ChromeJsonWriter
+	{
+	public:
+		explicit ChromeJsonWriter(std::ostream& os);
+
+		void Event(uint64_t threadId, const ProfileEvent& event);
+		void ThreadName(uint64_t threadId, const char* name);
+		void Dropped(uint64_t threadId, uint64_t count);
+		void End();
+
+	private:
+		std::ostream& m_os;
+		FlatHashMap<std::string, std::pair<uint64_t, size_t>, StringHash, std::equal_to<>> m_totals;
+		std::vector<std::pair<uint64_t, std::string>> m_threadNames;
+		uint64_t m_dropped = 0;
+	};
+
+	void WriteChromeJson(std::ostream& os, const std::vector<Profiler::ThreadCapture>& captures);
+
+	// false if the input isn't a trace, holds a bad or truncated record, or
+	// the output can't be written. Records before a bad one are still converted.
+	bool ConvertToChromeJson(const std::string& tracePath, const std::string& jsonPath);
+}
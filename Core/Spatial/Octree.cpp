@@ -5,29 +5,35 @@
 
 namespace core
 {
-    Octree::Octree()
+    Octree::Octree(std::pmr::memory_resource* memory, PoolMode octants)
         : m_root(nullptr)
-        , m_data(nullptr)
+        , m_octants(1024, octants)
+        , m_points(memory)
+        , m_edges(memory)
     {
 
     }
 
     Octree::~Octree()
     {
-        delete m_root;
-        delete m_data;
+        Clear();
     }
 
     void Octree::Initialize(const std::vector<glm::vec3>& points)
     {
-        assert(!points.empty());
+        Initialize(points.data(), points.size());
+    }
 
-        Clear();
+    void Octree::Initialize(const glm::vec3* points, size_t n)
+    {
+        assert(n > 0);
 
-        const size_t n = points.size();
-        m_data = new std::vector<glm::vec3>(points); // copy points for now
+        Clear();
 
-        m_edges = std::vector<size_t>(n);
+        m_points.assign(points, points + n);
+        m_edges.resize(n);
+        // a guess, leaves are rarely more than half full. more slabs get added if needed.
+        m_octants.reserve(2 * n / m_maxNodesPerLeaf + 1);
 
         glm::vec3 min = points[0];
         glm::vec3 max = points[0];
@@ -60,9 +66,10 @@ namespace core
 
     void Octree::Clear()
     {
-        delete m_root;
+        m_octants.Reset();
         m_root = nullptr;
-        m_data = nullptr;
+        m_points.clear();
+        m_edges.clear();
     }
 
     void Octree::FindNeighbors(const glm::vec3& position, float radius, std::vector<size_t>& outIndices)
@@ -78,7 +85,7 @@ namespace core
 
     Octree::Octant* Octree::CreateOctant(glm::vec3 center, float extent, size_t start, size_t end, size_t size)
     {
-        Octant* octant = new Octant();
+        Octant* octant = m_octants.construct();
         octant->m_isLeaf = true;
         octant->m_center = center;
         octant->m_radius = extent;
@@ -90,7 +97,7 @@ namespace core
         {
             octant->m_isLeaf = false;
 
-            const std::vector<glm::vec3>& points = *m_data;
+            const glm::vec3* points = m_points.data();
             // each child ( 8 octants ), start index, end index, and size.
             std::vector<std::tuple<size_t, size_t, size_t>> child(8, { 0, 0, 0 });
 
@@ -167,7 +174,7 @@ namespace core
 
     void Octree::FindNeighbors(Octant* octant, const glm::vec3& pos, float radius, float radiusSq, std::vector<size_t>& outIndiceResults)
     {
-        const std::vector<glm::vec3>& points = *m_data;
+        const glm::vec3* points = m_points.data();
 
         // contains full octant, add all indices.
         if (ContainsOctant(octant, pos, radiusSq))
@@ -11,8 +11,11 @@
 
 #include <vector>
 #include <memory>
+#include <memory_resource>
 #include <glm/glm.hpp>
 
+#include "../Memory/PoolAllocator.h"
+
 namespace core
 {
     class Octree
@@ -27,14 +30,6 @@ namespace core
 					m_child[i] = nullptr;
 				}
 			}
-			~Octant()
-			{
-				for (size_t i = 0; i < 8; ++i)
-				{
-					delete m_child[i];
-					m_child[i] = nullptr;
-				}
-			}
 
 			Octant* m_child[8];
 
@@ -48,9 +43,12 @@ namespace core
 			bool m_isLeaf = false;
 		};
 
-		Octree();
+		// points and links are stored in memory, e.g. a VirtualMemoryResource
+		// for the million point runs. they keep their capacity between builds.
+		explicit Octree(std::pmr::memory_resource* memory = std::pmr::get_default_resource(), PoolMode octants = PoolMode::Slabs);
 		~Octree();
 		void Initialize(const std::vector<glm::vec3>& points);
+		void Initialize(const glm::vec3* points, size_t count);
 		void Clear();
 
 		void FindNeighbors(const glm::vec3& position, float radius, std::vector<size_t>& outIndices);
@@ -66,9 +64,11 @@ namespace core
 
 	private:
 		Octant* m_root = nullptr;
+		// octants live in here, Clear drops them all and keeps the slabs for the next build.
+		PoolAllocator<Octant> m_octants;
 
-		const std::vector<glm::vec3>* m_data = nullptr;
-		std::vector<size_t> m_edges;
+		std::pmr::vector<glm::vec3> m_points;
+		std::pmr::vector<size_t> m_edges;
 
 		const size_t m_maxNodesPerLeaf = 16;
     };
@@ -20,7 +20,7 @@ public:
 		float m_orthoTop = 5.0f;
 		float m_orthoBottom = 5.0f;
 
-		bool operator==(const Properties& rhs) 
+		bool operator==(const Properties& rhs) const
 		{
 			if (m_fov != rhs.m_fov) return false;
 			if (m_aspectRatio != rhs.m_aspectRatio) return false;
@@ -34,7 +34,7 @@ public:
 			return true;
 		}
 
-		bool operator!=(const Properties& rhs) 
+		bool operator!=(const Properties& rhs) const
 		{
 			return !(*this == rhs);
 		}
@@ -12,8 +12,10 @@ AABBOctree::AABBOctree()
 {
 }
 
-AABBOctree::AABBOctree(const glm::vec3& position, float halfSize)
+AABBOctree::AABBOctree(const glm::vec3& position, float halfSize, std::pmr::memory_resource* memory)
     : m_bounds(position, halfSize)
+    , m_memory(memory)
+    , m_nodes(memory)
 { 
     for (size_t i = 0; i < 8; ++i)
     {
@@ -22,12 +24,52 @@ AABBOctree::AABBOctree(const glm::vec3& position, float halfSize)
 }
 
 AABBOctree::~AABBOctree()
+{
+    ClearChildren();
+}
+
+AABBOctree::AABBOctree(AABBOctree&& other) noexcept
+    : m_bounds(other.m_bounds)
+    , m_maxNodes(other.m_maxNodes)
+    , m_memory(other.m_memory)
+    , m_nodes(std::move(other.m_nodes))
+{
+    for (size_t i = 0; i < 8; ++i)
+    {
+        m_child[i] = other.m_child[i];
+        other.m_child[i] = nullptr;
+    }
+}
+
+AABBOctree& AABBOctree::operator=(AABBOctree&& other) noexcept
+{
+    if (this != &other)
+    {
+        ClearChildren();
+
+        m_bounds = other.m_bounds;
+        m_maxNodes = other.m_maxNodes;
+        m_memory = other.m_memory;
+        // a pmr list keeps its own resource, only the children switch over.
+        m_nodes = std::move(other.m_nodes);
+        for (size_t i = 0; i < 8; ++i)
+        {
+            m_child[i] = other.m_child[i];
+            other.m_child[i] = nullptr;
+        }
+    }
+    return *this;
+}
+
+void AABBOctree::ClearChildren()
 {
     m_nodes.clear();
 
+    // children come from NodePool<AABBOctree>, deleting them only refills the pool.
     for (size_t i = 0; i < 8; ++i)
     {
         delete m_child[i];
+        m_child[i] = nullptr;
     }
 }
 
@@ -37,6 +79,8 @@ bool AABBOctree::Insert(const glm::vec3& position, size_t index)
 
     if (m_child[0] == nullptr && m_nodes.size() < m_maxNodes)
     {
+        // one block per leaf instead of growing through every size.
+        if (m_nodes.capacity() == 0) { m_nodes.reserve(m_maxNodes); }
         m_nodes.push_back({ position, index });
         return true;
     }
@@ -54,20 +98,20 @@ bool AABBOctree::Insert(const glm::vec3& position, size_t index)
     return false;
 }
 
-void AABBOctree::FindNeighbors(const glm::vec3& pos, float radius, std::vector<OcNode>& outResult)
+void AABBOctree::FindNeighbors(const glm::vec3& pos, float radius, SearchResults& outResult)
 {
     outResult.clear();
     const float radiusSq = radius * radius;
     InternalFindNeighbors(pos, radius, radiusSq, outResult);
 }
 
-void AABBOctree::Search(const AABB& aabb, std::vector<OcNode>& outResult)
+void AABBOctree::Search(const AABB& aabb, SearchResults& outResult)
 {
     outResult.clear();
     InternalSearch(aabb, outResult);
 }
 
-void AABBOctree::Search(const BoundingFrustum& frustum, std::vector<OcNode>& outResult)
+void AABBOctree::Search(const BoundingFrustum& frustum, SearchResults& outResult)
 {
     outResult.clear();
     InternalSearch(frustum, outResult);
@@ -119,11 +163,11 @@ void AABBOctree::Subdivide()
     for (size_t i = 0; i < 8; ++i)
     {
         const glm::vec3 pos = center + positions[i] * halfSize;
-        m_child[i] = new AABBOctree(pos, halfSize);
+        m_child[i] = new AABBOctree(pos, halfSize, m_memory);
     }
 }
 
-void AABBOctree::InternalSearch(const AABB& aabb, std::vector<OcNode>& outResult)
+void AABBOctree::InternalSearch(const AABB& aabb, SearchResults& outResult)
 {
     if (!m_bounds.Contains(aabb)) { return; }
 
@@ -142,7 +186,7 @@ void AABBOctree::InternalSearch(const AABB& aabb, std::vector<OcNode>& outResult
     }
 }
 
-void AABBOctree::InternalSearch(const BoundingFrustum& frustum, std::vector<OcNode>& outResult)
+void AABBOctree::InternalSearch(const BoundingFrustum& frustum, SearchResults& outResult)
 {
     if (frustum.Contains(m_bounds) == ContainmentType::Disjoint) { return; }
 
@@ -161,7 +205,7 @@ void AABBOctree::InternalSearch(const BoundingFrustum& frustum, std::vector<OcNo
     }
 }
 
-void AABBOctree::InternalFindNeighbors(const glm::vec3& pos, float radius, float radiusSq, std::vector<OcNode>& outResult)
+void AABBOctree::InternalFindNeighbors(const glm::vec3& pos, float radius, float radiusSq, SearchResults& outResult)
 {
     if (!m_bounds.Contains(pos, radius)) { return; }
     for (const OcNode& node : m_nodes)
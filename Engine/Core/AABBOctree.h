@@ -1,11 +1,15 @@
 #pragma once
 
 #include <memory>
+#include <memory_resource>
 #include <vector>
 
 #include <glm/glm.hpp>
 
 #include "Systems/AABB.h"
+#include "Core/Containers/SmallVector.h"
+#include "Core/JobScheduler/JobContext.h"
+#include "Core/Memory/PoolAllocator.h"
 
 class BoundingFrustum;
 
@@ -18,8 +22,13 @@ struct OcNode
 // template<class T>
 // template<size_t maxSize = 16>
 class AABBOctree
+	: public PoolAllocated<AABBOctree>
 {
 public:
+	// query output, small searches don't allocate and big ones spill to
+	// the job scratch: keep it inside the job or ScratchScope that made it.
+	using SearchResults = SmallVector<OcNode, 64, ScratchAllocator<OcNode>>;
+
 	/*
 	using value_type		= T;
 	using pointer			= T*;
@@ -29,28 +38,37 @@ public:
 	*/
 
 	AABBOctree();
-	AABBOctree(const glm::vec3& position, float halfSize);
+	// every node keeps its points in a list from memory, children inherit it.
+	AABBOctree(const glm::vec3& position, float halfSize, std::pmr::memory_resource* memory = std::pmr::get_default_resource());
 	~AABBOctree();
 
+	// owns its children, so it moves but doesn't copy.
+	AABBOctree(AABBOctree&& other) noexcept;
+	AABBOctree& operator=(AABBOctree&& other) noexcept;
+	AABBOctree(const AABBOctree&) = delete;
+	AABBOctree& operator=(const AABBOctree&) = delete;
+
 	bool Insert(const glm::vec3& pos, size_t index = -1);
-	void FindNeighbors(const glm::vec3& pos, float radius, std::vector<OcNode>& outResult);
-	void Search(const AABB& aabb, std::vector<OcNode>& outResult);
-	void Search(const BoundingFrustum& frustum, std::vector<OcNode>& outResult);
+	void FindNeighbors(const glm::vec3& pos, float radius, SearchResults& outResult);
+	void Search(const AABB& aabb, SearchResults& outResult);
+	void Search(const BoundingFrustum& frustum, SearchResults& outResult);
 
 	void GetAllBoundingBoxes(std::vector<AABB>& outResult);
 	void DebugDraw();
 
 private:
 	void Subdivide();
-	void InternalSearch(const AABB& aabb, std::vector<OcNode>& outResult);
-	void InternalSearch(const BoundingFrustum& frustum, std::vector<OcNode>& outResult);
-	void InternalFindNeighbors(const glm::vec3& pos, float radius, float radiusSq, std::vector<OcNode>& outResult);
+	void ClearChildren();
+	void InternalSearch(const AABB& aabb, SearchResults& outResult);
+	void InternalSearch(const BoundingFrustum& frustum, SearchResults& outResult);
+	void InternalFindNeighbors(const glm::vec3& pos, float radius, float radiusSq, SearchResults& outResult);
 
 private:
 	AABB m_bounds;
 
 	size_t m_maxNodes = 16;
-	std::vector<OcNode> m_nodes;
+	std::pmr::memory_resource* m_memory = nullptr;
+	std::pmr::vector<OcNode> m_nodes;
 
 	AABBOctree* m_child[8];
 };
@@ -2,16 +2,21 @@
 
 #include <algorithm>
 #include <cmath>
+#include <fstream>
+#include <sstream>
 
 #include "States/IGameState.h"
 #include "Resources/Resources.h"
 #include "Scene/Scene.h"
 
 #include "SystemComponents/StatSystemComponent.h"
+#include "Renderer/NullRenderer.h"
 
 #include "Utils/Logger.h"
 #include "Core/Profiler.h"
 #include "Core/JobScheduler/JobScheduler.h"
+#include "Core/Memory/LinearAllocator.h"
+#include "Core/Memory/MemoryTracker.h"
 
 
 Game::Game(IGameState* state)
@@ -24,6 +29,18 @@ Game::Game(IGameState* state)
 	SetState(state);
 }
 
+Game::Game(IGameState* state, const HeadlessParams& headless)
+	: m_isRunning(true)
+	, m_gameState(nullptr)
+	, m_headless(true)
+	, m_headlessParams(headless)
+{
+	LoadConfig();
+
+	InitSystems();
+	SetState(state);
+}
+
 Game::~Game()
 {
 	SaveConfig();
@@ -32,41 +49,83 @@ Game::~Game()
 void Game::InitSystems()
 {
 	srand(static_cast<unsigned int>(time(NULL)));
-
-	m_sdlHandler.Init();
-	m_sdlHandler.OnExitWindow([this]() { m_isRunning = false; });
+	Profiler::GetInstance().SetThreadName("Main");
+#if GAME_PROFILER_STREAM
+	Profiler::GetInstance().StartStreaming("profiler_capture.ptrace");
+#endif
+	// frames past 50ms keep the 5 seconds leading up to them.
+	Profiler::GetInstance().SetSpikeCapture(50.0f, 5.0f);
+
+	if (!m_headless)
+	{
+		m_sdlHandler.Init();
+		m_sdlHandler.OnExitWindow([this]() { m_isRunning = false; });
+	}
 
 	// System Components
 	m_systemComponents = new SystemComponentManager();
 	m_systemComponents->AddComponent<StatSystemComponent>(&m_gameTime);
+	m_statSystem = &m_systemComponents->GetComponent<StatSystemComponent>();
 
 	m_systemComponents->Initialize(this);
 
-	Resources::Init();
+	if (m_headless)
+	{
+		// no GL context: nothing to load, debug lines are built but not drawn.
+		DebugDraw::SetHeadless(true);
+		m_nullRenderer = new NullRenderer();
+		m_renderer = m_nullRenderer;
+	}
+	else
+	{
+		Resources::Init();
 
-	// Physx
-	m_physxHandler.Init();
+		// Physx
+		m_physxHandler.Init();
 
-	m_renderer = new SimpleRenderer();
-	m_renderer->Init();
-	m_renderer->SetRenderSize(m_sdlHandler.GetWindowParams().Width, m_sdlHandler.GetWindowParams().Height);
+		SimpleRenderer* renderer = new SimpleRenderer();
+		renderer->Init();
+		m_renderer = renderer;
+	}
+	if (m_headless)
+	{
+		m_renderer->SetRenderSize(m_headlessParams.width, m_headlessParams.height);
+	}
+	else
+	{
+		m_renderer->SetRenderSize(m_sdlHandler.GetWindowParams().Width, m_sdlHandler.GetWindowParams().Height);
+	}
 
 	JobScheduler::GetInstance().Init();
+
+	BuildFrameGraph();
 }
 
 void Game::CleanupSystems()
 {
 	JobScheduler::GetInstance().Cleanup();
+	// also waits for a spike dump still being written.
+	Profiler::GetInstance().StopStreaming();
+#if !GAME_PROFILER_STREAM
+	Profiler::GetInstance().WriteChromeTrace("profiler_capture.json");
+#endif
 
 	delete m_renderer;
+	m_renderer = nullptr;
+	m_nullRenderer = nullptr;
+
+	m_systemComponents->Cleanup();
 	delete m_systemComponents;
+	m_systemComponents = nullptr;
+	m_statSystem = nullptr;
 
 	Scene::Clear();
-	Resources::Clean();
-
-	m_physxHandler.Cleanup();
+	if (!m_headless)
+	{
+		Resources::Clean();
 
-	m_systemComponents->Cleanup();
+		m_physxHandler.Cleanup();
+	}
 
 	// state cleanup
 	m_gameState->Cleanup();
@@ -90,123 +149,314 @@ void Game::SetState(IGameState* state)
 
 int Game::Execute()
 {
+	if (m_headless)
+	{
+		return ExecuteHeadless();
+	}
+
 	m_gameTime.Init();
-	float accumulator = 0.0f;
+	m_accumulator = 0.0f;
 
 	while (m_isRunning)
 	{
 		PROFILE_SCOPE("UpdateLoop");
 		m_gameTime.Tick();
 
-		const float frameTime = m_gameTime.GetElapsed();
+		// scratch from two frames ago is released here.
+		FrameAllocator::GetInstance().BeginFrame();
+
+		m_frameTime = m_gameTime.GetElapsed();
 		const float updateRate = m_gameTime.GetUpdateRate();
-		accumulator += frameTime;
+		m_accumulator += m_frameTime;
+
+		// Handle Updates at Fixed Update Rate
+		// if update rate is 60fps, and frame time is 30fps.
+		// accumulator 33ms, update rate, 16ms.
+		// 1 update -> accumulator 33-16=17.
+		// 2 update -> accumulator 17-16=1
+		// no update 3 because accumulator = 1 < 16 ( update Rate )
+		// we'll update twice, before rendering a new frame.
+		m_fixedSteps = 0;
+		while (m_accumulator >= updateRate)
+		{
+			++m_fixedSteps;
+			m_accumulator -= updateRate;
+		}
+
+		m_frameGraph.Run();
+
+		MemoryTracker::GetInstance().EndFrame();
+		PROFILE_COUNTER("Allocated Bytes", MemoryTracker::GetInstance().GetTotalFrameBytes());
+		Profiler::GetInstance().EndFrame(static_cast<float>(m_frameTime * 1000.0));
+	}
+
+	CleanupSystems();
+
+	return 0;
+}
+
+int Game::ExecuteHeadless()
+{
+	m_gameTime.Init();
+	m_frameTimings.clear();
+	m_frameTimings.reserve(static_cast<size_t>(std::max(m_headlessParams.frames, 0)));
+
+	// no wall clock, every frame is exactly one fixed step.
+	m_frameTime = static_cast<float>(m_gameTime.GetUpdateRate());
+	m_accumulator = 0.0f;
+	m_fixedSteps = 1;
+
+	for (int frame = 0; frame < m_headlessParams.frames && m_isRunning; ++frame)
+	{
+		PROFILE_SCOPE("UpdateLoop");
+
+		// scratch from two frames ago is released here.
+		FrameAllocator::GetInstance().BeginFrame();
 
-		// System Components PreUpdate
-		m_systemComponents->PreUpdate(frameTime);
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		m_frameGraph.Run();
+		const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
 
+		MemoryTracker::GetInstance().EndFrame();
+		PROFILE_COUNTER("Allocated Bytes", MemoryTracker::GetInstance().GetTotalFrameBytes());
+
+		FrameTiming timing;
+		timing.frameMs = std::chrono::duration<float, std::milli>(end - start).count();
+		for (TaskGraph::NodeId node = 0; node < m_frameGraph.Size(); ++node)
 		{
-			PROFILE_SCOPE("HandleInput");
-			// Handle Input
-			SDL_Event event;
-			while (SDL_PollEvent(&event))
+			timing.nodeMs.push_back(static_cast<float>(m_frameGraph.GetTiming(node).DurationMs()));
+		}
+		timing.renderCommands = m_nullRenderer->GetLastFrameCommands();
+		Profiler::GetInstance().EndFrame(timing.frameMs);
+		m_frameTimings.push_back(std::move(timing));
+	}
+
+	const bool written = WriteHeadlessReport(m_headlessParams.reportPath);
+	if (!written)
+	{
+		LOG_ERROR("Headless report could not be written to %s", m_headlessParams.reportPath.c_str());
+	}
+	CleanupSystems();
+
+	return written ? 0 : 1;
+}
+
+bool Game::WriteHeadlessReport(const std::string& path) const
+{
+	std::ofstream file(path, std::ios_base::out | std::ios_base::trunc);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	// nearest rank percentiles of one column, frame time is column -1.
+	auto summary = [this](int column) {
+		std::vector<float> values;
+		values.reserve(m_frameTimings.size());
+		for (const FrameTiming& timing : m_frameTimings)
+		{
+			values.push_back(column < 0 ? timing.frameMs : timing.nodeMs[column]);
+		}
+		std::sort(values.begin(), values.end());
+
+		std::stringstream stream;
+		if (values.empty())
+		{
+			stream << "{ }";
+			return stream.str();
+		}
+
+		float total = 0.0f;
+		for (float value : values) { total += value; }
+		auto percentile = [&values](float percent) {
+			const size_t rank = static_cast<size_t>(std::ceil(percent * values.size()));
+			return values[std::min(std::max(rank, size_t(1)), values.size()) - 1];
+		};
+		stream << "{ \"meanMs\": " << total / values.size()
+			<< ", \"p50Ms\": " << percentile(0.50f)
+			<< ", \"p95Ms\": " << percentile(0.95f)
+			<< ", \"p99Ms\": " << percentile(0.99f)
+			<< ", \"maxMs\": " << values.back() << " }";
+		return stream.str();
+	};
+
+	const int nodeCount = static_cast<int>(m_frameGraph.Size());
+	file << "{\n  \"frames\": " << m_frameTimings.size()
+		<< ",\n  \"updateRateMs\": " << m_gameTime.GetUpdateRate() * 1000.0
+		<< ",\n  \"summary\": {\n    \"Frame\": " << summary(-1);
+	for (int node = 0; node < nodeCount; ++node)
+	{
+		file << ",\n    \"" << m_frameGraph.GetName(node) << "\": " << summary(node);
+	}
+	file << "\n  },\n  \"frameTimings\": [\n";
+
+	for (size_t frame = 0; frame < m_frameTimings.size(); ++frame)
+	{
+		const FrameTiming& timing = m_frameTimings[frame];
+		file << "    { \"frame\": " << frame << ", \"frameMs\": " << timing.frameMs
+			<< ", \"renderCommands\": " << timing.renderCommands;
+		for (int node = 0; node < nodeCount; ++node)
+		{
+			file << ", \"" << m_frameGraph.GetName(node) << "Ms\": " << timing.nodeMs[node];
+		}
+		file << " }" << (frame + 1 < m_frameTimings.size() ? ",\n" : "\n");
+	}
+	file << "  ]\n}\n";
+	return true;
+}
+
+void Game::BuildFrameGraph()
+{
+	m_frameGraph.Clear();
+
+	// SDL has to be polled on the thread that created the window.
+	const TaskGraph::NodeId input = m_frameGraph.AddNode("Input", [this]() {
+		HandleInput();
+		}, TaskAffinity::MainThread);
+
+	// System Components PreUpdate, only frame stats for now. After input,
+	// the stats hotkeys write the game time's pause flag that PreUpdate reads.
+	// A few counters, not worth the hop to a worker.
+	const TaskGraph::NodeId stats = m_frameGraph.AddNode("Stats", [this]() {
+		m_systemComponents->PreUpdate(m_frameTime);
+		}, TaskAffinity::MainThread, { input });
+
+	// drains the profiler rings into the scope stats, on a worker beside
+	// Input, Update and Behaviors. Nothing reads them before Render.
+	const TaskGraph::NodeId profilerStats = m_frameGraph.AddNode("ProfilerStats", [this]() {
+		m_statSystem->UpdateProfilerStats();
+		}, TaskAffinity::Any);
+
+	const TaskGraph::NodeId physics = m_frameGraph.AddNode("Physics", [this]() {
+#if GAME_PHYSX_TICK
+		if (!m_gameTime.IsPaused() && !m_headless)
+		{
+			for (int i = 0; i < m_fixedSteps; ++i)
 			{
-				// Handle Input
-				m_sdlHandler.HandleEvents(&event);
-
-				switch (event.type)
-				{
-				case SDL_KEYDOWN:
-					switch (event.key.keysym.sym)
-					{
-						break;
-					case SDLK_ESCAPE:
-						m_isRunning = false;
-						break;
-					default: break;
-					}
-					break;
-				default: break;
-				}
-
-				// System Components Handle Input
-				m_systemComponents->HandleInput(&event);
-
-				m_gameState->HandleInput(&event);
+				m_physxHandler.Tick(m_gameTime.GetUpdateRate());
 			}
 		}
+#endif
+		}, TaskAffinity::Any, { input });
+
+	const TaskGraph::NodeId update = m_frameGraph.AddNode("Update", [this]() {
+		FixedUpdate();
+		}, TaskAffinity::MainThread, { stats });
+
+	const TaskGraph::NodeId behaviors = m_frameGraph.AddNode("Behaviors", [this]() {
+		PROFILE_SCOPE("Behaviors");
+		// amortized work, whatever doesn't fit the budget carries over.
+		JobScheduler::GetInstance().Run(m_behaviorBudgetMs);
+		}, TaskAffinity::MainThread, { update });
+
+	m_frameGraph.AddNode("Render", [this]() {
+		Render();
+		}, TaskAffinity::MainThread, { physics, profilerStats, update, behaviors });
+}
 
+void Game::HandleInput()
+{
+	PROFILE_SCOPE("HandleInput");
+	if (m_headless)
+	{
+		return;
+	}
+
+	// Handle Input
+	SDL_Event event;
+	while (SDL_PollEvent(&event))
+	{
+		// Handle Input
+		m_sdlHandler.HandleEvents(&event);
+
+		switch (event.type)
 		{
-			PROFILE_SCOPE("Update");
-
-			// Handle Updates at Fixed Update Rate
-			// if update rate is 60fps, and frame time is 30fps.
-			// accumulator 33ms, update rate, 16ms.
-			// 1 update -> accumulator 33-16=17.
-			// 2 update -> accumulator 17-16=1
-			// no update 3 because accumulator = 1 < 16 ( update Rate )
-			// we'll update twice, before rendering a new frame.
-			while (accumulator >= updateRate)
+		case SDL_KEYDOWN:
+			switch (event.key.keysym.sym)
 			{
-                // physx tick
-                // m_physxHandler.Tick(m_deltaTime);
-
-                // window Update
-                m_sdlHandler.Update(updateRate);
-
-				if (m_gameTime.IsPaused()) 
-				{
-					// system components
-					m_systemComponents->UpdatePaused(updateRate);
-
-					// Update
-					m_gameState->UpdatePaused(updateRate);
-				}
-				else
-				{
-                    // system components
-                    m_systemComponents->Update(updateRate);
-
-                    // Update
-                    m_gameState->Update(updateRate);
-				}
-
-				accumulator -= updateRate;
+				break;
+			case SDLK_ESCAPE:
+				m_isRunning = false;
+				break;
+			default: break;
 			}
+			break;
+		default: break;
 		}
 
+		// System Components Handle Input
+		m_systemComponents->HandleInput(&event);
 
-		// Handle Rendering
-		const float alpha = accumulator / updateRate;
+		m_gameState->HandleInput(&event);
+	}
+}
+
+void Game::FixedUpdate()
+{
+	PROFILE_SCOPE("Update");
 
-		// Render
+	const float updateRate = m_gameTime.GetUpdateRate();
+	for (int i = 0; i < m_fixedSteps; ++i)
+	{
+		// window Update
+		if (!m_headless)
 		{
-			PROFILE_SCOPE("RenderLoop");
-			m_sdlHandler.BeginRender();
-			m_systemComponents->Render(alpha);
-			m_gameState->Render(alpha);
+			m_sdlHandler.Update(updateRate);
+		}
 
-			// ui
-			{
-				PROFILE_SCOPE("RenderUI");
-				m_sdlHandler.BeginUIRender();
-				m_systemComponents->RenderUI();
-				m_gameState->RenderUI();
-				m_sdlHandler.EndUIRender();
-			}
+		if (m_gameTime.IsPaused()) 
+		{
+			// system components
+			m_systemComponents->UpdatePaused(updateRate);
 
-			m_sdlHandler.EndRender();
+			// Update
+			m_gameState->UpdatePaused(updateRate);
+		}
+		else
+		{
+			// system components
+			m_systemComponents->Update(updateRate);
+
+			// Update
+			m_gameState->Update(updateRate);
 		}
 	}
+}
 
-	CleanupSystems();
+void Game::Render()
+{
+	// Handle Rendering
+	const float alpha = m_accumulator / m_gameTime.GetUpdateRate();
 
-	return 0;
+	PROFILE_SCOPE("RenderLoop");
+	if (m_headless)
+	{
+		// render prep only, the NullRenderer and DebugDraw drop the draws.
+		m_systemComponents->Render(alpha);
+		m_gameState->Render(alpha);
+		return;
+	}
+
+	m_sdlHandler.BeginRender();
+	m_systemComponents->Render(alpha);
+	m_gameState->Render(alpha);
+
+	// ui
+	{
+		PROFILE_SCOPE("RenderUI");
+		m_sdlHandler.BeginUIRender();
+		m_systemComponents->RenderUI();
+		m_gameState->RenderUI();
+		m_sdlHandler.EndUIRender();
+	}
+
+	m_sdlHandler.EndRender();
 }
 
 void Game::LoadConfig()
 {
-
+	// optional, tags without a line have no budget.
+	MemoryTracker::GetInstance().LoadBudgets("memory_budgets.txt");
 }
 
 void Game::SaveConfig()
@@ -2,6 +2,8 @@
 
 #include <memory>
 #include <chrono>
+#include <string>
+#include <vector>
 
 #include "Camera/FlyCamera.h"
 #include "Renderer/SimpleRenderer.h"
@@ -9,29 +11,72 @@
 #include "Systems/GameTime.h"
 #include "Window/SDLHandler.h"
 #include "PhysxHandler.h"
+#include "Core/JobScheduler/TaskGraph.h"
+
+// step PhysX from the frame graph, off the main thread.
+#define GAME_PHYSX_TICK 0
+
+// stream the whole session to profiler_capture.ptrace instead of writing
+// the rings as JSON on exit. Spikes are dumped either way.
+#define GAME_PROFILER_STREAM 0
 
 class IGameState;
+class NullRenderer;
+class StatSystemComponent;
 class WindowParams;
 
+// A run without window, GPU or PhysX for perf harnesses: a NullRenderer,
+// frames fixed steps apart run back to back, then every frame's stage
+// timings go to reportPath as JSON. Execute returns non-zero when the
+// report can't be written.
+struct HeadlessParams
+{
+	int frames = 600;
+	// render targets are sized as if a window of this size was open.
+	int width = 800;
+	int height = 600;
+	std::string reportPath = "headless_report.json";
+};
+
 class Game
 {
 public:
 	Game(IGameState* state);
+	Game(IGameState* state, const HeadlessParams& headless);
 	~Game();
 
 	void SetState(IGameState* state);
 	int Execute();
 
 	SDLHandler* GetSDLHandler() { return &m_sdlHandler; }
-	SimpleRenderer* GetRenderer() { return m_renderer; }
+	IRenderer* GetRenderer() { return m_renderer; }
 	PhysXHandler* GetPhysX() { return &m_physxHandler; }
 	SystemComponentManager* GetSystemComponentManager() { return m_systemComponents; }
+	const TaskGraph& GetFrameGraph() const { return m_frameGraph; }
 
 	TimePrecision GetTotalTime() const { return m_gameTime.GetTotalTime(); }
+	bool IsHeadless() const { return m_headless; }
 
 private:
+	// one frame of a headless run, in milliseconds.
+	struct FrameTiming
+	{
+		float frameMs = 0.0f;
+		// per frame graph node, in node order.
+		std::vector<float> nodeMs;
+		int renderCommands = 0;
+	};
+
 	void InitSystems();
 	void CleanupSystems();
+	void BuildFrameGraph();
+
+	int ExecuteHeadless();
+	bool WriteHeadlessReport(const std::string& path) const;
+
+	void HandleInput();
+	void FixedUpdate();
+	void Render();
 
 	void LoadConfig();
 	void SaveConfig();
@@ -41,12 +86,28 @@ private:
 
 	GameTime m_gameTime;
 
-	SimpleRenderer* m_renderer = {};
+	// per frame time slice for JobScheduler behaviors.
+	float m_behaviorBudgetMs = 2.0f;
+
+	// stages of one frame, see BuildFrameGraph.
+	TaskGraph m_frameGraph;
+	float m_frameTime = 0.0f;
+	float m_accumulator = 0.0f;
+	int m_fixedSteps = 0;
+
+	IRenderer* m_renderer = {};
 	// Renderer* m_renderer = {};
 	IGameState* m_gameState = {};
 	SDLHandler m_sdlHandler = {};
 	PhysXHandler m_physxHandler = {};
 
 	SystemComponentManager* m_systemComponents = {};
+	// owned by m_systemComponents, its profiler stats update off the main thread.
+	StatSystemComponent* m_statSystem = {};
+
+	bool m_headless = false;
+	HeadlessParams m_headlessParams;
+	NullRenderer* m_nullRenderer = {};
+	std::vector<FrameTiming> m_frameTimings;
 };
 
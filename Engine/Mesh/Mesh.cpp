@@ -148,6 +148,7 @@ void Mesh::Finalize(bool interleaved)
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, Indices.size() * sizeof(unsigned int), &Indices[0], GL_STATIC_DRAW);
 	}
+	m_gpuMemory.Set(data.size() * sizeof(float) + Indices.size() * sizeof(unsigned int));
 	if (interleaved)
 	{
 		// calculate stride from number of non-empty vertex attribute arrays
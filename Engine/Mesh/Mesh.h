@@ -6,6 +6,8 @@
 #define GLM_FORCE_SWIZZLE
 #include <glm/glm.hpp>
 
+#include "Core/Memory/MemoryTracker.h"
+
 static const float PI = 3.14159265359f;
 #ifndef TAU
 static const float TAU = 2.0f * PI;
@@ -54,5 +56,9 @@ public:
 	unsigned int m_vao = 0;
 	unsigned int m_vbo = 0;
 	unsigned int m_ebo = 0;
+
+private:
+	// vertex and index buffer bytes given to the driver by Finalize.
+	TrackedBytes m_gpuMemory{ MemoryTag::Meshes };
 };
 
@@ -43,15 +43,8 @@ void CommandBuffer::Push(Mesh* mesh, Material* material, glm::mat4 transform, gl
 		}
 		else if (material->Type == MATERIAL_CUSTOM)
 		{
-			// check if this render target has been pushed before, if so add to vector, 
-			// otherwise create new vector with this render target.
-			if (m_CustomRenderCommands.find(target) != m_CustomRenderCommands.end())
-				m_CustomRenderCommands[target].push_back(command);
-			else
-			{
-				m_CustomRenderCommands[target] = std::vector<RenderCommand>();
-				m_CustomRenderCommands[target].push_back(command);
-			}
+			// the first push to a render target creates its list, on the map's memory resource.
+			m_CustomRenderCommands[target].push_back(command);
 		}
 		else if (material->Type == MATERIAL_POST_PROCESS)
 		{
@@ -120,11 +113,11 @@ void CommandBuffer::Sort()
 	}
 }
 
-std::vector<RenderCommand> CommandBuffer::GetDeferredRenderCommands(bool cull)
+RenderCommandList CommandBuffer::GetDeferredRenderCommands(bool cull)
 {
 	if (cull)
 	{
-		std::vector<RenderCommand> commands;
+		RenderCommandList commands(&FrameMemoryResource::GetInstance());
 		for (auto it = m_DeferredRenderCommands.begin(); it != m_DeferredRenderCommands.end(); ++it)
 		{
 			RenderCommand command = *it;
@@ -136,16 +129,16 @@ std::vector<RenderCommand> CommandBuffer::GetDeferredRenderCommands(bool cull)
 	}
 	else
 	{
-		return m_DeferredRenderCommands;
+		return RenderCommandList(m_DeferredRenderCommands, &FrameMemoryResource::GetInstance());
 	}
 }
 
-std::vector<RenderCommand> CommandBuffer::GetCustomRenderCommands(RenderTarget* target, bool cull)
+RenderCommandList CommandBuffer::GetCustomRenderCommands(RenderTarget* target, bool cull)
 {
 	// only cull when on main/null render target
 	if (target == nullptr && cull)
 	{
-		std::vector<RenderCommand> commands;
+		RenderCommandList commands(&FrameMemoryResource::GetInstance());
 		for (auto it = m_CustomRenderCommands[target].begin(); it != m_CustomRenderCommands[target].end(); ++it)
 		{
 			RenderCommand command = *it;
@@ -157,15 +150,15 @@ std::vector<RenderCommand> CommandBuffer::GetCustomRenderCommands(RenderTarget*
 	}
 	else
 	{
-		return m_CustomRenderCommands[target];
+		return RenderCommandList(m_CustomRenderCommands[target], &FrameMemoryResource::GetInstance());
 	}
 }
 
-std::vector<RenderCommand> CommandBuffer::GetAlphaRenderCommands(bool cull)
+RenderCommandList CommandBuffer::GetAlphaRenderCommands(bool cull)
 {
 	if (cull)
 	{
-		std::vector<RenderCommand> commands;
+		RenderCommandList commands(&FrameMemoryResource::GetInstance());
 		for (auto it = m_AlphaRenderCommands.begin(); it != m_AlphaRenderCommands.end(); ++it)
 		{
 			RenderCommand command = *it;
@@ -177,18 +170,18 @@ std::vector<RenderCommand> CommandBuffer::GetAlphaRenderCommands(bool cull)
 	}
 	else
 	{
-		return m_AlphaRenderCommands;
+		return RenderCommandList(m_AlphaRenderCommands, &FrameMemoryResource::GetInstance());
 	}
 }
 
-std::vector<RenderCommand> CommandBuffer::GetPostProcessingRenderCommands()
+RenderCommandList CommandBuffer::GetPostProcessingRenderCommands()
 {
-	return m_PostProcessingRenderCommands;
+	return RenderCommandList(m_PostProcessingRenderCommands, &FrameMemoryResource::GetInstance());
 }
 
-std::vector<RenderCommand> CommandBuffer::GetShadowCastRenderCommands()
+RenderCommandList CommandBuffer::GetShadowCastRenderCommands()
 {
-	std::vector<RenderCommand> commands;
+	RenderCommandList commands(&FrameMemoryResource::GetInstance());
 	for (auto it = m_DeferredRenderCommands.begin(); it != m_DeferredRenderCommands.end(); ++it)
 	{
 		if (it->Material->ShadowCast)
@@ -1,7 +1,11 @@
 #pragma once
 #include "RenderCommand.h"
 
+#include "Core/Memory/MemoryResource.h"
+#include "Core/Memory/MemoryTracker.h"
+
 #include <map>
+#include <memory_resource>
 #include <vector>
 
 
@@ -10,6 +14,8 @@ class Mesh;
 class Material;
 class RenderTarget;
 
+using RenderCommandList = std::pmr::vector<RenderCommand>;
+
 class CommandBuffer
 {
 public:
@@ -17,10 +23,14 @@ public:
 private:
 	Renderer* m_Renderer;
 
-	std::vector<RenderCommand> m_DeferredRenderCommands;
-	std::vector<RenderCommand> m_AlphaRenderCommands;
-	std::vector<RenderCommand> m_PostProcessingRenderCommands;
-	std::map<RenderTarget*, std::vector<RenderCommand>> m_CustomRenderCommands;
+	// the lists keep their capacity between frames, the per target map is
+	// rebuilt every frame, so its nodes and lists come out of a pool.
+	PoolMemoryResource m_Memory{ TrackedMemoryResource::Get(MemoryTag::Rendering) };
+
+	RenderCommandList m_DeferredRenderCommands{ &m_Memory };
+	RenderCommandList m_AlphaRenderCommands{ &m_Memory };
+	RenderCommandList m_PostProcessingRenderCommands{ &m_Memory };
+	std::pmr::map<RenderTarget*, RenderCommandList> m_CustomRenderCommands{ &m_Memory };
 
 
 public:
@@ -36,22 +46,25 @@ public:
 	// sorts the command buffer; first by shader, then by texture bind.
 	void Sort();
 
+	// the Get functions return lists allocated from the FrameMemoryResource, they're
+	// meant to be issued and dropped within the frame.
+
 	// returns the list of render commands. For minimizing state changes it is advised to first 
 	// call Sort() before retrieving and issuing the render commands.
-	std::vector<RenderCommand> GetDeferredRenderCommands(bool cull = false);
+	RenderCommandList GetDeferredRenderCommands(bool cull = false);
 
 	// returns the list of render commands of both deferred and forward pushes that require 
 	// alpha blending; which have to be rendered last. 
-	std::vector<RenderCommand> GetAlphaRenderCommands(bool cull = false);
+	RenderCommandList GetAlphaRenderCommands(bool cull = false);
 
 	// returns the list of custom render commands per render target.
-	std::vector<RenderCommand> GetCustomRenderCommands(RenderTarget* target, bool cull = false);
+	RenderCommandList GetCustomRenderCommands(RenderTarget* target, bool cull = false);
 
 	// returns the list of post-processing render commands.
-	std::vector<RenderCommand> GetPostProcessingRenderCommands();
+	RenderCommandList GetPostProcessingRenderCommands();
 
 	// returns the list of all render commands with mesh shadow casting
-	std::vector<RenderCommand> GetShadowCastRenderCommands();
+	RenderCommandList GetShadowCastRenderCommands();
 };
 
 
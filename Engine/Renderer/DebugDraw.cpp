@@ -2,6 +2,7 @@
 #include "DebugDraw.h"
 
 #include "Utils/Logger.h"
+#include "Core/Memory/MemoryResource.h"
 
 #include <glm/glm.hpp>
 #include <GL/glew.h>
@@ -24,8 +25,13 @@ namespace DebugDraw
 	GLint m_viewProjecLoc = -1;
 
 	size_t m_linesAdded = 0;
-	std::vector<Line> m_lines;
-	std::vector<float> m_scratchPadLineData;
+
+	bool m_headless = false;
+
+	// the line list and its upload copy in one block, sized for MAX_APG_GL_DB_LINES.
+	LinearMemoryResource m_lineMemory(MAX_APG_GL_DB_LINES * (sizeof(Line) + 14 * sizeof(float)) + 2 * alignof(std::max_align_t));
+	std::pmr::vector<Line> m_lines{ &m_lineMemory };
+	std::pmr::vector<float> m_scratchPadLineData{ &m_lineMemory };
 
 	void _print_shader_info_log(unsigned int shader_index) {
 		int max_length = 2048;
@@ -69,7 +75,19 @@ namespace DebugDraw
 
 	//
 	// reserve memory for drawing stuff
+	void SetHeadless(bool headless)
+	{
+		m_headless = headless;
+	}
+
 	bool Init() {
+		if (m_headless)
+		{
+			m_scratchPadLineData.resize(MAX_APG_GL_DB_LINES * 14);
+			m_lines.resize(MAX_APG_GL_DB_LINES);
+			return true;
+		}
+
 		// vao for drawing properties of lines
 		glGenVertexArrays(1, &m_linesVAO);
 		glBindVertexArray(m_linesVAO);
@@ -129,6 +147,10 @@ namespace DebugDraw
 	//
 	// free memory
 	void Clean() {
+		if (m_headless)
+		{
+			return;
+		}
 		glDeleteBuffers(1, &m_linesVBO);
 		glDeleteVertexArrays(1, &m_linesVAO);
 		// attached shaders have prev been flagged to delete so will also be deleted
@@ -393,6 +415,10 @@ namespace DebugDraw
 	// world coord space
 	// matrix is a 16 float column-major matrix as 1d array in column order
 	void Update(const glm::mat4& viewProj) {
+		if (m_headless)
+		{
+			return;
+		}
 		glUseProgram(m_linesShader);
 		glUniformMatrix4fv(m_viewProjecLoc, 1, GL_FALSE, &viewProj[0][0]);
 	}
@@ -423,6 +449,12 @@ namespace DebugDraw
 			m_scratchPadLineData[floatIndex++] = l.col.a;
 		}
 
+		// the lines are built either way, only the upload and draw need GL.
+		if (m_headless)
+		{
+			return;
+		}
+
 		GLintptr offset = sizeof(float) * m_scratchPadLineData.size() * 0;
 		GLsizei size = sizeof(float) * m_scratchPadLineData.size();
 		glBindBuffer(GL_ARRAY_BUFFER, m_linesVBO);
@@ -46,6 +46,10 @@ namespace DebugDraw
 	};
 	
 
+	// no GL calls at all, lines are still collected. Before Init, for runs
+	// without a GL context.
+	void SetHeadless(bool headless);
+
 	bool Init();
 	
 	void Clear();
@@ -2,10 +2,35 @@
 
 #include <string>
 
+#include <glm/glm.hpp>
+
+class Camera;
+class DirectionalLight;
 class Material;
+class Mesh;
+class SceneNode;
+class Shader;
 
+// What states and Game drive a renderer through, SimpleRenderer on a
+// window or NullRenderer headless.
 class IRenderer
 {
 public:
+	virtual ~IRenderer() = default;
+
+	virtual void SetCamera(Camera* camera) = 0;
+	virtual void SetRenderSize(int width, int height) = 0;
+	virtual int GetRenderWidth() const = 0;
+	virtual int GetRenderHeight() const = 0;
+
 	virtual Material* CreateMaterial(std::string base = "default-fwd") = 0;
-};
\ No newline at end of file
+	virtual Material* CreateCustomMaterial(Shader* shader) = 0;
+	virtual Material* CreatePostProcessingMaterial(Shader* shader) = 0;
+
+	virtual void PushRender(Mesh* mesh, Material* material, glm::mat4 transform = glm::mat4(1.0f), glm::mat4 prevTransform = glm::mat4(1.0f)) = 0;
+	virtual void PushRender(SceneNode* node) = 0;
+	virtual void AddLight(DirectionalLight* light) = 0;
+
+	virtual void RenderPushedCommands() = 0;
+	virtual void RenderUIMenu() = 0;
+};
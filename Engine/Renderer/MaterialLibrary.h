@@ -17,7 +17,7 @@ class MaterialLibrary
 	friend SimpleRenderer;
 private:
 	// holds a list of default material templates that other materials can derive from
-	std::map<unsigned int, Material*> m_DefaultMaterials;
+	std::map<size_t, Material*> m_DefaultMaterials;
 	// stores all generated/copied materials
 	std::vector<Material*> m_Materials;
 
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "IRenderer.h"
+
+// Takes everything a state pushes and draws nothing, for headless runs
+// without a window or GPU. Materials aren't created, states that need one
+// at Init don't run headless.
+class NullRenderer
+	: public IRenderer
+{
+public:
+	void SetCamera(Camera* camera) override { m_camera = camera; }
+	void SetRenderSize(int width, int height) override
+	{
+		m_width = width > 0 ? width : 1;
+		m_height = height > 0 ? height : 1;
+	}
+	int GetRenderWidth() const override { return m_width; }
+	int GetRenderHeight() const override { return m_height; }
+
+	Material* CreateMaterial(std::string base = "default-fwd") override { return nullptr; }
+	Material* CreateCustomMaterial(Shader* shader) override { return nullptr; }
+	Material* CreatePostProcessingMaterial(Shader* shader) override { return nullptr; }
+
+	void PushRender(Mesh* mesh, Material* material, glm::mat4 transform = glm::mat4(1.0f), glm::mat4 prevTransform = glm::mat4(1.0f)) override { ++m_pushedCommands; }
+	void PushRender(SceneNode* node) override { ++m_pushedCommands; }
+	void AddLight(DirectionalLight* light) override {}
+
+	void RenderPushedCommands() override
+	{
+		m_lastFrameCommands = m_pushedCommands;
+		m_pushedCommands = 0;
+	}
+	void RenderUIMenu() override {}
+
+	// commands pushed before the last RenderPushedCommands.
+	int GetLastFrameCommands() const { return m_lastFrameCommands; }
+
+private:
+	Camera* m_camera = nullptr;
+	int m_width = 1280;
+	int m_height = 720;
+	int m_pushedCommands = 0;
+	int m_lastFrameCommands = 0;
+};
@@ -268,7 +268,7 @@ void Renderer::RenderPushedCommands()
 	m_GLCache.SetDepthFunc(GL_LESS);
 
 	// 1. Geometry buffer
-	std::vector<RenderCommand> deferredRenderCommands = m_CommandBuffer->GetDeferredRenderCommands(true);
+	RenderCommandList deferredRenderCommands = m_CommandBuffer->GetDeferredRenderCommands(true);
 	glViewport(0, 0, m_RenderSize.x, m_RenderSize.y);
 	glBindFramebuffer(GL_FRAMEBUFFER, m_GBuffer->ID);
 	unsigned int attachments[4] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3 };
@@ -291,7 +291,7 @@ void Renderer::RenderPushedCommands()
 	if (Shadows)
 	{
 		m_GLCache.SetCullFace(GL_FRONT);
-		std::vector<RenderCommand> shadowRenderCommands = m_CommandBuffer->GetShadowCastRenderCommands();
+		RenderCommandList shadowRenderCommands = m_CommandBuffer->GetShadowCastRenderCommands();
 		m_ShadowViewProjections.clear();
 
 		size_t shadowRtIndex = 0;
@@ -404,7 +404,7 @@ void Renderer::RenderPushedCommands()
 		}
 
 		// sort all render commands and retrieve the sorted array
-		std::vector<RenderCommand> renderCommands = m_CommandBuffer->GetCustomRenderCommands(renderTarget);
+		RenderCommandList renderCommands = m_CommandBuffer->GetCustomRenderCommands(renderTarget);
 
 		// terate over all the render commands and execute
 		m_GLCache.SetPolygonMode(Wireframe ? GL_LINE : GL_FILL);
@@ -418,7 +418,7 @@ void Renderer::RenderPushedCommands()
 	// 7. alpha material pass
 	glViewport(0, 0, m_RenderSize.x, m_RenderSize.y);
 	glBindFramebuffer(GL_FRAMEBUFFER, m_CustomTarget->ID);
-	std::vector<RenderCommand> alphaRenderCommands = m_CommandBuffer->GetAlphaRenderCommands(true);
+	RenderCommandList alphaRenderCommands = m_CommandBuffer->GetAlphaRenderCommands(true);
 	for (unsigned int i = 0; i < alphaRenderCommands.size(); ++i)
 	{
 		renderCustomCommand(&alphaRenderCommands[i], nullptr);
@@ -477,7 +477,7 @@ void Renderer::RenderPushedCommands()
 	}
 #endif
 	// 10. custom post-processing pass
-	std::vector<RenderCommand> postProcessingCommands = m_CommandBuffer->GetPostProcessingRenderCommands();
+	RenderCommandList postProcessingCommands = m_CommandBuffer->GetPostProcessingRenderCommands();
 	for (unsigned int i = 0; i < postProcessingCommands.size(); ++i)
 	{
 		// ping-pong between render textures
@@ -577,7 +577,7 @@ void Renderer::BakeProbes(SceneNode* scene)
 		sceneStack.pop();
 		if (node->Mesh)
 		{
-			auto samplerUniforms = *(node->Material->GetSamplerUniforms());
+			SamplerUniformMap& samplerUniforms = *(node->Material->GetSamplerUniforms());
 			if (samplerUniforms.find("TexAlbedo") != samplerUniforms.end())
 			{
 				materials.push_back(new Material(m_PBR->m_ProbeCaptureShader));
@@ -608,7 +608,7 @@ void Renderer::BakeProbes(SceneNode* scene)
 			sceneStack.push(node->GetChildByIndex(i));
 	}
 	commandBuffer.Sort();
-	std::vector<RenderCommand> renderCommands = commandBuffer.GetCustomRenderCommands(nullptr);
+	RenderCommandList renderCommands = commandBuffer.GetCustomRenderCommands(nullptr);
 
 	m_PBR->ClearIrradianceProbes();
 	for (unsigned int i = 0; i < m_ProbeSpatials.size(); ++i)
@@ -746,12 +746,12 @@ void Renderer::renderToCubemap(SceneNode* scene,
 			childStack.push(child->GetChildByIndex(i));
 	}
 	commandBuffer.Sort();
-	std::vector<RenderCommand> renderCommands = commandBuffer.GetCustomRenderCommands(nullptr);
+	RenderCommandList renderCommands = commandBuffer.GetCustomRenderCommands(nullptr);
 
 	renderToCubemap(renderCommands, target, position, mipLevel);
 }
 
-void Renderer::renderToCubemap(std::vector<RenderCommand>& renderCommands, TextureCube* target, glm::vec3 position, unsigned int mipLevel)
+void Renderer::renderToCubemap(RenderCommandList& renderCommands, TextureCube* target, glm::vec3 position, unsigned int mipLevel)
 {
 	// define 6 camera directions/lookup vectors
 	Camera faceCameras[6] = {
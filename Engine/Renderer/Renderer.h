@@ -127,7 +127,7 @@ private:
 	void renderCustomCommand(RenderCommand* command, Camera* customCamera, bool updateGLSettings = true);
 	// renderer-specific logic for rendering a list of commands to a target cubemap
 	void renderToCubemap(SceneNode* scene, TextureCube* target, glm::vec3 position = glm::vec3(0.0f), unsigned int mipLevel = 0);
-	void renderToCubemap(std::vector<RenderCommand>& renderCommands, TextureCube* target, glm::vec3 position = glm::vec3(0.0f), unsigned int mipLevel = 0);
+	void renderToCubemap(RenderCommandList& renderCommands, TextureCube* target, glm::vec3 position = glm::vec3(0.0f), unsigned int mipLevel = 0);
 	// minimal render logic to render a mesh 
 	void renderMesh(Mesh* mesh, Shader* shader);
 	// updates the global uniform buffer objects
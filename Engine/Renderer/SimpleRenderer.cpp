@@ -12,6 +12,8 @@
 #include "RenderTarget.h"
 
 #include "Utils/Logger.h"
+#include "Utils/Utils.h"
+#include "Core/Profiler.h"
 #include "DebugDraw.h"
 
 #include <stack>
@@ -19,6 +21,17 @@
 
 #define ENABLE_GLSTATE_CACHE 1
 
+namespace
+{
+	// built-in uniforms set on every draw, hashed once.
+	const size_t kViewHash = Utils::Hash("view");
+	const size_t kProjectionHash = Utils::Hash("projection");
+	const size_t kCamPosHash = Utils::Hash("CamPos");
+	const size_t kShadowsEnabledHash = Utils::Hash("ShadowsEnabled");
+	const size_t kModelHash = Utils::Hash("model");
+	const size_t kPrevModelHash = Utils::Hash("prevModel");
+}
+
 SimpleRenderer::~SimpleRenderer()
 {
 	delete m_materialLibrary;
@@ -162,6 +175,9 @@ void SimpleRenderer::RenderPushedCommands()
 	const glm::mat4 projection = m_camera->GetProjection();
 	const glm::vec3 cameraPosition = m_camera->GetPosition();
 
+	PROFILE_COUNTER("Render Commands", m_renderCommands.size());
+	size_t culledCommands = 0;
+
 	std::vector<RenderCommand> transparents;
 	std::unordered_map<Material*, std::vector<RenderCommand>> solids_sorted;
 	for (auto it = m_renderCommands.rbegin(), end = m_renderCommands.rend(); it != end; ++it)
@@ -275,24 +291,25 @@ void SimpleRenderer::RenderPushedCommands()
 		}
 
 		// common stuff
-		currentShader->SetMatrix("view", view);
-		currentShader->SetMatrix("projection", projection);
-		currentShader->SetVector("CamPos", cameraPosition);
+		currentShader->SetMatrix("view", kViewHash, view);
+		currentShader->SetMatrix("projection", kProjectionHash, projection);
+		currentShader->SetVector("CamPos", kCamPosHash, cameraPosition);
 
-		currentShader->SetBool("ShadowsEnabled", m_enableShadows);
+		currentShader->SetBool("ShadowsEnabled", kShadowsEnabledHash, m_enableShadows);
 
 		for (RenderCommand rc : materialMap.second)
 		{
 			// Frustum Culling.
 			if (m_enableFrustumCulling && !m_camera->GetFrustum().Intersect(rc.BoxMin, rc.BoxMax)) {
 				// DebugDraw::AddAABB(rc.BoxMin, rc.BoxMax, { 1.0f, 1.0f, 1.0f, 1.0f });
+				++culledCommands;
 				continue;
 			}
 
 			// DebugDraw::AddAABB(rc.BoxMin, rc.BoxMax, { 0.0f, 1.0f, 0.0f, 1.0f });
 
-			currentShader->SetMatrix("model", rc.Transform);
-			currentShader->SetMatrix("prevModel", rc.PrevTransform);
+			currentShader->SetMatrix("model", kModelHash, rc.Transform);
+			currentShader->SetMatrix("prevModel", kPrevModelHash, rc.PrevTransform);
 
 			if (m_enableShadows && material->Type == MATERIAL_CUSTOM && material->ShadowReceive)
 			{
@@ -306,7 +323,7 @@ void SimpleRenderer::RenderPushedCommands()
 				}
 			}
 
-			std::map<std::string, UniformValueSampler>* samplers = material->GetSamplerUniforms();
+			SamplerUniformMap* samplers = material->GetSamplerUniforms();
 			for (auto it = samplers->begin(), end = samplers->end(); it != end; ++it)
 			{
 				if (it->second.Type == SHADER_TYPE_SAMPLERCUBE)
@@ -319,42 +336,10 @@ void SimpleRenderer::RenderPushedCommands()
 				}
 			}
 
-			std::map<std::string, UniformValue>* uniforms = material->GetUniforms();
+			UniformMap* uniforms = material->GetUniforms();
 			for (auto it = uniforms->begin(), end = uniforms->end(); it != end; ++it)
 			{
-				switch (it->second.Type)
-				{
-				case SHADER_TYPE_BOOL:
-					currentShader->SetBool(it->first, it->second.Bool);
-					break;
-				case SHADER_TYPE_INT:
-					currentShader->SetInt(it->first, it->second.Int);
-					break;
-				case SHADER_TYPE_FLOAT:
-					currentShader->SetFloat(it->first, it->second.Float);
-					break;
-				case SHADER_TYPE_VEC2:
-					currentShader->SetVector(it->first, it->second.Vec2);
-					break;
-				case SHADER_TYPE_VEC3:
-					currentShader->SetVector(it->first, it->second.Vec3);
-					break;
-				case SHADER_TYPE_VEC4:
-					currentShader->SetVector(it->first, it->second.Vec4);
-					break;
-				case SHADER_TYPE_MAT2:
-					currentShader->SetMatrix(it->first, it->second.Mat2);
-					break;
-				case SHADER_TYPE_MAT3:
-					currentShader->SetMatrix(it->first, it->second.Mat3);
-					break;
-				case SHADER_TYPE_MAT4:
-					currentShader->SetMatrix(it->first, it->second.Mat4);
-					break;
-				default:
-					LOG_ERROR("Unrecognized Uniform type set.");
-					break;
-				}
+				currentShader->SetUniform(it->first, it->second);
 			}
 
 			// Render Mesh
@@ -428,14 +413,14 @@ void SimpleRenderer::RenderPushedCommands()
 			currentShader->Use();
 		}
 
-		currentShader->SetMatrix("view", view);
-		currentShader->SetMatrix("projection", projection);
-		currentShader->SetVector("CamPos", cameraPosition);
+		currentShader->SetMatrix("view", kViewHash, view);
+		currentShader->SetMatrix("projection", kProjectionHash, projection);
+		currentShader->SetVector("CamPos", kCamPosHash, cameraPosition);
 
-		currentShader->SetMatrix("model", rc.Transform);
-		currentShader->SetMatrix("prevModel", rc.PrevTransform);
+		currentShader->SetMatrix("model", kModelHash, rc.Transform);
+		currentShader->SetMatrix("prevModel", kPrevModelHash, rc.PrevTransform);
 
-		std::map<std::string, UniformValueSampler>* samplers = rc.Material->GetSamplerUniforms();
+		SamplerUniformMap* samplers = rc.Material->GetSamplerUniforms();
 		for (auto it = samplers->begin(), end = samplers->end(); it != end; ++it)
 		{
 			if (it->second.Type == SHADER_TYPE_SAMPLERCUBE)
@@ -448,42 +433,10 @@ void SimpleRenderer::RenderPushedCommands()
 			}
 		}
 
-		std::map<std::string, UniformValue>* uniforms = rc.Material->GetUniforms();
+		UniformMap* uniforms = rc.Material->GetUniforms();
 		for (auto it = uniforms->begin(), end = uniforms->end(); it != end; ++it)
 		{
-			switch (it->second.Type)
-			{
-			case SHADER_TYPE_BOOL:
-				currentShader->SetBool(it->first, it->second.Bool);
-				break;
-			case SHADER_TYPE_INT:
-				currentShader->SetInt(it->first, it->second.Int);
-				break;
-			case SHADER_TYPE_FLOAT:
-				currentShader->SetFloat(it->first, it->second.Float);
-				break;
-			case SHADER_TYPE_VEC2:
-				currentShader->SetVector(it->first, it->second.Vec2);
-				break;
-			case SHADER_TYPE_VEC3:
-				currentShader->SetVector(it->first, it->second.Vec3);
-				break;
-			case SHADER_TYPE_VEC4:
-				currentShader->SetVector(it->first, it->second.Vec4);
-				break;
-			case SHADER_TYPE_MAT2:
-				currentShader->SetMatrix(it->first, it->second.Mat2);
-				break;
-			case SHADER_TYPE_MAT3:
-				currentShader->SetMatrix(it->first, it->second.Mat3);
-				break;
-			case SHADER_TYPE_MAT4:
-				currentShader->SetMatrix(it->first, it->second.Mat4);
-				break;
-			default:
-				LOG_ERROR("Unrecognized Uniform type set.");
-				break;
-			}
+			currentShader->SetUniform(it->first, it->second);
 		}
 
 		// Render Mesh
@@ -493,6 +446,8 @@ void SimpleRenderer::RenderPushedCommands()
 	transparents.clear();
 #endif
 
+	PROFILE_COUNTER("Culled Commands", culledCommands);
+
 	// store view projection as previous view projection for next frame's motion blur
 	m_prevViewProjection = m_camera->GetProjection() * m_camera->GetView();
 }
@@ -512,9 +467,9 @@ void SimpleRenderer::RenderShadowCastCommand(RenderCommand* rc, const glm::mat4&
 {
 	Shader* shadowShader = m_materialLibrary->dirShadowShader;
 
-	shadowShader->SetMatrix("view", view);
-	shadowShader->SetMatrix("projection", projection);
-	shadowShader->SetMatrix("model", rc->Transform);
+	shadowShader->SetMatrix("view", kViewHash, view);
+	shadowShader->SetMatrix("projection", kProjectionHash, projection);
+	shadowShader->SetMatrix("model", kModelHash, rc->Transform);
 
 	RenderMesh(rc->Mesh);
 }
@@ -11,40 +11,36 @@
 
 #include "DebugDraw.h"
 
-class SceneNode;
-class Camera;
 class MaterialLibrary;
-class Shader;
 class RenderTarget;
-class DirectionalLight;
 
 class SimpleRenderer
 	: public IRenderer
 {
 public:
 	SimpleRenderer() = default;
-	~SimpleRenderer();
+	~SimpleRenderer() override;
 
 	void Init();
-	void SetCamera(Camera* camera);
-	void SetRenderSize(int width, int height);
+	void SetCamera(Camera* camera) override;
+	void SetRenderSize(int width, int height) override;
 
 	// create either a deferred default material (based on default set of materials available (like glass)), or a custom material (with custom you have to supply your own shader)
 	Material* CreateMaterial(std::string base = "default-fwd") override; // these don't have the custom flag set (default material has default state and uses checkerboard texture as albedo (and black metallic, half roughness, purple normal, white ao)
-	Material* CreateCustomMaterial(Shader* shader);         // these have the custom flag set (will be rendered in forward pass)
-	Material* CreatePostProcessingMaterial(Shader* shader); // these have the post-processing flag set (will be rendered after deferred/forward pass)
+	Material* CreateCustomMaterial(Shader* shader) override;         // these have the custom flag set (will be rendered in forward pass)
+	Material* CreatePostProcessingMaterial(Shader* shader) override; // these have the post-processing flag set (will be rendered after deferred/forward pass)
 
-	void PushRender(Mesh* mesh, Material* material, glm::mat4 transform = glm::mat4(1.0f), glm::mat4 prevTransform = glm::mat4(1.0f));
-	void PushRender(SceneNode* node);
+	void PushRender(Mesh* mesh, Material* material, glm::mat4 transform = glm::mat4(1.0f), glm::mat4 prevTransform = glm::mat4(1.0f)) override;
+	void PushRender(SceneNode* node) override;
 
-	void AddLight(DirectionalLight* light) { m_DirectionalLights.push_back(light); }
+	void AddLight(DirectionalLight* light) override { m_DirectionalLights.push_back(light); }
 
-	void RenderPushedCommands();
+	void RenderPushedCommands() override;
 
-	int GetRenderWidth() const { return m_renderTargetWidth; }
-	int GetRenderHeight() const { return m_renderTargetHeight; }
+	int GetRenderWidth() const override { return m_renderTargetWidth; }
+	int GetRenderHeight() const override { return m_renderTargetHeight; }
 
-	void RenderUIMenu();
+	void RenderUIMenu() override;
 
 private:
 	void RenderShadowCastCommand(RenderCommand* rc, const glm::mat4& view, const glm::mat4& projection);
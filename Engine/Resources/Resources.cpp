@@ -19,10 +19,10 @@ const std::string Resources::s_assetShaderDir = "Shaders/";
 const std::string Resources::s_assetModelDir = "Objects/";
 const std::string Resources::s_assetImagesDir = "Images/";
 
-std::map<unsigned int, Shader>      Resources::m_shaders = std::map<unsigned int, Shader>();
-std::map<unsigned int, Texture>     Resources::m_textures = std::map<unsigned int, Texture>();
-std::map<unsigned int, TextureCube> Resources::m_texturesCube = std::map<unsigned int, TextureCube>();
-std::map<unsigned int, SceneNode*>  Resources::m_meshes = std::map<unsigned int, SceneNode*>();
+FlatHashMap<size_t, std::unique_ptr<Shader>, IdentityHash> Resources::m_shaders;
+std::map<size_t, Texture>     Resources::m_textures = std::map<size_t, Texture>();
+std::map<size_t, TextureCube> Resources::m_texturesCube = std::map<size_t, TextureCube>();
+std::map<size_t, SceneNode*>  Resources::m_meshes = std::map<size_t, SceneNode*>();
 
 void Resources::Init()
 {
@@ -39,22 +39,22 @@ void Resources::Clean()
 
 Shader* Resources::LoadShader(const std::string& name, const std::string& vsPath, const std::string& fsPath, std::vector<std::string> defines)
 {
-	unsigned int id = Utils::Hash(name);
+	size_t id = Utils::Hash(name);
 
 	auto it = m_shaders.find(id);
 	if (it != m_shaders.end())
 	{
-		return &it->second;
+		return it->second.get();
 	}
 
 	Shader shader = ShaderLoader::Load(name,
 		s_mainAssetDirectory + vsPath,
 		s_mainAssetDirectory + fsPath, defines);
 
-	auto result = m_shaders.emplace(id, shader);
+	auto result = m_shaders.emplace(id, std::make_unique<Shader>(std::move(shader)));
 	if (result.second)
 	{
-		return &result.first->second;
+		return result.first->second.get();
 	}
 
 	LOG_ERROR("Could not load shader: %s", name.c_str());
@@ -64,12 +64,12 @@ Shader* Resources::LoadShader(const std::string& name, const std::string& vsPath
 
 Shader* Resources::GetShader(const std::string& name)
 {
-	unsigned int id = Utils::Hash(name);
+	size_t id = Utils::Hash(name);
 
 	auto it = m_shaders.find(id);
 	if (it != m_shaders.end())
 	{
-		return &it->second;
+		return it->second.get();
 	}
 
 	LOG_ERROR("Requested shader: %s not found!", name.c_str());
@@ -79,7 +79,7 @@ Shader* Resources::GetShader(const std::string& name)
 
 Texture* Resources::LoadTexture(const std::string& name, const std::string& path, GLenum target, GLenum format, bool srgb, bool fullpath)
 {
-	unsigned int id = Utils::Hash(name);
+	size_t id = Utils::Hash(name);
 
 	auto it = m_textures.find(id);
 	if (it != m_textures.end())
@@ -108,7 +108,7 @@ Texture* Resources::LoadTexture(const std::string& name, const std::string& path
 
 Texture* Resources::LoadHDR(const std::string& name, const std::string& path)
 {
-	unsigned int id = Utils::Hash(name);
+	size_t id = Utils::Hash(name);
 
 	auto it = m_textures.find(id);
 	if (it != m_textures.end())
@@ -133,7 +133,7 @@ Texture* Resources::LoadHDR(const std::string& name, const std::string& path)
 
 Texture* Resources::GetTexture(const std::string& name)
 {
-	unsigned int id = Utils::Hash(name);
+	size_t id = Utils::Hash(name);
 
 	auto it = m_textures.find(id);
 	if (it != m_textures.end())
@@ -149,7 +149,7 @@ Texture* Resources::GetTexture(const std::string& name)
 
 TextureCube* Resources::LoadTextureCube(const std::string& name, const std::string& folder)
 {
-	unsigned int id = Utils::Hash(name);
+	size_t id = Utils::Hash(name);
 
 	if (TextureCube* texture = GetTextureCube(name))
 	{
@@ -170,7 +170,7 @@ TextureCube* Resources::LoadTextureCube(const std::string& name, const std::stri
 
 TextureCube* Resources::GetTextureCube(const std::string& name)
 {
-	unsigned int id = Utils::Hash(name);
+	size_t id = Utils::Hash(name);
 
 	auto it = m_texturesCube.find(id);
 	if (it != m_texturesCube.end())
@@ -186,7 +186,7 @@ TextureCube* Resources::GetTextureCube(const std::string& name)
 
 SceneNode* Resources::LoadMesh(IRenderer* renderer, const std::string& name, const std::string& path)
 {
-	unsigned int id = Utils::Hash(name);
+	size_t id = Utils::Hash(name);
 
 	auto it = m_meshes.find(id);
 	if (it != m_meshes.end())
@@ -208,7 +208,7 @@ SceneNode* Resources::LoadMesh(IRenderer* renderer, const std::string& name, con
 
 SceneNode* Resources::GetMesh(const std::string& name)
 {
-	unsigned int id = Utils::Hash(name);
+	size_t id = Utils::Hash(name);
 
 	auto it = m_meshes.find(id);
 	if (it != m_meshes.end())
@@ -6,7 +6,10 @@
 #include "Shading/TextureCube.h"
 #include "Mesh/Mesh.h"
 
+#include "Core/Containers/FlatHashMap.h"
+
 #include <map>
+#include <memory>
 #include <string>
 
 class SceneNode;
@@ -38,10 +41,11 @@ private:
 
 private:
 	// we index all resources w/ a hashed string ID
-	static std::map<unsigned int, Shader>      m_shaders;
-	static std::map<unsigned int, Texture>     m_textures;
-	static std::map<unsigned int, TextureCube> m_texturesCube;
-	static std::map<unsigned int, SceneNode*>  m_meshes;
+	// boxed, Shader* handed out must survive the map growing.
+	static FlatHashMap<size_t, std::unique_ptr<Shader>, IdentityHash> m_shaders;
+	static std::map<size_t, Texture>     m_textures;
+	static std::map<size_t, TextureCube> m_texturesCube;
+	static std::map<size_t, SceneNode*>  m_meshes;
 
 	static const std::string s_mainAssetDirectory;
 	static const std::string s_assetShaderDir;
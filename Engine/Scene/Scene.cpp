@@ -80,7 +80,7 @@ void Scene::DeleteSceneNode(SceneNode* node)
 {
 	if (node->GetParent())
 	{
-		node->GetParent()->RemoveChild(node->GetID());
+		node->GetParent()->RemoveChild(node);
 	}
 	// all delete logic is contained within each scene node's destructor.
 	delete node;
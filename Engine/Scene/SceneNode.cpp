@@ -24,11 +24,11 @@ SceneNode::SceneNode(unsigned int id)
 SceneNode::~SceneNode()
 {
 	// traverse the list of children and delete accordingly.
-	for (unsigned int i = 0; i < m_children.size(); ++i)
+	for (SceneNode* child : m_children)
 	{
 		// it should not be possible that a scene node is childed by more than one
 		// parent, thus we don't need to care about deleting dangling pointers.
-		delete m_children[i];
+		delete child;
 	}
 }
 
@@ -99,22 +99,32 @@ void SceneNode::AddChild(SceneNode* node)
 	// current parent. Scene nodes aren't allowed to exist under multiple parents.
 	if (node->m_parent)
 	{
-		node->m_parent->RemoveChild(node->m_id);
+		node->m_parent->RemoveChild(node);
 	}
 	node->m_parent = this;
-	m_children.push_back(node);
+	node->m_slot = m_children.insert(node);
 }
 
 void SceneNode::RemoveChild(unsigned int id)
 {
-	auto it = std::find(m_children.begin(), m_children.end(), GetChild(id));
-	if (it != m_children.end())
-		m_children.erase(it);
+	if (SceneNode* child = GetChild(id))
+	{
+		RemoveChild(child);
+	}
+}
+
+void SceneNode::RemoveChild(SceneNode* node)
+{
+	if (node->m_parent == this && m_children.erase(node->m_slot))
+	{
+		node->m_parent = nullptr;
+		node->m_slot = SlotHandle{};
+	}
 }
 
-std::vector<SceneNode*> SceneNode::GetChildren()
+const std::vector<SceneNode*>& SceneNode::GetChildren() const
 {
-	return m_children;
+	return m_children.values();
 }
 
 unsigned int SceneNode::GetChildCount()
@@ -124,10 +134,10 @@ unsigned int SceneNode::GetChildCount()
 
 SceneNode* SceneNode::GetChild(unsigned int id)
 {
-	for (unsigned int i = 0; i < m_children.size(); ++i)
+	for (SceneNode* child : m_children)
 	{
-		if (m_children[i]->GetID() == id)
-			return m_children[i];
+		if (child->GetID() == id)
+			return child;
 	}
 	return nullptr;
 }
@@ -135,7 +145,7 @@ SceneNode* SceneNode::GetChild(unsigned int id)
 SceneNode* SceneNode::GetChildByIndex(unsigned int index)
 {
 	assert(index < GetChildCount());
-	return m_children[index];
+	return m_children.data()[index];
 }
 
 SceneNode* SceneNode::GetParent()
@@ -182,13 +192,13 @@ void SceneNode::UpdateTransform(bool updatePrevTransform)
 			m_transform = m_parent->m_transform * m_transform;
 		}
 	}
-	for (unsigned int i = 0; i < m_children.size(); ++i)
+	for (SceneNode* child : m_children)
 	{
 		if (m_isDirty)
 		{
-			m_children[i]->m_isDirty = true;
+			child->m_isDirty = true;
 		}
-		m_children[i]->UpdateTransform(updatePrevTransform);
+		child->UpdateTransform(updatePrevTransform);
 	}
 	m_isDirty = false;
 }
@@ -219,7 +229,7 @@ void SceneNode::ShowNode(int depth)
 
 		for (unsigned int i = 0; i < childCount; ++i)
 		{
-			m_children[i]->ShowNode(depth++);
+			m_children.data()[i]->ShowNode(depth++);
 		}
 		ImGui::TreePop();
 	}
@@ -5,11 +5,16 @@
 #include <glm/glm.hpp>
 #include <glm/gtx/transform.hpp>
 
+#include "Core/Containers/SlotMap.h"
+#include "Core/Memory/PoolAllocator.h"
+
 class Scene;
 class Mesh;
 class Material;
 
+// nodes are new'd and deleted one by one, NodePool keeps them together.
 class SceneNode
+	: public PoolAllocated<SceneNode>
 {
 public:
 	SceneNode(unsigned int id);
@@ -27,8 +32,11 @@ public:
 
 	unsigned int GetID();
 	void AddChild(SceneNode* node);
+	// moves the last child into the removed one's place, so sibling order
+	// (GetChildren, GetChildByIndex) is insertion order only until a removal.
 	void RemoveChild(unsigned int id);
-	std::vector<SceneNode*> GetChildren();
+	void RemoveChild(SceneNode* node);
+	const std::vector<SceneNode*>& GetChildren() const;
 	unsigned int GetChildCount();
 	SceneNode* GetChild(unsigned int id);
 	SceneNode* GetChildByIndex(unsigned int index);
@@ -51,8 +59,12 @@ public:
 	glm::vec3 BoxMax = glm::vec3(1.0f);
 
 private:
-	std::vector<SceneNode*> m_children;
+	// packed, so removing a child doesn't search or shift the others; the
+	// last child fills the gap instead.
+	SlotMap<SceneNode*> m_children;
 	SceneNode* m_parent;
+	// this node's handle in m_parent->m_children.
+	SlotHandle m_slot;
 
 	// per-node transform (w/ parent-child relationship)
 	glm::mat4 m_transform = glm::identity<glm::mat4>();
@@ -1,6 +1,7 @@
 #include "Material.h"
 
 #include "Resources/Resources.h"
+#include "Utils/Utils.h"
 
 
 Material::Material()
@@ -52,20 +53,17 @@ Material Material::Copy()
 
 void Material::SetBool(std::string name, bool value)
 {
-	m_Uniforms[name].Type = SHADER_TYPE_BOOL;
-	m_Uniforms[name].Bool = value;
+	setUniform(name, SHADER_TYPE_BOOL).Bool = value;
 }
 
 void Material::SetInt(std::string name, int value)
 {
-	m_Uniforms[name].Type = SHADER_TYPE_INT;
-	m_Uniforms[name].Int = value;
+	setUniform(name, SHADER_TYPE_INT).Int = value;
 }
 
 void Material::SetFloat(std::string name, float value)
 {
-	m_Uniforms[name].Type = SHADER_TYPE_FLOAT;
-	m_Uniforms[name].Float = value;
+	setUniform(name, SHADER_TYPE_FLOAT).Float = value;
 }
 
 void Material::SetTexture(std::string name, Texture* value, unsigned int unit)
@@ -111,46 +109,49 @@ void Material::SetTextureCube(std::string name, TextureCube* value, unsigned int
 
 void Material::SetVector(std::string name, glm::vec2 value)
 {
-	m_Uniforms[name].Type = SHADER_TYPE_VEC2;
-	m_Uniforms[name].Vec2 = value;
+	setUniform(name, SHADER_TYPE_VEC2).Vec2 = value;
 }
 
 void Material::SetVector(std::string name, glm::vec3 value)
 {
-	m_Uniforms[name].Type = SHADER_TYPE_VEC3;
-	m_Uniforms[name].Vec3 = value;
+	setUniform(name, SHADER_TYPE_VEC3).Vec3 = value;
 }
 
 void Material::SetVector(std::string name, glm::vec4 value)
 {
-	m_Uniforms[name].Type = SHADER_TYPE_VEC4;
-	m_Uniforms[name].Vec4 = value;
+	setUniform(name, SHADER_TYPE_VEC4).Vec4 = value;
 }
 
 void Material::SetMatrix(std::string name, glm::mat2 value)
 {
-	m_Uniforms[name].Type = SHADER_TYPE_MAT2;
-	m_Uniforms[name].Mat2 = value;
+	setUniform(name, SHADER_TYPE_MAT2).Mat2 = value;
 }
 
 void Material::SetMatrix(std::string name, glm::mat3 value)
 {
-	m_Uniforms[name].Type = SHADER_TYPE_MAT3;
-	m_Uniforms[name].Mat3 = value;
+	setUniform(name, SHADER_TYPE_MAT3).Mat3 = value;
 }
 
 void Material::SetMatrix(std::string name, glm::mat4 value)
 {
-	m_Uniforms[name].Type = SHADER_TYPE_MAT4;
-	m_Uniforms[name].Mat4 = value;
+	setUniform(name, SHADER_TYPE_MAT4).Mat4 = value;
 }
 
-std::map<std::string, UniformValue>* Material::GetUniforms()
+UniformValue& Material::setUniform(const std::string& name, SHADER_TYPE type)
+{
+	const size_t hash = Utils::Hash(name);
+	UniformValue& uniform = m_Uniforms[name];
+	uniform.Type = type;
+	uniform.NameHash = hash;
+	return uniform;
+}
+
+UniformMap* Material::GetUniforms()
 {
 	return &m_Uniforms;
 }
 
-std::map<std::string, UniformValueSampler>* Material::GetSamplerUniforms()
+SamplerUniformMap* Material::GetSamplerUniforms()
 {
 	return &m_SamplerUniforms;
 }
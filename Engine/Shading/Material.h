@@ -8,7 +8,9 @@
 #include <glm/glm.hpp>
 #include <GL/glew.h>
 
-#include <map>
+#include "Core/Containers/FlatHashMap.h"
+
+#include <string>
 
 enum MaterialType
 {
@@ -17,13 +19,17 @@ enum MaterialType
 	MATERIAL_POST_PROCESS,
 };
 
+// walked on every draw to set the shader's uniforms.
+using UniformMap = FlatHashMap<std::string, UniformValue, StringHash, std::equal_to<>>;
+using SamplerUniformMap = FlatHashMap<std::string, UniformValueSampler, StringHash, std::equal_to<>>;
+
 class Material
 {
 private:
 	// shader state
 	Shader* m_Shader;
-	std::map<std::string, UniformValue>        m_Uniforms;
-	std::map<std::string, UniformValueSampler> m_SamplerUniforms;
+	UniformMap        m_Uniforms;
+	SamplerUniformMap m_SamplerUniforms;
 public:
 	MaterialType Type = MATERIAL_CUSTOM;
 	glm::vec4 Color = glm::vec4(1.0f);
@@ -49,6 +55,8 @@ public:
 	bool ShadowReceive = true;
 
 private:
+	// one lookup per set, and caches the name's hash for the shader.
+	UniformValue& setUniform(const std::string& name, SHADER_TYPE type);
 
 public:
 	Material();
@@ -71,7 +79,7 @@ public:
 	void SetMatrix(std::string name, glm::mat3 value);
 	void SetMatrix(std::string name, glm::mat4 value);
 
-	std::map<std::string, UniformValue>* GetUniforms();
-	std::map<std::string, UniformValueSampler>* GetSamplerUniforms();
+	UniformMap* GetUniforms();
+	SamplerUniformMap* GetSamplerUniforms();
 };
 
@@ -148,7 +148,7 @@ void Shader::Load(const std::string& name, std::string vsCode, std::string fsCod
 		uniform.Type = SHADER_TYPE_BOOL;
 		uniform.Size = Uniforms[i].Size;
 
-		m_uniformMap[Utils::Hash(uniform.Name)] = uniform;
+		m_uniformMap[uniform.Name] = uniform;
 	}
 }
 
@@ -159,7 +159,7 @@ void Shader::Use()
 
 bool Shader::HasUniform(const std::string& name)
 {
-	return m_uniformMap.find(Utils::Hash(name)) != m_uniformMap.end();
+	return m_uniformMap.find(name) != m_uniformMap.end();
 
 	for (unsigned int i = 0; i < Uniforms.size(); ++i)
 	{
@@ -171,42 +171,72 @@ bool Shader::HasUniform(const std::string& name)
 
 void Shader::SetInt(const std::string& location, int value)
 {
-	int loc = getUniformLocation(location);
+	SetInt(location, Utils::Hash(location), value);
+}
+
+void Shader::SetInt(std::string_view location, size_t hash, int value)
+{
+	int loc = getUniformLocation(location, hash);
 	if (loc >= 0)
 		glUniform1i(loc, value);
 }
 
 void Shader::SetBool(const std::string& location, bool value)
 {
-	int loc = getUniformLocation(location);
+	SetBool(location, Utils::Hash(location), value);
+}
+
+void Shader::SetBool(std::string_view location, size_t hash, bool value)
+{
+	int loc = getUniformLocation(location, hash);
 	if (loc >= 0)
 		glUniform1i(loc, (int)value);
 }
 
 void Shader::SetFloat(const std::string& location, float value)
 {
-	int loc = getUniformLocation(location);
+	SetFloat(location, Utils::Hash(location), value);
+}
+
+void Shader::SetFloat(std::string_view location, size_t hash, float value)
+{
+	int loc = getUniformLocation(location, hash);
 	if (loc >= 0)
 		glUniform1f(loc, value);
 }
 
 void Shader::SetVector(const std::string& location, glm::vec2 value)
 {
-	int loc = getUniformLocation(location);
+	SetVector(location, Utils::Hash(location), value);
+}
+
+void Shader::SetVector(std::string_view location, size_t hash, glm::vec2 value)
+{
+	int loc = getUniformLocation(location, hash);
 	if (loc >= 0)
 		glUniform2fv(loc, 1, &value[0]);
 }
 
 void Shader::SetVector(const std::string& location, glm::vec3 value)
 {
-	int loc = getUniformLocation(location);
+	SetVector(location, Utils::Hash(location), value);
+}
+
+void Shader::SetVector(std::string_view location, size_t hash, glm::vec3 value)
+{
+	int loc = getUniformLocation(location, hash);
 	if (loc >= 0)
 		glUniform3fv(loc, 1, &value[0]);
 }
 
 void Shader::SetVector(const std::string& location, glm::vec4 value)
 {
-	int loc = getUniformLocation(location);
+	SetVector(location, Utils::Hash(location), value);
+}
+
+void Shader::SetVector(std::string_view location, size_t hash, glm::vec4 value)
+{
+	int loc = getUniformLocation(location, hash);
 	if (loc >= 0)
 		glUniform4fv(loc, 1, &value[0]);
 }
@@ -240,43 +270,84 @@ void Shader::SetVectorArray(const std::string& location, int size, const std::ve
 
 void Shader::SetMatrix(const std::string& location, glm::mat2 value)
 {
-	int loc = getUniformLocation(location);
+	SetMatrix(location, Utils::Hash(location), value);
+}
+
+void Shader::SetMatrix(std::string_view location, size_t hash, glm::mat2 value)
+{
+	int loc = getUniformLocation(location, hash);
 	if (loc >= 0)
 		glUniformMatrix2fv(loc, 1, GL_FALSE, &value[0][0]);
 }
 
 void Shader::SetMatrix(const std::string& location, glm::mat3 value)
 {
-	int loc = getUniformLocation(location);
+	SetMatrix(location, Utils::Hash(location), value);
+}
+
+void Shader::SetMatrix(std::string_view location, size_t hash, glm::mat3 value)
+{
+	int loc = getUniformLocation(location, hash);
 	if (loc >= 0)
 		glUniformMatrix3fv(loc, 1, GL_FALSE, &value[0][0]);
 }
 
 void Shader::SetMatrix(const std::string& location, glm::mat4 value)
 {
-	int loc = getUniformLocation(location);
+	SetMatrix(location, Utils::Hash(location), value);
+}
+
+void Shader::SetMatrix(std::string_view location, size_t hash, glm::mat4 value)
+{
+	int loc = getUniformLocation(location, hash);
 	if (loc >= 0)
 		glUniformMatrix4fv(loc, 1, GL_FALSE, &value[0][0]);
 }
 
-int Shader::getUniformLocation(const std::string& name)
+void Shader::SetUniform(std::string_view location, const UniformValue& value)
+{
+	switch (value.Type)
+	{
+	case SHADER_TYPE_BOOL:
+		SetBool(location, value.NameHash, value.Bool);
+		break;
+	case SHADER_TYPE_INT:
+		SetInt(location, value.NameHash, value.Int);
+		break;
+	case SHADER_TYPE_FLOAT:
+		SetFloat(location, value.NameHash, value.Float);
+		break;
+	case SHADER_TYPE_VEC2:
+		SetVector(location, value.NameHash, value.Vec2);
+		break;
+	case SHADER_TYPE_VEC3:
+		SetVector(location, value.NameHash, value.Vec3);
+		break;
+	case SHADER_TYPE_VEC4:
+		SetVector(location, value.NameHash, value.Vec4);
+		break;
+	case SHADER_TYPE_MAT2:
+		SetMatrix(location, value.NameHash, value.Mat2);
+		break;
+	case SHADER_TYPE_MAT3:
+		SetMatrix(location, value.NameHash, value.Mat3);
+		break;
+	case SHADER_TYPE_MAT4:
+		SetMatrix(location, value.NameHash, value.Mat4);
+		break;
+	default:
+		LOG_ERROR("Unrecognized Uniform type set.");
+		break;
+	}
+}
+
+int Shader::getUniformLocation(std::string_view name, size_t hash)
 {
-	unsigned int hash = Utils::Hash(name);
-	auto find = m_uniformMap.find(hash);
+	auto find = m_uniformMap.find(name, hash);
 	if (find != m_uniformMap.end())
 	{
 		return find->second.Location;
 	}
 
-	// read from uniform/attribute array as originally obtained from OpenGL
-	// for (unsigned int i = 0; i < Uniforms.size(); ++i)
-	// {
-	// 	if (Uniforms[i].Name == name) 
-	// 	{
-	// 		m_hashToUniformIndex.insert({ hash, i });
-	// 		return Uniforms[i].Location;
-	// 	}
-	// }
-
 	return -1;
 }
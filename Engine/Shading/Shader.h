@@ -1,11 +1,13 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_map>
 
 #include "ShadingTypes.h"
 
+#include "Core/Containers/FlatHashMap.h"
+
 
 class Shader
 {
@@ -41,12 +43,26 @@ public:
 	void SetMatrixArray(const std::string& location, int size, glm::mat2* values);
 	void SetMatrixArray(const std::string& location, int size, glm::mat3* values);
 	void SetMatrixArray(const std::string& location, int size, glm::mat4* values);
+
+	// same as above with the Utils::Hash of the name precomputed, for uniforms
+	// set on every draw.
+	void SetInt(std::string_view location, size_t hash, int   value);
+	void SetBool(std::string_view location, size_t hash, bool  value);
+	void SetFloat(std::string_view location, size_t hash, float value);
+	void SetVector(std::string_view location, size_t hash, glm::vec2  value);
+	void SetVector(std::string_view location, size_t hash, glm::vec3  value);
+	void SetVector(std::string_view location, size_t hash, glm::vec4  value);
+	void SetMatrix(std::string_view location, size_t hash, glm::mat2 value);
+	void SetMatrix(std::string_view location, size_t hash, glm::mat3 value);
+	void SetMatrix(std::string_view location, size_t hash, glm::mat4 value);
+
+	// sets a material uniform by its type, with the hash cached in the value.
+	void SetUniform(std::string_view location, const UniformValue& value);
 private:
 	// retrieves uniform location from pre-stored uniform locations and reports an error if a 
 	// non-uniform is set.
-	int getUniformLocation(const std::string& name);
+	int getUniformLocation(std::string_view name, size_t hash);
 
-	std::unordered_map<unsigned int, unsigned int> m_hashToUniformIndex;
-	std::unordered_map<unsigned int, Uniform> m_uniformMap;
+	FlatHashMap<std::string, Uniform, StringHash, std::equal_to<>> m_uniformMap;
 };
 
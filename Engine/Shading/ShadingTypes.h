@@ -35,6 +35,8 @@ struct Uniform
 struct UniformValue
 {
 	SHADER_TYPE Type;
+	// Utils::Hash of the uniform name, so setting it doesn't hash again.
+	size_t      NameHash = 0;
 
 	union
 	{
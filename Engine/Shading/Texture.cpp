@@ -26,6 +26,7 @@ void Texture::Generate(unsigned int width, GLenum internalFormat, GLenum format,
 	assert(Target == GL_TEXTURE_1D);
 	Bind();
 	glTexImage1D(Target, 0, internalFormat, width, 0, format, type, data);
+	m_memory.Set(GetMemorySize(internalFormat, type, width, 1, 1, Mipmapping));
 	glTexParameteri(Target, GL_TEXTURE_MIN_FILTER, FilterMin);
 	glTexParameteri(Target, GL_TEXTURE_MAG_FILTER, FilterMax);
 	glTexParameteri(Target, GL_TEXTURE_WRAP_S, WrapS);
@@ -48,6 +49,7 @@ void Texture::Generate(unsigned int width, unsigned int height, GLenum internalF
 	assert(Target == GL_TEXTURE_2D);
 	Bind();
 	glTexImage2D(Target, 0, internalFormat, width, height, 0, format, type, data);
+	m_memory.Set(GetMemorySize(internalFormat, type, width, height, 1, Mipmapping));
 	glTexParameteri(Target, GL_TEXTURE_MIN_FILTER, FilterMin);
 	glTexParameteri(Target, GL_TEXTURE_MAG_FILTER, FilterMax);
 	glTexParameteri(Target, GL_TEXTURE_WRAP_S, WrapS);
@@ -71,6 +73,7 @@ void Texture::Generate(unsigned int width, unsigned int height, unsigned int dep
 	assert(Target == GL_TEXTURE_3D);
 	Bind();
 	glTexImage3D(Target, 0, internalFormat, width, height, depth, 0, format, type, data);
+	m_memory.Set(GetMemorySize(internalFormat, type, width, height, depth, Mipmapping));
 	glTexParameteri(Target, GL_TEXTURE_MIN_FILTER, FilterMin);
 	glTexParameteri(Target, GL_TEXTURE_MAG_FILTER, FilterMax);
 	glTexParameteri(Target, GL_TEXTURE_WRAP_S, WrapS);
@@ -87,16 +90,19 @@ void Texture::Resize(unsigned int width, unsigned int height, unsigned int depth
 	if (Target == GL_TEXTURE_1D)
 	{
 		glTexImage1D(GL_TEXTURE_1D, 0, InternalFormat, width, 0, Format, Type, 0);
+		m_memory.Set(GetMemorySize(InternalFormat, Type, width, 1, 1, false));
 	}
 	else if (Target == GL_TEXTURE_2D)
 	{
 		assert(height > 0);
 		glTexImage2D(GL_TEXTURE_2D, 0, InternalFormat, width, height, 0, Format, Type, 0);
+		m_memory.Set(GetMemorySize(InternalFormat, Type, width, height, 1, false));
 	}
 	else if (Target == GL_TEXTURE_3D)
 	{
 		assert(height > 0 && depth > 0);
 		glTexImage3D(GL_TEXTURE_3D, 0, InternalFormat, width, height, depth, 0, Format, Type, 0);
+		m_memory.Set(GetMemorySize(InternalFormat, Type, width, height, depth, false));
 	}
 }
 
@@ -153,3 +159,48 @@ void Texture::SetFilterMax(GLenum filter, bool bind)
 	glTexParameteri(Target, GL_TEXTURE_MAG_FILTER, filter);
 }
 
+size_t Texture::GetMemorySize(GLenum internalFormat, GLenum type, unsigned int width, unsigned int height, unsigned int depth, bool mipmaps)
+{
+	size_t texelSize = 0;
+	switch (internalFormat)
+	{
+	case GL_R8: texelSize = 1; break;
+	case GL_RG8: case GL_R16F: case GL_DEPTH_COMPONENT16: texelSize = 2; break;
+	case GL_RGB8: case GL_SRGB8: texelSize = 3; break;
+	case GL_RGBA8: case GL_SRGB8_ALPHA8: case GL_RG16F: case GL_R32F:
+	case GL_DEPTH_COMPONENT24: case GL_DEPTH_COMPONENT32F: case GL_DEPTH24_STENCIL8: texelSize = 4; break;
+	case GL_RGB16F: texelSize = 6; break;
+	case GL_RGBA16F: case GL_RG32F: texelSize = 8; break;
+	case GL_RGB32F: texelSize = 12; break;
+	case GL_RGBA32F: texelSize = 16; break;
+	default:
+	{
+		// unsized formats, components times the size of the data type.
+		size_t components = 4;
+		if (internalFormat == GL_RED || internalFormat == GL_DEPTH_COMPONENT) components = 1;
+		else if (internalFormat == GL_RG) components = 2;
+		else if (internalFormat == GL_RGB || internalFormat == GL_SRGB) components = 3;
+
+		size_t componentSize = 1;
+		if (type == GL_FLOAT) componentSize = 4;
+		else if (type == GL_HALF_FLOAT || type == GL_UNSIGNED_SHORT) componentSize = 2;
+		texelSize = components * componentSize;
+	}
+	}
+
+	width = width > 0 ? width : 1;
+	height = height > 0 ? height : 1;
+	depth = depth > 0 ? depth : 1;
+
+	size_t bytes = 0;
+	while (true)
+	{
+		bytes += static_cast<size_t>(width) * height * depth * texelSize;
+		if (!mipmaps || (width == 1 && height == 1 && depth == 1))
+			break;
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+		depth = depth > 1 ? depth / 2 : 1;
+	}
+	return bytes;
+}
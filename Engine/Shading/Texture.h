@@ -2,6 +2,8 @@
 
 #include <GL/glew.h>
 
+#include "Core/Memory/MemoryTracker.h"
+
 class Texture
 {
 public:
@@ -22,6 +24,7 @@ public:
 	unsigned int Height = 0;
 	unsigned int Depth = 0;
 private:
+	TrackedBytes m_memory{ MemoryTag::Textures };
 public:
 	Texture();
 	~Texture();
@@ -43,6 +46,9 @@ public:
 	void SetWrapMode(GLenum wrapMode, bool bind = false);
 	void SetFilterMin(GLenum filter, bool bind = false);
 	void SetFilterMax(GLenum filter, bool bind = false);
+
+	// estimated driver memory for a texture of this format, the whole mip chain when mipmaps is set
+	static size_t GetMemorySize(GLenum internalFormat, GLenum type, unsigned int width, unsigned int height, unsigned int depth, bool mipmaps);
 };
 
 
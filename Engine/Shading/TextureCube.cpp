@@ -1,5 +1,7 @@
 #include "TextureCube.h"
 
+#include "Texture.h"
+
 
 
 TextureCube::TextureCube()
@@ -44,6 +46,7 @@ void TextureCube::DefaultInitialize(unsigned int width, unsigned int height, GLe
 	}
 	if (mipmap)
 		glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+	m_memory.Set(6 * Texture::GetMemorySize(InternalFormat, type, width, height, 1, mipmap));
 }
 
 void TextureCube::GenerateFace(GLenum face, unsigned int width, unsigned int height, GLenum format, GLenum type, unsigned char* data)
@@ -65,6 +68,8 @@ void TextureCube::GenerateFace(GLenum face, unsigned int width, unsigned int hei
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, WrapR);
 
 	glTexImage2D(face, 0, format, width, height, 0, format, type, data);
+	// faces come in one at a time, count the cube as six of this one.
+	m_memory.Set(6 * Texture::GetMemorySize(format, type, width, height, 1, false));
 }
 
 void TextureCube::SetMipFace(GLenum face, unsigned int width, unsigned int height, GLenum format, GLenum type, unsigned int mipLevel, unsigned char* data)
@@ -81,6 +86,7 @@ void TextureCube::Resize(unsigned int width, unsigned int height)
 	Bind();
 	for (unsigned int i = 0; i < 6; ++i)
 		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, Format, width, height, 0, Format, Type, NULL);
+	m_memory.Set(6 * Texture::GetMemorySize(Format, Type, width, height, 1, false));
 }
 
 void TextureCube::Bind(int unit)
@@ -4,6 +4,8 @@
 
 #include <vector>
 
+#include "Core/Memory/MemoryTracker.h"
+
 
 class TextureCube
 {
@@ -22,6 +24,7 @@ public:
 	unsigned int FaceWidth = 0;
 	unsigned int FaceHeight = 0;
 private:
+	TrackedBytes m_memory{ MemoryTag::Textures };
 public:
 	TextureCube();
 	~TextureCube();
@@ -3,7 +3,7 @@
 #include "IGameState.h"
 #include "Camera/FlyCamera.h"
 
-class SimpleRenderer;
+class IRenderer;
 
 
 class BaseState
@@ -24,7 +24,7 @@ public:
 
 protected:
     Game* m_game = nullptr;
-    SimpleRenderer* m_renderer = nullptr;
+    IRenderer* m_renderer = nullptr;
     FlyCamera m_camera = FlyCamera(glm::vec3(0.0f, 5.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f));
 
     bool m_inputGrabMouse = false;
@@ -5,6 +5,10 @@
 #include "Systems/GameTime.h"
 #include "Utils/FileIO.h"
 
+#include "Core/Memory/MemoryTracker.h"
+
+#include <algorithm>
+
 CLASS_DEFINITION(ISystemComponent, StatSystemComponent)
 
 StatSystemComponent::StatSystemComponent(GameTime* pGameTime)
@@ -17,11 +21,15 @@ StatSystemComponent::~StatSystemComponent()
     std::stringstream stream;
     WriteInfo(stream);
     FileIO::SaveTextFile("debug_info.txt", stream.str(), std::fstream::out | std::fstream::app);
+
+    // per tag memory of the whole run, for CI to check against budgets.
+    MemoryTracker::GetInstance().DumpJson("memory_report.json");
 }
 
 void StatSystemComponent::Initialize(Game* game)
 {
-
+    m_game = game;
+    m_hardwareCountersAvailable = PerfCounters::IsAvailable();
 }
 
 void StatSystemComponent::HandleInput(SDL_Event* event)
@@ -72,6 +80,11 @@ void StatSystemComponent::PreUpdate(float frameTime)
     }
 }
 
+void StatSystemComponent::UpdateProfilerStats()
+{
+    m_profilerStats.Update();
+}
+
 void StatSystemComponent::Update(float deltaTime)
 {
     m_lastDeltaTime = deltaTime;
@@ -184,6 +197,10 @@ void StatSystemComponent::RenderUI()
 
     ImGui::Text("One (s): %.3f", m_oneSecond);
 
+    RenderFrameGraph();
+    RenderScopes();
+    RenderMemory();
+
     ImGui::Separator();
     ImGui::Checkbox("Demo window", &show_demo_window);
     ImGui::End();
@@ -199,6 +216,200 @@ void StatSystemComponent::RenderUI()
     }
 }
 
+void StatSystemComponent::RenderFrameGraph()
+{
+    if (!m_game)
+    {
+        return;
+    }
+
+    // last frame, Render itself is still running so it shows the frame before.
+    const TaskGraph& graph = m_game->GetFrameGraph();
+    const std::vector<TaskGraph::NodeId> criticalPath = graph.GetCriticalPath();
+
+    ImGui::Separator();
+    ImGui::Text("Frame Graph: %.3f (ms)", graph.GetFrameMs());
+    for (TaskGraph::NodeId node = 0; node < graph.Size(); ++node)
+    {
+        const TaskTiming& timing = graph.GetTiming(node);
+        const bool critical = std::find(criticalPath.begin(), criticalPath.end(), node) != criticalPath.end();
+        ImGui::Text("%c %-10s %7.3f - %7.3f (%.3f ms) worker %d", critical ? '*' : ' ', graph.GetName(node),
+            timing.startMs, timing.endMs, timing.DurationMs(), timing.worker);
+    }
+}
+
+void StatSystemComponent::RenderScopes()
+{
+    static const char* columns[] = { "Scope", "Count", "Total", "Min", "Mean", "p50", "p95", "p99", "Max",
+        "IPC", "L1D miss", "LLC miss", "Br miss" };
+
+    ImGui::Separator();
+    ImGui::Text("Scopes: last %.1f (s), (ms)", m_profilerStats.GetWindowSeconds());
+
+    // per call means of the PerfCounters, only where the OS gives us any.
+    Profiler& profiler = Profiler::GetInstance();
+    bool hardwareCounters = profiler.IsCountingHardware();
+    if (ImGui::Checkbox("Hardware counters", &hardwareCounters))
+    {
+        profiler.SetHardwareCounters(hardwareCounters);
+    }
+    if (hardwareCounters && !m_hardwareCountersAvailable)
+    {
+        ImGui::SameLine();
+        ImGui::Text("(unavailable)");
+    }
+    const int columnCount = hardwareCounters && m_hardwareCountersAvailable ? IM_ARRAYSIZE(columns) : 9;
+    if (m_scopeSortColumn >= columnCount)
+    {
+        m_scopeSortColumn = 2;
+    }
+
+    m_sortedScopes.clear();
+    for (const ProfilerStats::ScopeStats& stats : m_profilerStats.GetAll())
+    {
+        m_sortedScopes.push_back(&stats);
+    }
+
+    auto value = [](const ProfilerStats::ScopeStats& stats, int column) -> float {
+        switch (column)
+        {
+        case 1: return static_cast<float>(stats.count);
+        case 3: return stats.minMs;
+        case 4: return stats.meanMs;
+        case 5: return stats.p50Ms;
+        case 6: return stats.p95Ms;
+        case 7: return stats.p99Ms;
+        case 8: return stats.maxMs;
+        case 9: return stats.ipc;
+        case 10: return stats.counters[static_cast<size_t>(PerfCounter::L1DMisses)];
+        case 11: return stats.counters[static_cast<size_t>(PerfCounter::LLCMisses)];
+        case 12: return stats.counters[static_cast<size_t>(PerfCounter::BranchMisses)];
+        default: return stats.totalMs;
+        }
+    };
+    const int sortColumn = m_scopeSortColumn;
+    if (sortColumn == 0)
+    {
+        std::sort(m_sortedScopes.begin(), m_sortedScopes.end(), [](const auto* a, const auto* b) { return a->name < b->name; });
+    }
+    else
+    {
+        std::sort(m_sortedScopes.begin(), m_sortedScopes.end(), [&value, sortColumn](const auto* a, const auto* b) {
+            return value(*a, sortColumn) > value(*b, sortColumn);
+            });
+    }
+
+    // click a header to sort by it.
+    ImGui::Columns(columnCount, "scopes");
+    for (int column = 0; column < columnCount; ++column)
+    {
+        if (ImGui::Selectable(columns[column], m_scopeSortColumn == column))
+        {
+            m_scopeSortColumn = column;
+        }
+        ImGui::NextColumn();
+    }
+    ImGui::Separator();
+
+    for (const ProfilerStats::ScopeStats* stats : m_sortedScopes)
+    {
+        ImGui::Text("%s", stats->name.c_str()); ImGui::NextColumn();
+        ImGui::Text("%zu", stats->count); ImGui::NextColumn();
+        for (int column = 2; column < 9; ++column)
+        {
+            ImGui::Text("%.3f", value(*stats, column)); ImGui::NextColumn();
+        }
+        for (int column = 9; column < columnCount; ++column)
+        {
+            if (stats->counterMask != 0)
+            {
+                ImGui::Text(column == 9 ? "%.2f" : "%.0f", value(*stats, column));
+            }
+            else
+            {
+                ImGui::Text("-");
+            }
+            ImGui::NextColumn();
+        }
+    }
+    ImGui::Columns(1);
+
+    if (m_profilerStats.GetDropped() > 0)
+    {
+        ImGui::Text("%llu events dropped", static_cast<unsigned long long>(m_profilerStats.GetDropped()));
+    }
+}
+
+void StatSystemComponent::RenderMemory()
+{
+    const MemoryTracker& tracker = MemoryTracker::GetInstance();
+    const float toMB = 1.0f / (1024.0f * 1024.0f);
+
+    ImGui::Separator();
+    ImGui::Text("Memory: %.2f (MB)", tracker.GetTotalLiveBytes() * toMB);
+
+    ImGui::Columns(6, "memory");
+    ImGui::Text("Tag"); ImGui::NextColumn();
+    ImGui::Text("Live (MB)"); ImGui::NextColumn();
+    ImGui::Text("Peak (MB)"); ImGui::NextColumn();
+    ImGui::Text("Allocs"); ImGui::NextColumn();
+    ImGui::Text("Allocs/frame"); ImGui::NextColumn();
+    ImGui::Text("Budget (MB)"); ImGui::NextColumn();
+    ImGui::Separator();
+
+    for (int tag = 0; tag < static_cast<int>(MemoryTag::Count); ++tag)
+    {
+        const MemoryTagStats stats = tracker.GetStats(static_cast<MemoryTag>(tag));
+        if (stats.overBudget)
+        {
+            ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.3f, 0.3f, 1.0f));
+        }
+
+        // click a tag to graph it.
+        if (ImGui::Selectable(GetMemoryTagName(static_cast<MemoryTag>(tag)), m_memoryGraphTag == tag, ImGuiSelectableFlags_SpanAllColumns))
+        {
+            m_memoryGraphTag = tag;
+        }
+        ImGui::NextColumn();
+        ImGui::Text("%.2f", stats.liveBytes * toMB); ImGui::NextColumn();
+        ImGui::Text("%.2f", stats.peakBytes * toMB); ImGui::NextColumn();
+        ImGui::Text("%zu", stats.allocations); ImGui::NextColumn();
+        ImGui::Text("%zu (max %zu)", stats.frameAllocations, stats.maxFrameAllocations); ImGui::NextColumn();
+        if (stats.budgetBytes > 0)
+        {
+            ImGui::Text("%.2f", stats.budgetBytes * toMB);
+        }
+        else
+        {
+            ImGui::Text("-");
+        }
+        ImGui::NextColumn();
+
+        if (stats.overBudget)
+        {
+            ImGui::PopStyleColor();
+        }
+    }
+    ImGui::Columns(1);
+
+    const MemoryTag graphTag = static_cast<MemoryTag>(m_memoryGraphTag);
+    const MemoryTagStats graphStats = tracker.GetStats(graphTag);
+    const float scaleMax = std::max(graphStats.peakBytes, graphStats.budgetBytes) * toMB * 1.1f;
+
+    char overlay[64];
+    sprintf_s(overlay, "%s %.2f (MB)", GetMemoryTagName(graphTag), graphStats.liveBytes * toMB);
+    ImGui::PushItemWidth(-1);
+    ImGui::PlotLines("", tracker.GetHistory(graphTag), static_cast<int>(MemoryTracker::kHistorySize),
+        tracker.GetHistoryOffset(), overlay, 0.0f, scaleMax > 0.0f ? scaleMax : 1.0f, ImVec2(0, 50));
+    ImGui::PopItemWidth();
+
+    float budgetMB = graphStats.budgetBytes * toMB;
+    if (ImGui::InputFloat("Budget (MB)", &budgetMB, 1.0f, 16.0f, "%.1f"))
+    {
+        MemoryTracker::GetInstance().SetBudget(graphTag, static_cast<size_t>(std::max(budgetMB, 0.0f) / toMB));
+    }
+}
+
 void StatSystemComponent::Cleanup()
 {
 
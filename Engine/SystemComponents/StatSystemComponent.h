@@ -2,6 +2,7 @@
 
 #include "SystemComponentManager.h"
 #include "Core/ISystemComponent.h"
+#include "Core/ProfilerStats.h"
 
 class GameTime;
 
@@ -23,6 +24,11 @@ public:
 	void RenderUI() override;
 	void Cleanup() override;
 
+	// drains the profiler rings into GetProfilerStats. Only touches
+	// m_profilerStats, so it can run on a worker beside Update; the
+	// scope table reads it in RenderUI.
+	void UpdateProfilerStats();
+
 	float GetAverageFPS() const;
 	float GetAverageMS() const;
 
@@ -30,8 +36,16 @@ public:
 
 	void SetCustomInfoLog(const std::string& info);
 
+	// per scope timings over the last seconds, for code that checks budgets.
+	const ProfilerStats& GetProfilerStats() const { return m_profilerStats; }
+
 private:
+	void RenderFrameGraph();
+	void RenderMemory();
+	void RenderScopes();
+
 	GameTime* m_pGameTime;
+	Game* m_game = nullptr;
 
 	float m_renderCount = 0.0f;
 	float m_updateCount = 0.0f;
@@ -62,4 +76,12 @@ private:
 	bool open = true;
 
 	std::string m_info;
+
+	int m_memoryGraphTag = 0;
+
+	ProfilerStats m_profilerStats;
+	// column the scope table is sorted by, highest first.
+	int m_scopeSortColumn = 2;
+	bool m_hardwareCountersAvailable = false;
+	std::vector<const ProfilerStats::ScopeStats*> m_sortedScopes;
 };
\ No newline at end of file
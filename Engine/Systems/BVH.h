@@ -3,6 +3,7 @@
 
 #include "AABB.h"
 #include "Utils/MathUtils.h"
+#include "Core/Memory/PoolAllocator.h"
 
 #include <vector>
 #include <stack>
@@ -30,6 +31,14 @@ namespace bvh
 	{
 		static int nullIndex;
 
+		void Clear()
+		{
+			m_pool.Reset();
+			m_nodes.clear();
+			nodeCount = 0;
+			rootIndex = nullIndex;
+		}
+
 		void InsertNode(int objectIndex, AABB box)
 		{
 			int leafIndex = CreateNode(objectIndex, box);
@@ -98,7 +107,7 @@ namespace bvh
 
 		int CreateNode(int objectIndex, AABB box) 
 		{
-			Node* node = new Node();
+			Node* node = m_pool.construct();
 			node->box = box;
 			node->objectIndex = objectIndex;
 			node->child1 = nullIndex;
@@ -113,7 +122,7 @@ namespace bvh
 
 		int CreateInternalNode()
 		{
-			Node* node = new Node();
+			Node* node = m_pool.construct();
 			node->box = AABB();
 			node->objectIndex = nullIndex;
 			node->child1 = nullIndex;
@@ -129,6 +138,8 @@ namespace bvh
 		const std::vector<Node*>& GetNodes() const { return m_nodes; }
 
 		std::vector<Node*> m_nodes;
+		// owns the nodes m_nodes points at.
+		PoolAllocator<Node> m_pool;
 		Node* nodes;
 		int nodeCount;
 		int rootIndex;
@@ -7,6 +7,9 @@
 #include <algorithm>
 
 #include "Engine/Renderer/DebugDraw.h"
+#include "Core/Containers/SmallVector.h"
+#include "Core/JobScheduler/JobContext.h"
+#include "Core/Memory/PoolAllocator.h"
 
 struct Vec3ComparerX {
     bool operator()(const glm::vec3& lhs, const glm::vec3& rhs) const {
@@ -29,6 +32,9 @@ struct Vec3ComparerZ {
 struct kdtree
 {
     using NodeContent = std::pair<glm::vec3, size_t>;
+    // a range query rarely finds more than this, bigger ones spill to the
+    // job scratch, so results live only as long as the job or ScratchScope.
+    using QueryResults = SmallVector<NodeContent, 32, ScratchAllocator<NodeContent>>;
     struct node
     {
         size_t payload = 0;
@@ -43,9 +49,24 @@ struct kdtree
         root = nullptr;
     }
 
+    // HeapPerNode is for benchmarks against the pooled nodes.
+    explicit kdtree(PoolMode nodeMode)
+        : nodes(4096, nodeMode)
+    {
+    }
+
     kdtree(std::vector<NodeContent> points)
     {
-        root = build(points, 0);
+        rebuild(std::move(points));
+    }
+
+    // drops the old nodes and builds over points, reusing the node slabs.
+    void rebuild(std::vector<NodeContent> points)
+    {
+        nodes.Reset();
+        nodes.reserve(points.size());
+        best = nullptr;
+        root = build(points.data(), points.data() + points.size(), 0);
     }
 
     glm::vec3 nearest(glm::vec3 p)
@@ -59,17 +80,16 @@ struct kdtree
         return {};
     }
 
-    std::vector<NodeContent> nearest(glm::vec3 p, float range)
+    // every point within range of p, outResults is cleared first.
+    void nearest(glm::vec3 p, float range, QueryResults& outResults)
     {
-        if (root == nullptr) return {};
+        outResults.clear();
+        if (root == nullptr) return;
 
-        std::vector<NodeContent> results;
         best = nullptr;
         visited = 0;
         bestDistance = FLT_MAX;
-        nearest(root, p, range, results, 0);
-
-        return results;
+        nearest(root, p, range, outResults, 0);
     }
 
     void print()
@@ -131,43 +151,24 @@ private:
         GetAllHyperplanes(node->right, outResult);
     }
 
-    node* build(std::vector<NodeContent> points, int depth)
+    // median split of [first, last) on the depth's axis, in place.
+    node* build(NodeContent* first, NodeContent* last, int depth)
     {
-        if (points.empty()) { return nullptr; }
+        if (first == last) { return nullptr; }
 
-        uint8_t axis = depth % 3;
-        if (axis == 0)
-        {
-            std::sort(points.begin(), points.end(), 
-                [](const NodeContent& lhs, const NodeContent& rhs) {
-                return lhs.first.x < rhs.first.x;
+        const int axis = depth % 3;
+        NodeContent* median = first + (last - first) / 2;
+        std::nth_element(first, median, last,
+            [axis](const NodeContent& lhs, const NodeContent& rhs) {
+                return lhs.first[axis] < rhs.first[axis];
             });
-        }
-        else if (axis == 1)
-        {
-            std::sort(points.begin(), points.end(),
-                [](const NodeContent& lhs, const NodeContent& rhs) {
-                    return lhs.first.y < rhs.first.y;
-                });
-        }
-        else
-        {
-            std::sort(points.begin(), points.end(),
-                [](const NodeContent& lhs, const NodeContent& rhs) {
-                    return lhs.first.z < rhs.first.z;
-                });
-        }
 
-        const size_t medianCount = points.size() / 2;
-        std::vector<NodeContent> leftPoints(points.begin(), points.begin() + medianCount);
-        std::vector<NodeContent> rightPoints(points.begin() + medianCount + 1, points.end());
-
-        node* n = new node();
-        n->location = (points.begin() + medianCount)->first;
-        n->payload = (points.begin() + medianCount)->second;
-        n->left = build(leftPoints, ++depth);
-        n->right = build(rightPoints, ++depth);
+        node* n = nodes.construct();
+        n->location = median->first;
+        n->payload = median->second;
         n->axis = axis;
+        n->left = build(first, median, depth + 1);
+        n->right = build(median + 1, last, depth + 1);
         return n;
     }
 
@@ -203,7 +204,7 @@ private:
         nearest(dx > 0 ? root->right : root->left, p, index);
     }
 
-    void nearest(node* root, glm::vec3 p, float range, std::vector<NodeContent>& results, size_t index)
+    void nearest(node* root, glm::vec3 p, float range, QueryResults& results, size_t index)
     {
         if (root == nullptr) return;
 
@@ -221,11 +222,13 @@ private:
         index = ++index % 3; // 3 is xyz ( 3 dimensions )
 
         nearest(dx > 0 ? root->left : root->right, p, range, results, index);
-        if (dx * dx >= bestDistance) return;
+        if (dx * dx >= range * range) return;
         nearest(dx > 0 ? root->right : root->left, p, range, results, index);
     }
 
     node* root = nullptr;
+    // every node of the tree, nodes are only ever released all at once.
+    PoolAllocator<node> nodes{ 4096 };
 
     node* best = nullptr;
     float bestDistance = FLT_MAX;
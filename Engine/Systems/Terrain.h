@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include <future>
 #include <mutex>
@@ -9,8 +10,10 @@
 #include <glm/gtc/noise.hpp>
 
 #include "Mesh/Mesh.h"
-#include "Core/Containers/ThreadSafeQueue.h"
+#include "Core/JobScheduler/JobContext.h"
+#include "Core/JobScheduler/ParallelFor.h"
 #include "Core/CustomMutex.h"
+#include "Core/Memory/MemoryTracker.h"
 
 #include <queue>
 #include <iostream>
@@ -51,6 +54,9 @@ template<typename Mutex = std::mutex>
 class Terrain
 {
 public:
+	using VertexList = std::vector<VertexInfo, TrackedAllocator<VertexInfo, MemoryTag::Terrain>>;
+	using IndexList = std::vector<unsigned int, TrackedAllocator<unsigned int, MemoryTag::Terrain>>;
+
 	struct BlockJob
 	{
 		struct Verti { VertexInfo v; int i; };
@@ -58,7 +64,8 @@ public:
 		int rowEnd = 0;
 		int colSize = 0;
 		int index = 0;
-		std::vector<Verti> vertinfo;
+		// on the scratch of the job building the block, gone once it's written back.
+		std::vector<Verti, ScratchAllocator<Verti>> vertinfo;
 	};
 
 	Terrain();
@@ -73,10 +80,10 @@ public:
 
 	void GenerateMesh();
 
-	void GenerateTerrainBlock(int startRow, int endRow, int column, std::vector<VertexInfo>& vertices);
-	void GenerateTerrainBlock(BlockJob& job, std::vector<VertexInfo>& vertices);
+	void GenerateTerrainBlock(int startRow, int endRow, int column, VertexList& vertices);
+	void GenerateTerrainBlock(BlockJob& job, VertexList& vertices);
 
-	void CalculateNormals(const std::vector<unsigned int>& indices, std::vector<VertexInfo>& inOutVertices) const;
+	void CalculateNormals(const IndexList& indices, VertexList& inOutVertices) const;
 	void UpdateHeightMap();
 	void UpdateHeightMapFromImage(float* heightData);
 
@@ -86,7 +93,7 @@ public:
 	float GetHeightSize() { return m_heightSize; }
 
 private:
-	glm::vec3 CalculateNormalFromIndices(const std::vector<VertexInfo>& vertices, int a, int b, int c) const;
+	glm::vec3 CalculateNormalFromIndices(const VertexList& vertices, int a, int b, int c) const;
 	float GetPerlinNoise(const glm::vec2& pos) const;
 
 private:
@@ -97,8 +104,7 @@ private:
 
 	Mesh m_mesh;
 
-	std::mutex m_mutex;
-	std::condition_variable m_conditionVar;
+	Mutex m_mutex;
 };
 
 template<typename Mutex>
@@ -139,92 +145,32 @@ void Terrain<Mutex>::GenerateMesh()
 	int nVertsPerTris = nTiles * 6;
 
 	// Create mesh data
-	std::vector<VertexInfo> vertices;
+	VertexList vertices;
 	vertices.resize(nVerts);
 
-	std::vector<unsigned int> indices;
+	IndexList indices;
 	indices.resize(nVertsPerTris);
 
 #if MULTITHREAD
-	const int nThreads = std::thread::hardware_concurrency();
-	int launchedThreads = nThreads - 1;
-	int nRowsPerJob = std::min(5, length);
-	int nJobs = length / nRowsPerJob;
-	int leftOver = length % nThreads;
-
-	ThreadSafeQueue<BlockJob> jobQueue;
-	std::vector<BlockJob> jobsDone;
-	std::vector<std::thread> threads;
-
-	for (int i = 0; i < nJobs; ++i)
-	{
-		BlockJob job;
-		job.rowStart = i * nRowsPerJob;
-		job.rowEnd = job.rowStart + nRowsPerJob;
-		if (i == nThreads - 1)
-		{
-			job.rowEnd = job.rowStart + nRowsPerJob + leftOver;
-		}
-		job.colSize = width;
-		jobQueue.push(job);
-	}
-
-	std::atomic<int> finishedThreads{ 0 };
-	for (int i = 0; i < launchedThreads; ++i)
-	{
-		std::thread t([&]() {
-			bool hasWork = true;
-			while (hasWork)
-			{
-				hasWork = false;
-				BlockJob job;
-				hasWork = jobQueue.try_pop(job);
-				if (hasWork)
-				{
-					// quick/dirty way to find if a job is valid
-					if (job.rowStart < job.rowEnd)
-					{
-						GenerateTerrainBlock(job, vertices);
-						{
-							std::lock_guard<std::mutex> lock(m_mutex);
-							jobsDone.push_back(std::move(job));
-						}
-					}
-				}
-			}
-
-			// no more jobs.
-			if (jobQueue.empty())
-			{
-				std::lock_guard<std::mutex> lock(m_mutex);
-				finishedThreads++;
-				m_conditionVar.notify_one();
-			}
-			});
-		threads.push_back(std::move(t));
-	}
-
-	{
-		std::unique_lock<std::mutex> lock(m_mutex);
-		m_conditionVar.wait(lock, [&finishedThreads, &launchedThreads] {
-			return finishedThreads == launchedThreads;
-			});
-	}
-
-	for (std::thread& t : threads)
-	{
-		t.join();
-	}
+	// rows are independent, let the scheduler balance them. a few thousand
+	// tiles per chunk keep the noise work well above the cost of a job.
+	constexpr int kTilesPerChunk = 4096;
+	const size_t rowGrain = static_cast<size_t>(std::max(1, kTilesPerChunk / std::max(width, 1)));
+	ParallelForRange(0, static_cast<size_t>(length), rowGrain, [this, width, &vertices](size_t rowBegin, size_t rowEnd) {
+		BlockJob block;
+		block.rowStart = static_cast<int>(rowBegin);
+		block.rowEnd = static_cast<int>(rowEnd);
+		block.colSize = width;
+		GenerateTerrainBlock(block, vertices);
 
 #if !MUTEX_WRITE
-	for (BlockJob job : jobsDone)
-	{
-		for (BlockJob::Verti verti : job.vertinfo)
+		// rows don't overlap, so blocks can write back without locking.
+		for (const BlockJob::Verti& verti : block.vertinfo)
 		{
 			vertices[verti.i] = verti.v;
 		}
-	}
 #endif
+		});
 
 #else 
 	GenerateTerrainBlock(0, length, width, vertices);
@@ -261,7 +207,7 @@ void Terrain<Mutex>::GenerateMesh()
 }
 
 template<typename Mutex>
-void Terrain<Mutex>::GenerateTerrainBlock(int startRow, int endRow, int column, std::vector<VertexInfo>& vertices)
+void Terrain<Mutex>::GenerateTerrainBlock(int startRow, int endRow, int column, VertexList& vertices)
 {
 	for (int z = startRow; z < endRow; ++z)
 	{
@@ -299,8 +245,12 @@ void Terrain<Mutex>::GenerateTerrainBlock(int startRow, int endRow, int column,
 }
 
 template<typename Mutex>
-void Terrain<Mutex>::GenerateTerrainBlock(BlockJob& job, std::vector<VertexInfo>& vertices)
+void Terrain<Mutex>::GenerateTerrainBlock(BlockJob& job, VertexList& vertices)
 {
+#if !MUTEX_WRITE
+	job.vertinfo.reserve(static_cast<size_t>(job.rowEnd - job.rowStart) * job.colSize * 4);
+#endif
+
 	for (int z = job.rowStart; z < job.rowEnd; ++z)
 	{
 		for (int x = 0; x < job.colSize; ++x)
@@ -349,7 +299,7 @@ void Terrain<Mutex>::GenerateTerrainBlock(BlockJob& job, std::vector<VertexInfo>
 			job.vertinfo.push_back(vi3);
 #else
 			{
-				std::lock_guard<std::mutex> lock(m_mutex);
+				std::lock_guard<Mutex> lock(m_mutex);
 				vertices[index + 0].Position = v0;
 				vertices[index + 1].Position = v1;
 				vertices[index + 2].Position = v2;
@@ -372,7 +322,7 @@ void Terrain<Mutex>::GenerateTerrainBlock(BlockJob& job, std::vector<VertexInfo>
 }
 
 template<typename Mutex>
-void Terrain<Mutex>::CalculateNormals(const std::vector<unsigned int>& indices, std::vector<VertexInfo>& inOutVertices) const
+void Terrain<Mutex>::CalculateNormals(const IndexList& indices, VertexList& inOutVertices) const
 {
 	const unsigned int indicesSize = static_cast<unsigned int>(indices.size() / 3);
 	const unsigned int verticesSize = static_cast<unsigned int>(inOutVertices.size());
@@ -455,7 +405,7 @@ void Terrain<Mutex>::UpdateHeightMapFromImage(float* heightData)
 }
 
 template<typename Mutex>
-glm::vec3 Terrain<Mutex>::CalculateNormalFromIndices(const std::vector<VertexInfo>& vertices, int a, int b, int c) const
+glm::vec3 Terrain<Mutex>::CalculateNormalFromIndices(const VertexList& vertices, int a, int b, int c) const
 {
 	glm::vec3 pA = vertices[a].Position;
 	glm::vec3 pB = vertices[b].Position;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <algorithm>
 #include <vector>
 #include <cstdlib>
@@ -53,9 +54,11 @@ namespace Utils
 		return result;
 	}
 
-	static unsigned int Hash(const std::string& text)
+	// same value as std::hash<std::string> and StringHash, so it can be
+	// passed to a FlatHashMap's find(key, hash).
+	static size_t Hash(std::string_view text)
 	{
-		return static_cast<unsigned int>(std::hash<std::string>{}(text));
+		return std::hash<std::string_view>{}(text);
 	}
 }
 
@@ -18,6 +18,12 @@ SDLHandler::SDLHandler()
 
 SDLHandler::~SDLHandler()
 {
+	// never initialized, a headless Game.
+	if (!m_window)
+	{
+		return;
+	}
+
 	SaveWindowParams();
 
 	m_uiHandler.Cleanup();
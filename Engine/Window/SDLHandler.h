@@ -77,8 +77,8 @@ private:
 	WindowParams m_windowParams;
 	WindowParams m_tempWindowParams;
 
-	SDL_Window* m_window;
-	SDL_GLContext m_mainGLContext;
+	SDL_Window* m_window = nullptr;
+	SDL_GLContext m_mainGLContext = nullptr;
 
 	IMGUIHandler m_uiHandler;
 
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "../TestRunner.h"
+
+#include "Core/Containers/FlatHashMap.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Uniform lookups the way a frame does them: one small map per shader /
+// material, hit with its own names plus the per object ones every draw
+// sets (model, view, ...) that some shaders don't have. The key sets are
+// the uniforms declared in Data/Shaders, one set per file.
+namespace FlatHashMapBenchDetail
+{
+    // Data/Shaders at the time of writing, in case the folder isn't next to the binary.
+    static const char* s_fallbackNames[] = {
+        "BRDFLUT", "Bloom", "CamPos", "HDRScene", "MotionBlur", "MotionSamples", "MotionScale", "PlasmaColor",
+        "Position", "PrefilterMap", "SSAO", "SSR", "Sepia", "ShadowsEnabled", "Speed", "Strength",
+        "TexAO", "TexAlbedo", "TexBloom1", "TexBloom2", "TexBloom3", "TexBloom4", "TexMetallic", "TexNormal",
+        "TexPerllin", "TexRoughness", "TexSSAO", "TexSrc", "Time", "Vignette", "background", "envIrradiance",
+        "envPrefilter", "environment", "gAlbedoAO", "gMotion", "gNormalRoughness", "gPositionMetallic", "horizontal", "kernel",
+        "lightColor", "lightDir", "lightPos", "lightRadius", "lightShadowMap", "lightShadowMap1", "lightShadowViewProjection", "lightShadowViewProjection1",
+        "lodLevel", "model", "nrProbes", "prevModel", "probe1AABBMax", "probe1AABBMin", "probe1Center", "probe1Irradiance",
+        "probe1Prefilter", "probe2AABBMax", "probe2AABBMin", "probe2Center", "probe2Irradiance", "probe2Prefilter", "probePos", "probeRadius",
+        "projection", "renderSize", "roughness", "sampleCount", "skyIrradiance", "skyPrefilter", "texNoise", "view",
+    };
+
+    static const char* s_perDrawNames[] = { "model", "prevModel", "view", "projection", "CamPos" };
+
+    // "uniform <type> <name>" per file, array brackets and ';' stripped.
+    inline std::vector<std::vector<std::string>> LoadShaderUniforms()
+    {
+        std::vector<std::vector<std::string>> sets;
+        for (const char* root : { "../Data/Shaders", "Data/Shaders", "../../Data/Shaders" })
+        {
+            std::error_code error;
+            if (!std::filesystem::is_directory(root, error))
+            {
+                continue;
+            }
+
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(root, error))
+            {
+                if (!entry.is_regular_file()) { continue; }
+
+                std::ifstream file(entry.path());
+                std::vector<std::string> names;
+                std::string word;
+                while (file >> word)
+                {
+                    if (word != "uniform") { continue; }
+
+                    std::string type, name;
+                    file >> type >> name;
+                    name = name.substr(0, name.find_first_of("[;"));
+                    if (!name.empty()) { names.push_back(name); }
+                }
+
+                if (!names.empty()) { sets.push_back(names); }
+            }
+            break;
+        }
+
+        if (sets.empty())
+        {
+            const size_t count = sizeof(s_fallbackNames) / sizeof(s_fallbackNames[0]);
+            for (size_t i = 0; i < count; i += 8)
+            {
+                sets.emplace_back(s_fallbackNames + i, s_fallbackNames + std::min(i + 8, count));
+            }
+        }
+        return sets;
+    }
+
+    // the value stands in for UniformValue / a uniform location.
+    template<typename Map>
+    struct StringKeys
+    {
+        void Add(const std::string& name, int value) { m_map[name] = value; }
+
+        int Find(const std::string& name, uint32_t) const
+        {
+            auto it = m_map.find(name);
+            return it != m_map.end() ? it->second : -1;
+        }
+
+        Map m_map;
+    };
+
+    // keyed by the name's hash like Shader::m_uniformMap, the hash comes precomputed.
+    template<typename Map>
+    struct HashKeys
+    {
+        void Add(const std::string& name, int value) { m_map[static_cast<uint32_t>(std::hash<std::string>{}(name))] = value; }
+
+        int Find(const std::string&, uint32_t hash) const
+        {
+            auto it = m_map.find(hash);
+            return it != m_map.end() ? it->second : -1;
+        }
+
+        Map m_map;
+    };
+
+    using StdMapStrings = StringKeys<std::map<std::string, int>>;
+    using UnorderedStrings = StringKeys<std::unordered_map<std::string, int>>;
+    using FlatStrings = StringKeys<FlatHashMap<std::string, int, StringHash, std::equal_to<>>>;
+    using UnorderedHashes = HashKeys<std::unordered_map<uint32_t, int>>;
+    using FlatHashes = HashKeys<FlatHashMap<uint32_t, int, IdentityHash>>;
+}
+
+template<typename Lookup>
+struct FlatHashMapBench
+    : BaseTest
+{
+    FlatHashMapBench(const char* name, size_t draws = 100000)
+        : m_drawCount(draws)
+    {
+        TestName = name;
+    }
+
+    void Init() override
+    {
+        m_maps.clear();
+        m_queries.clear();
+
+        for (const std::vector<std::string>& names : FlatHashMapBenchDetail::LoadShaderUniforms())
+        {
+            Lookup lookup;
+            std::vector<Query> queries;
+            for (size_t i = 0; i < names.size(); ++i)
+            {
+                lookup.Add(names[i], static_cast<int>(i));
+                queries.push_back(MakeQuery(names[i]));
+            }
+            for (const char* name : FlatHashMapBenchDetail::s_perDrawNames)
+            {
+                queries.push_back(MakeQuery(name));
+            }
+
+            m_maps.push_back(std::move(lookup));
+            m_queries.push_back(std::move(queries));
+        }
+
+        m_lookups = 0;
+        m_checksum = 0;
+    }
+
+    void Run() override
+    {
+        int64_t sum = 0;
+        for (size_t draw = 0; draw < m_drawCount; ++draw)
+        {
+            const size_t shader = draw % m_maps.size();
+            const Lookup& lookup = m_maps[shader];
+            for (const Query& query : m_queries[shader])
+            {
+                sum += lookup.Find(query.name, query.hash);
+            }
+            m_lookups += m_queries[shader].size();
+        }
+        m_checksum += sum;
+    }
+
+    void Report() override
+    {
+        printf("    %zu shaders, %zu lookups (checksum %lld)\n", m_maps.size(), m_lookups, static_cast<long long>(m_checksum));
+    }
+
+    struct Query
+    {
+        std::string name;
+        uint32_t hash = 0;
+    };
+
+    static Query MakeQuery(const std::string& name)
+    {
+        return Query{ name, static_cast<uint32_t>(std::hash<std::string>{}(name)) };
+    }
+
+    std::vector<Lookup> m_maps;
+    std::vector<std::vector<Query>> m_queries;
+
+    size_t m_drawCount = 0;
+    size_t m_lookups = 0;
+    int64_t m_checksum = 0;
+};
+
+using StdMapUniformBench = FlatHashMapBench<FlatHashMapBenchDetail::StdMapStrings>;
+using UnorderedMapUniformBench = FlatHashMapBench<FlatHashMapBenchDetail::UnorderedStrings>;
+using FlatMapUniformBench = FlatHashMapBench<FlatHashMapBenchDetail::FlatStrings>;
+using UnorderedHashUniformBench = FlatHashMapBench<FlatHashMapBenchDetail::UnorderedHashes>;
+using FlatHashUniformBench = FlatHashMapBench<FlatHashMapBenchDetail::FlatHashes>;
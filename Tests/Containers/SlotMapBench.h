@@ -0,0 +1,216 @@
+#pragma once
+
+#include "../TestRunner.h"
+
+#include "Core/Containers/SlotMap.h"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Iterate everything, then look up random live entries, in a container
+// that has been through erase / insert churn like the scene and resource
+// lists. The maps key on an id, as Resources does with hashed names; the
+// slot map goes through handles.
+namespace SlotMapBenchDetail
+{
+    // about a scene node's transform and bounds.
+    struct Item
+    {
+        float transform[16] = {};
+        float boxMin[3] = {};
+        float boxMax[3] = {};
+        uint32_t id = 0;
+    };
+
+    template<typename Map>
+    struct KeyedMap
+    {
+        using Key = uint32_t;
+
+        Key Insert(uint32_t id, const Item& item) { m_map.emplace(id, item); return id; }
+        void Erase(Key key) { m_map.erase(key); }
+        const Item* Find(Key key) const
+        {
+            auto it = m_map.find(key);
+            return it != m_map.end() ? &it->second : nullptr;
+        }
+
+        template<typename F>
+        void ForEach(F&& f) const
+        {
+            for (const auto& entry : m_map) { f(entry.second); }
+        }
+
+        void Clear() { m_map.clear(); }
+
+        Map m_map;
+    };
+
+    using StdMap = KeyedMap<std::map<uint32_t, Item>>;
+    using UnorderedMap = KeyedMap<std::unordered_map<uint32_t, Item>>;
+
+    struct Slots
+    {
+        using Key = SlotHandle;
+
+        Key Insert(uint32_t, const Item& item) { return m_map.insert(item); }
+        void Erase(Key key) { m_map.erase(key); }
+        const Item* Find(Key key) const { return m_map.get(key); }
+
+        template<typename F>
+        void ForEach(F&& f) const
+        {
+            for (const Item& item : m_map) { f(item); }
+        }
+
+        void Clear() { m_map.clear(); }
+
+        SlotMap<Item> m_map;
+    };
+}
+
+template<typename Container>
+struct SlotMapBench
+    : BaseTest
+{
+    SlotMapBench(const char* name, size_t count, size_t lookups = 100000)
+        : m_count(count)
+        , m_lookupCount(lookups)
+    {
+        TestName = std::string(name) + "_" + std::to_string(count);
+    }
+
+    void Init() override
+    {
+        m_container.Clear();
+        m_keys.clear();
+
+        std::mt19937 rng(1337);
+        uint32_t nextId = 1;
+        for (size_t i = 0; i < m_count; ++i)
+        {
+            m_keys.push_back(Insert(nextId++));
+        }
+
+        // half the entries replaced in random order, ids keep growing.
+        for (size_t i = 0; i < m_count / 2; ++i)
+        {
+            const size_t slot = rng() % m_keys.size();
+            m_container.Erase(m_keys[slot]);
+            m_keys[slot] = Insert(nextId++);
+        }
+
+        m_lookups.resize(m_lookupCount);
+        for (typename Container::Key& key : m_lookups) { key = m_keys[rng() % m_keys.size()]; }
+
+        m_iterateMs = m_lookupMs = 0.0;
+        m_runs = 0;
+        m_checksum = 0.0f;
+    }
+
+    void Run() override
+    {
+        using Clock = std::chrono::steady_clock;
+
+        const Clock::time_point iterateStart = Clock::now();
+        float sum = 0.0f;
+        for (int pass = 0; pass < 10; ++pass)
+        {
+            m_container.ForEach([&sum](const SlotMapBenchDetail::Item& item) { sum += item.transform[12] + item.boxMax[1]; });
+        }
+
+        const Clock::time_point lookupStart = Clock::now();
+        for (const typename Container::Key& key : m_lookups)
+        {
+            if (const SlotMapBenchDetail::Item* item = m_container.Find(key)) { sum += item->transform[13]; }
+        }
+
+        const Clock::time_point lookupEnd = Clock::now();
+        m_iterateMs += std::chrono::duration<double, std::milli>(lookupStart - iterateStart).count();
+        m_lookupMs += std::chrono::duration<double, std::milli>(lookupEnd - lookupStart).count();
+        m_checksum += sum;
+        ++m_runs;
+    }
+
+    void Report() override
+    {
+        const double runs = static_cast<double>(m_runs > 0 ? m_runs : 1);
+        printf("    iterate x10 %.3f ms, %zu lookups %.3f ms (checksum %.1f)\n",
+            m_iterateMs / runs, m_lookupCount, m_lookupMs / runs, m_checksum);
+    }
+
+    typename Container::Key Insert(uint32_t id)
+    {
+        SlotMapBenchDetail::Item item;
+        item.id = id;
+        item.transform[12] = static_cast<float>(id % 97);
+        item.transform[13] = static_cast<float>(id % 31);
+        item.boxMax[1] = 1.0f;
+        return m_container.Insert(id, item);
+    }
+
+    Container m_container;
+    std::vector<typename Container::Key> m_keys;
+    std::vector<typename Container::Key> m_lookups;
+
+    size_t m_count = 0;
+    size_t m_lookupCount = 0;
+
+    double m_iterateMs = 0.0;
+    double m_lookupMs = 0.0;
+    size_t m_runs = 0;
+    float m_checksum = 0.0f;
+};
+
+using StdMapBench = SlotMapBench<SlotMapBenchDetail::StdMap>;
+using UnorderedMapBench = SlotMapBench<SlotMapBenchDetail::UnorderedMap>;
+
+struct SlotMapContainerBench
+    : SlotMapBench<SlotMapBenchDetail::Slots>
+{
+    using SlotMapBench::SlotMapBench;
+
+    void Init() override
+    {
+        SlotMapBench::Init();
+        CheckSlotMap();
+    }
+
+    // stale handles, slot reuse, packing after erase and clear.
+    void CheckSlotMap()
+    {
+        SlotMap<int> map;
+        const SlotHandle a = map.insert(1);
+        const SlotHandle b = map.insert(2);
+        const SlotHandle c = map.insert(3);
+        Check(map.size() == 3 && map[b] == 2, "inserted values");
+
+        Check(map.erase(a), "erase");
+        Check(!map.erase(a), "second erase of a handle fails");
+        Check(!map.contains(a) && map.get(a) == nullptr, "erased handle is stale");
+        Check(map.size() == 2 && map[c] == 3 && map[b] == 2, "others kept after erase");
+
+        // the freed slot is reused with a new generation.
+        const SlotHandle d = map.insert(4);
+        Check(d.index == a.index && d.generation != a.generation, "slot reused with a new generation");
+        Check(map.get(a) == nullptr && map[d] == 4, "stale handle misses the reused slot");
+
+        int sum = 0;
+        for (int value : map) { sum += value; }
+        Check(sum == 2 + 3 + 4, "iteration");
+
+        for (size_t i = 0; i < map.size(); ++i)
+        {
+            Check(map.get(map.handle_at(i)) == map.data() + i, "handle_at");
+        }
+
+        map.clear();
+        Check(map.empty() && !map.contains(b) && !map.contains(c) && !map.contains(d), "clear");
+        Check(!map.contains(SlotHandle{}), "invalid handle");
+    }
+};
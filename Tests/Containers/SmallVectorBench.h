@@ -0,0 +1,158 @@
+#pragma once
+
+#include "../TestRunner.h"
+
+#include "Core/Containers/SmallVector.h"
+#include "Core/Containers/VectorContainer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Neighbor gathering the way the boid and tree queries do it: a fresh
+// list per query, filled with the indices of the points in range, read
+// once and dropped. Most queries find a handful, a few find a crowd.
+namespace SmallVectorBenchDetail
+{
+    struct Point
+    {
+        float x = 0.0f;
+        float y = 0.0f;
+        float z = 0.0f;
+    };
+
+    using StdList = std::vector<size_t>;
+    using SmallList = SmallVector<size_t, 32>;
+}
+
+template<typename List>
+struct SmallVectorBench
+    : BaseTest
+{
+    SmallVectorBench(const char* name, size_t points = 4000, size_t queries = 2000)
+        : m_pointCount(points)
+        , m_queryCount(queries)
+    {
+        TestName = name;
+    }
+
+    void Init() override
+    {
+        std::mt19937 rng(1337);
+        std::uniform_real_distribution<float> coord(0.0f, 100.0f);
+
+        // a dense cluster in one corner, so some queries spill.
+        m_points.resize(m_pointCount);
+        for (size_t i = 0; i < m_pointCount; ++i)
+        {
+            const float scale = i % 10 == 0 ? 0.1f : 1.0f;
+            m_points[i] = { coord(rng) * scale, coord(rng) * scale, coord(rng) * scale };
+        }
+
+        m_queries.resize(m_queryCount);
+        for (SmallVectorBenchDetail::Point& query : m_queries) { query = { coord(rng), coord(rng), coord(rng) }; }
+
+        m_found = 0;
+        m_checksum = 0;
+    }
+
+    void Run() override
+    {
+        const float rangeSq = 8.0f * 8.0f;
+        for (const SmallVectorBenchDetail::Point& query : m_queries)
+        {
+            List neighbors;
+            for (size_t i = 0; i < m_points.size(); ++i)
+            {
+                const float dx = m_points[i].x - query.x;
+                const float dy = m_points[i].y - query.y;
+                const float dz = m_points[i].z - query.z;
+                if (dx * dx + dy * dy + dz * dz < rangeSq) { neighbors.push_back(i); }
+            }
+
+            for (size_t index : neighbors) { m_checksum += index; }
+            m_found += neighbors.size();
+        }
+    }
+
+    void Report() override
+    {
+        printf("    %zu queries, %zu neighbors (checksum %llu)\n", m_queries.size(), m_found, static_cast<unsigned long long>(m_checksum));
+    }
+
+    std::vector<SmallVectorBenchDetail::Point> m_points;
+    std::vector<SmallVectorBenchDetail::Point> m_queries;
+
+    size_t m_pointCount = 0;
+    size_t m_queryCount = 0;
+    size_t m_found = 0;
+    uint64_t m_checksum = 0;
+};
+
+using StdVectorNeighborBench = SmallVectorBench<SmallVectorBenchDetail::StdList>;
+
+struct SmallVectorNeighborBench
+    : SmallVectorBench<SmallVectorBenchDetail::SmallList>
+{
+    using SmallVectorBench::SmallVectorBench;
+
+    void Init() override
+    {
+        SmallVectorBench::Init();
+        CheckSmallVector();
+        CheckVectorContainer();
+    }
+
+    // inline to heap, moves of both, erase, span assign, non trivial elements.
+    void CheckSmallVector()
+    {
+        SmallVector<int, 4> values;
+        for (int i = 0; i < 4; ++i) { values.push_back(i); }
+        Check(values.is_inline() && values.size() == 4, "inline up to N");
+
+        values.push_back(values[0]); // aliases the buffer that is about to move
+        Check(!values.is_inline() && values.size() == 5 && values[4] == 0, "push_back of an element to the heap");
+
+        SmallVector<int, 4> heapMoved(std::move(values));
+        Check(heapMoved.size() == 5 && values.empty() && values.is_inline(), "heap move");
+
+        const int span[] = { 7, 8, 9 };
+        values.assign_from_span(span, 3);
+        Check(values.is_inline() && values.size() == 3 && values[2] == 9, "span assign");
+
+        SmallVector<int, 4> inlineMoved;
+        inlineMoved = std::move(values);
+        Check(inlineMoved.size() == 3 && inlineMoved[0] == 7 && inlineMoved.is_inline(), "inline move");
+
+        heapMoved.erase(std::remove_if(heapMoved.begin(), heapMoved.end(), [](int v) { return v % 2 == 0; }), heapMoved.end());
+        Check(heapMoved.size() == 2 && heapMoved[0] == 1 && heapMoved[1] == 3, "erase remove_if");
+
+        SmallVector<int, 4> copy(heapMoved);
+        copy.assign_from_span(std::vector<int>{ 1, 2, 3, 4, 5, 6 });
+        Check(copy.size() == 6 && copy.back() == 6 && heapMoved.size() == 2, "copy then span assign");
+
+        SmallVector<std::unique_ptr<std::string>, 2> owners;
+        for (int i = 0; i < 5; ++i) { owners.emplace_back(std::make_unique<std::string>(std::to_string(i))); }
+        owners.erase(owners.begin() + 1);
+        SmallVector<std::unique_ptr<std::string>, 2> ownersMoved(std::move(owners));
+        Check(ownersMoved.size() == 4 && *ownersMoved[1] == "2" && *ownersMoved.back() == "4", "non trivial elements");
+    }
+
+    // fills to capacity, end() and get() follow the fill level.
+    void CheckVectorContainer()
+    {
+        VectorContainer<int> container(3);
+        container.insert(1);
+        container.insert(2);
+        container.insert(3);
+
+        int sum = 0;
+        for (int value : container) { sum += value; }
+
+        Check(container.size() == 3 && container.free_space() == 0 && sum == 6 && container.get(2) == 3, "VectorContainer fill");
+        free(container.m_data);
+    }
+};
@@ -0,0 +1,67 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<size_t> s_count{ 0 };
+    std::atomic<size_t> s_bytes{ 0 };
+
+    void* CountedAlloc(size_t size)
+    {
+        s_count.fetch_add(1, std::memory_order_relaxed);
+        s_bytes.fetch_add(size, std::memory_order_relaxed);
+        void* ptr = std::malloc(size > 0 ? size : 1);
+        if (!ptr)
+        {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+
+    // std::pmr::new_delete_resource and over aligned types come through here.
+    void* CountedAlignedAlloc(size_t size, std::align_val_t alignment)
+    {
+        s_count.fetch_add(1, std::memory_order_relaxed);
+        s_bytes.fetch_add(size, std::memory_order_relaxed);
+        const size_t align = static_cast<size_t>(alignment);
+#ifdef _WIN32
+        void* ptr = _aligned_malloc(size > 0 ? size : 1, align);
+#else
+        void* ptr = std::aligned_alloc(align, (size + align - 1) / align * align + (size == 0 ? align : 0));
+#endif
+        if (!ptr)
+        {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+
+    void AlignedFree(void* ptr)
+    {
+#ifdef _WIN32
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+}
+
+size_t AllocationCounter::GetCount() { return s_count.load(std::memory_order_relaxed); }
+size_t AllocationCounter::GetBytes() { return s_bytes.load(std::memory_order_relaxed); }
+
+void* operator new(size_t size) { return CountedAlloc(size); }
+void* operator new[](size_t size) { return CountedAlloc(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+
+void* operator new(size_t size, std::align_val_t alignment) { return CountedAlignedAlloc(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return CountedAlignedAlloc(size, alignment); }
+void operator delete(void* ptr, std::align_val_t) noexcept { AlignedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { AlignedFree(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { AlignedFree(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { AlignedFree(ptr); }
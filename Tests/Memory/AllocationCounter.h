@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+
+// Counts every global operator new made by the test executable.
+// The replacement operators live in AllocationCounter.cpp.
+namespace AllocationCounter
+{
+    size_t GetCount();
+    size_t GetBytes();
+
+    // allocations made since construction, on any thread.
+    struct Scope
+    {
+        Scope()
+            : m_count(GetCount())
+            , m_bytes(GetBytes())
+        {
+        }
+
+        size_t Count() const { return GetCount() - m_count; }
+        size_t Bytes() const { return GetBytes() - m_bytes; }
+
+    private:
+        size_t m_count;
+        size_t m_bytes;
+    };
+}
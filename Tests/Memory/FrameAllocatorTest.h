@@ -0,0 +1,107 @@
+#pragma once
+
+#include "../TestRunner.h"
+#include "AllocationCounter.h"
+
+#include "Core/Memory/LinearAllocator.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+// Per frame temporary arrays (culling lists, neighbor lists, ...) from
+// malloc versus from the double buffered FrameAllocator.
+struct ScratchArraysTest
+    : BaseTest
+{
+    void Run() override
+    {
+        for (size_t frame = 0; frame < m_frames; ++frame)
+        {
+            BeginFrame();
+            for (size_t i = 0; i < m_arraysPerFrame; ++i)
+            {
+                const size_t count = 16 + (i * 37) % 512;
+                uint32_t* data = Allocate(count);
+                for (size_t n = 0; n < count; ++n) { data[n] = static_cast<uint32_t>(n); }
+                m_checksum += data[count - 1];
+                Free(data);
+            }
+        }
+    }
+
+    virtual void BeginFrame() {}
+    virtual uint32_t* Allocate(size_t count) = 0;
+    virtual void Free(uint32_t* data) = 0;
+
+    size_t m_frames = 1000;
+    size_t m_arraysPerFrame = 256;
+    uint64_t m_checksum = 0;
+};
+
+struct MallocScratchTest
+    : ScratchArraysTest
+{
+    GENERIC_TEST_CTOR(MallocScratchTest);
+
+    void Init() override {}
+    uint32_t* Allocate(size_t count) override { return static_cast<uint32_t*>(malloc(count * sizeof(uint32_t))); }
+    void Free(uint32_t* data) override { free(data); }
+};
+
+struct FrameAllocatorScratchTest
+    : ScratchArraysTest
+{
+    GENERIC_TEST_CTOR(FrameAllocatorScratchTest);
+
+    void Init() override
+    {
+        m_allocations = 0;
+        CheckMarkers();
+    }
+
+    void Run() override
+    {
+        AllocationCounter::Scope scope;
+        ScratchArraysTest::Run();
+        m_allocations += scope.Count();
+    }
+
+    void Report() override
+    {
+        printf("    %zu heap allocations, peak %zu bytes per frame\n", m_allocations, m_frameAllocator.Current().peak_size());
+    }
+
+    void BeginFrame() override { m_frameAllocator.BeginFrame(); }
+    uint32_t* Allocate(size_t count) override { return m_frameAllocator.allocate_array<uint32_t>(count); }
+    void Free(uint32_t*) override {}
+
+    // alignment, marker rollback and the two frame lifetime.
+    void CheckMarkers()
+    {
+        LinearAllocator allocator(4096);
+
+        allocator.allocate(1, 1);
+        void* aligned = allocator.allocate(64, 64);
+        Check(reinterpret_cast<uintptr_t>(aligned) % 64 == 0, "alignment");
+
+        const LinearAllocator::Marker marker = allocator.GetMarker();
+        {
+            ScopedLinearMarker scope(allocator);
+            Check(allocator.allocate(1024) != nullptr, "allocation inside a marker");
+        }
+        Check(allocator.GetMarker() == marker, "marker rolled back");
+        Check(allocator.allocate(8192) == nullptr, "no allocation past the end");
+
+        FrameAllocator frames(1024);
+        frames.BeginFrame();
+        int* previous = frames.allocate_array<int>(4);
+        previous[0] = 42;
+        frames.BeginFrame();
+        frames.allocate_array<int>(4);
+        Check(frames.Previous().owns(previous) && previous[0] == 42, "previous frame kept");
+    }
+
+    FrameAllocator m_frameAllocator{ static_cast<size_t>(DefaultSize::OneMB) };
+    size_t m_allocations = 0;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../TestRunner.h"
+#include "AllocationCounter.h"
+
+#include "Core/JobScheduler/ParallelFor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+// Submitting jobs must not touch the heap once the scheduler is up:
+// lambda jobs come from the per thread JobPool and their captures are
+// stored inline. Counts global allocations around a burst of submissions.
+struct JobAllocationTest
+    : BaseTest
+{
+    GENERIC_TEST_CTOR(JobAllocationTest);
+
+    ~JobAllocationTest() override
+    {
+        m_scheduler.Cleanup();
+    }
+
+    void Init() override
+    {
+        m_scheduler.Init(std::max(std::thread::hardware_concurrency(), 2u));
+        m_allocations = 0;
+        m_bytes = 0;
+        m_jobs = 0;
+
+        // warm up, the pool threads may allocate on their first run, and
+        // their profiler rings on the first scope they record.
+        Submit();
+        ParallelFor(0, m_jobCount, 16, [this](size_t i) { m_sum.fetch_add(i, std::memory_order_relaxed); }, m_scheduler);
+    }
+
+    void Run() override
+    {
+        AllocationCounter::Scope scope;
+        Submit();
+        ParallelFor(0, m_jobCount, 16, [this](size_t i) { m_sum.fetch_add(i, std::memory_order_relaxed); }, m_scheduler);
+
+        m_allocations += scope.Count();
+        m_bytes += scope.Bytes();
+        m_jobs += m_jobCount;
+    }
+
+    void Report() override
+    {
+        printf("    %zu jobs submitted, %zu allocations (%zu bytes)\n", m_jobs, m_allocations, m_bytes);
+        Check(m_allocations == 0, "no allocations once the pool threads are warm");
+    }
+
+    void Submit()
+    {
+        JobCounter counter;
+        for (size_t i = 0; i < m_jobCount; ++i)
+        {
+            // captures more than std::function keeps inline.
+            const size_t a = i, b = i * 2, c = i * 3;
+            m_scheduler.AddJob([this, a, b, c]() { m_sum.fetch_add(a + b + c, std::memory_order_relaxed); }, &counter);
+        }
+        m_scheduler.WaitForCounter(&counter);
+    }
+
+    JobScheduler m_scheduler;
+    size_t m_jobCount = 10000;
+    std::atomic<size_t> m_sum{ 0 };
+
+    size_t m_allocations = 0;
+    size_t m_bytes = 0;
+    size_t m_jobs = 0;
+};
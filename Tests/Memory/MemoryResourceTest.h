@@ -0,0 +1,130 @@
+#pragma once
+
+#include "../TestRunner.h"
+#include "AllocationCounter.h"
+
+#include "Core/Memory/MemoryResource.h"
+
+#include <cstdint>
+#include <map>
+#include <memory_resource>
+#include <vector>
+
+// Short lived per query lists and a per frame map of lists, the shapes
+// CommandBuffer and the boid queries produce, on a given memory resource.
+struct PmrContainersTest
+    : BaseTest
+{
+    void Run() override
+    {
+        AllocationCounter::Scope scope;
+        std::pmr::memory_resource* memory = GetResource();
+
+        for (size_t frame = 0; frame < m_frames; ++frame)
+        {
+            std::pmr::map<uint32_t, std::pmr::vector<uint32_t>> lists(memory);
+            for (uint32_t i = 0; i < m_queriesPerFrame; ++i)
+            {
+                std::pmr::vector<uint32_t> result(memory);
+                const uint32_t count = 4 + (i * 37) % 120;
+                for (uint32_t n = 0; n < count; ++n) { result.push_back(n); }
+                m_checksum += result.back();
+
+                lists[i % 16].push_back(count);
+            }
+            EndFrame();
+        }
+
+        m_allocations += scope.Count();
+    }
+
+    void Report() override
+    {
+        printf("    %zu heap allocations\n", m_allocations);
+    }
+
+    virtual std::pmr::memory_resource* GetResource() = 0;
+    virtual void EndFrame() {}
+
+    size_t m_frames = 200;
+    uint32_t m_queriesPerFrame = 1000;
+    uint64_t m_checksum = 0;
+    size_t m_allocations = 0;
+};
+
+struct DefaultResourceTest
+    : PmrContainersTest
+{
+    GENERIC_TEST_CTOR(DefaultResourceTest);
+
+    void Init() override { m_allocations = 0; }
+    std::pmr::memory_resource* GetResource() override { return std::pmr::new_delete_resource(); }
+};
+
+struct PoolResourceTest
+    : PmrContainersTest
+{
+    GENERIC_TEST_CTOR(PoolResourceTest);
+
+    void Init() override
+    {
+        m_allocations = 0;
+        CheckResources();
+    }
+
+    void Report() override
+    {
+        const MemoryResourceStats& stats = m_pool.GetStats();
+        printf("    %zu heap allocations, %zu upstream, peak %zu bytes, %zu in use\n",
+            m_allocations, stats.upstreamAllocations, stats.peakBytes, stats.bytesInUse);
+    }
+
+    std::pmr::memory_resource* GetResource() override { return &m_pool; }
+
+    // alignment, fallback to upstream and the stats.
+    void CheckResources()
+    {
+        PoolMemoryResource pool;
+        void* small = pool.allocate(24, 8);
+        void* aligned = pool.allocate(64, 64);
+        void* large = pool.allocate(8192);
+        Check(reinterpret_cast<uintptr_t>(aligned) % 64 == 0, "pool alignment");
+        Check(pool.GetStats().bytesInUse == 24 + 64 + 8192, "pool bytes in use");
+        Check(pool.GetStats().upstreamAllocations == 3, "pool upstream allocations"); // two chunks, one large block
+        pool.deallocate(large, 8192);
+        pool.deallocate(small, 24, 8);
+        Check(pool.GetStats().peakBytes == 24 + 64 + 8192, "pool peak bytes");
+        Check(pool.allocate(32, 8) == small, "pool reuses a freed block");
+
+        LinearMemoryResource linear(256);
+        void* first = linear.allocate(200);
+        void* overflow = linear.allocate(200);
+        Check(first != nullptr && overflow != nullptr, "linear allocations");
+        Check(linear.GetStats().upstreamAllocations == 1, "linear overflow goes upstream");
+        linear.deallocate(overflow, 200);
+        linear.Release();
+        Check(linear.allocate(200) == first, "linear starts over after Release");
+    }
+
+    PoolMemoryResource m_pool;
+};
+
+struct FrameResourceTest
+    : PmrContainersTest
+{
+    GENERIC_TEST_CTOR(FrameResourceTest);
+
+    void Init() override { m_allocations = 0; }
+
+    void Report() override
+    {
+        const MemoryResourceStats& stats = m_memory.GetStats();
+        printf("    %zu heap allocations, %zu upstream\n", m_allocations, stats.upstreamAllocations);
+    }
+
+    std::pmr::memory_resource* GetResource() override { return &m_memory; }
+    void EndFrame() override { m_frameAllocator.BeginFrame(); }
+
+    FrameAllocator m_frameAllocator{ static_cast<size_t>(DefaultSize::OneMB) * 4 };
+    FrameMemoryResource m_memory{ m_frameAllocator };
+};
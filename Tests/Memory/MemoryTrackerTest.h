@@ -0,0 +1,85 @@
+#pragma once
+
+#include "../TestRunner.h"
+
+#include "Core/Memory/MemoryResource.h"
+#include "Core/Memory/MemoryTracker.h"
+
+#include <memory_resource>
+#include <thread>
+#include <vector>
+
+// Tagged counts through each hook, from several threads at once, then the
+// per frame numbers, a budget and the JSON report. Works on deltas of the
+// General tag since the tracker is process wide.
+struct MemoryTrackerTest
+    : BaseTest
+{
+    GENERIC_TEST_CTOR(MemoryTrackerTest);
+
+    using TrackedVector = std::vector<uint32_t, TrackedAllocator<uint32_t, MemoryTag::General>>;
+
+    void Init() override {}
+
+    void Run() override
+    {
+        MemoryTracker& tracker = MemoryTracker::GetInstance();
+        const MemoryTagStats before = tracker.GetStats(MemoryTag::General);
+
+        {
+            TrackedVector values;
+            values.reserve(1000);
+            Check(tracker.GetStats(MemoryTag::General).liveBytes == before.liveBytes + 1000 * sizeof(uint32_t), "TrackedAllocator bytes");
+
+            TrackedBytes gpu(MemoryTag::General);
+            gpu.Set(4096);
+            gpu.Set(8192); // reallocated, replaces the first size
+            TrackedBytes copy(gpu);
+            TrackedBytes moved(std::move(gpu));
+            Check(copy.Get() == 0 && moved.Get() == 8192 && gpu.Get() == 0, "TrackedBytes copy and move");
+
+            PoolMemoryResource pool(TrackedMemoryResource::Get(MemoryTag::General));
+            std::pmr::vector<uint32_t> pooled(&pool);
+            pooled.resize(16);
+
+            const MemoryTagStats during = tracker.GetStats(MemoryTag::General);
+            Check(during.liveBytes == before.liveBytes + 1000 * sizeof(uint32_t) + 8192 + PoolMemoryResource::kChunkSize, "live bytes through every hook");
+            Check(during.allocations == before.allocations + 4, "allocations through every hook");
+        }
+
+        // worker threads allocating and freeing at the same time.
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([]() {
+                for (uint32_t i = 0; i < 2000; ++i)
+                {
+                    TrackedVector values(1 + i % 64);
+                }
+                });
+        }
+        for (std::thread& thread : threads) { thread.join(); }
+
+        const MemoryTagStats after = tracker.GetStats(MemoryTag::General);
+        Check(after.liveBytes == before.liveBytes, "all freed after the threads");
+        Check(after.allocations == before.allocations + 4 + 4 * 2000, "allocations from every thread");
+        Check(after.peakBytes >= before.liveBytes + 1000 * sizeof(uint32_t) + 8192 + PoolMemoryResource::kChunkSize, "peak bytes");
+
+        // everything above happened this frame.
+        tracker.EndFrame();
+        Check(tracker.GetStats(MemoryTag::General).frameAllocations >= 4 + 4 * 2000, "frame allocations");
+
+        const size_t budget = tracker.GetBudget(MemoryTag::General);
+        {
+            TrackedVector values(1024);
+            tracker.SetBudget(MemoryTag::General, before.liveBytes + 1024);
+            tracker.EndFrame();
+            Check(tracker.GetStats(MemoryTag::General).overBudget, "over budget");
+        }
+        tracker.EndFrame();
+        Check(!tracker.GetStats(MemoryTag::General).overBudget, "back under budget");
+        tracker.SetBudget(MemoryTag::General, budget);
+
+        Check(tracker.ToJson().find("\"name\": \"General\"") != std::string::npos, "General tag in the JSON report");
+    }
+};
@@ -0,0 +1,229 @@
+#pragma once
+
+#include "../TestRunner.h"
+
+#include "Core/Memory/PoolAllocator.h"
+#include "Core/JobScheduler/JobContext.h"
+#include "Core/Spatial/Octree.h"
+#include "Core/PerfCounters.h"
+#include "Engine/Systems/KDTree.h"
+#include "Engine/Systems/BVH.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+// Rebuild + query of the engine's own kdtree, core::Octree and bvh::Tree,
+// with their nodes from PoolAllocator slabs (what the trees ship with)
+// versus one heap allocation per node (PoolMode::HeapPerNode, what the pools
+// replaced). Between rebuilds the rest of the "frame" churns the heap, as it
+// does in the game. Cache misses of the queries come from the hardware
+// counters, reported only when the thread has them.
+struct TreeRebuildBench
+    : BaseTest
+{
+    TreeRebuildBench(const char* name, PoolMode mode, size_t points, size_t queries = 10000)
+        : m_mode(mode)
+        , m_pointCount(points)
+        , m_queryCount(queries)
+    {
+        TestName = std::string(name) + (mode == PoolMode::Slabs ? "_pooled_" : "_heap_") + std::to_string(points);
+    }
+
+    ~TreeRebuildBench() override
+    {
+        for (void* block : m_churn) { std::free(block); }
+    }
+
+    void Init() override
+    {
+        std::mt19937 rng(1337);
+        std::uniform_real_distribution<float> dist(-50.0f, 50.0f);
+        m_points.resize(m_pointCount);
+        for (glm::vec3& p : m_points) { p = glm::vec3(dist(rng), dist(rng), dist(rng)); }
+
+        // keeps the neighbor count roughly the same at every size.
+        m_range = 50.0f * std::cbrt(32.0f / static_cast<float>(m_pointCount));
+
+        m_buildMs = m_queryMs = 0.0;
+        m_runs = m_found = 0;
+        m_l1dMisses = m_llcMisses = 0;
+        m_counterMask = 0xff;
+    }
+
+    void Run() override
+    {
+        using Clock = std::chrono::steady_clock;
+
+        ChurnHeap();
+
+        const Clock::time_point buildStart = Clock::now();
+        Rebuild();
+        const Clock::time_point queryStart = Clock::now();
+
+        PerfCounterSample before, after;
+        PerfCounters::Read(before);
+        for (size_t q = 0; q < m_queryCount; ++q)
+        {
+            m_found += Query(m_points[(q * 7919) % m_pointCount], m_range);
+        }
+        PerfCounters::Read(after);
+
+        const Clock::time_point queryEnd = Clock::now();
+        m_buildMs += std::chrono::duration<double, std::milli>(queryStart - buildStart).count();
+        m_queryMs += std::chrono::duration<double, std::milli>(queryEnd - queryStart).count();
+        ++m_runs;
+
+        PerfCounterSample delta;
+        PerfCounters::Delta(before, after, delta);
+        m_counterMask &= delta.mask;
+        m_l1dMisses += delta.values[static_cast<size_t>(PerfCounter::L1DMisses)];
+        m_llcMisses += delta.values[static_cast<size_t>(PerfCounter::LLCMisses)];
+    }
+
+    void Report() override
+    {
+        const double runs = static_cast<double>(m_runs > 0 ? m_runs : 1);
+        if (m_queryCount == 0)
+        {
+            printf("    build %.2f ms\n", m_buildMs / runs);
+            return;
+        }
+
+        const double queries = runs * static_cast<double>(m_queryCount);
+        printf("    build %.2f ms, queries %.2f ms, %.1f found / query\n",
+            m_buildMs / runs, m_queryMs / runs, m_found / queries);
+        if (m_counterMask & (1u << static_cast<size_t>(PerfCounter::L1DMisses)))
+        {
+            printf("    %.1f L1D misses / query\n", m_l1dMisses / queries);
+        }
+        if (m_counterMask & (1u << static_cast<size_t>(PerfCounter::LLCMisses)))
+        {
+            printf("    %.1f LLC misses / query\n", m_llcMisses / queries);
+        }
+    }
+
+    virtual void Rebuild() = 0;
+    // neighbors of p within range.
+    virtual size_t Query(const glm::vec3& p, float range) = 0;
+
+    // what the rest of a frame does to the heap between two rebuilds.
+    void ChurnHeap()
+    {
+        std::mt19937 rng(static_cast<uint32_t>(m_runs));
+        std::uniform_int_distribution<size_t> size(16, 256);
+        for (size_t i = 0; i < m_pointCount / 4; ++i)
+        {
+            const size_t slot = rng() % m_churn.size();
+            std::free(m_churn[slot]);
+            m_churn[slot] = std::malloc(size(rng));
+        }
+    }
+
+    PoolMode m_mode;
+    std::vector<glm::vec3> m_points;
+    std::vector<void*> m_churn = std::vector<void*>(4096, nullptr);
+
+    size_t m_pointCount = 0;
+    size_t m_queryCount = 0;
+    float m_range = 1.0f;
+
+    double m_buildMs = 0.0;
+    double m_queryMs = 0.0;
+    size_t m_runs = 0;
+    size_t m_found = 0;
+    uint64_t m_l1dMisses = 0;
+    uint64_t m_llcMisses = 0;
+    uint8_t m_counterMask = 0;
+};
+
+struct KDTreeNodeBench
+    : TreeRebuildBench
+{
+    KDTreeNodeBench(const char* name, PoolMode mode, size_t points)
+        : TreeRebuildBench(name, mode, points)
+        , m_tree(mode)
+    {
+    }
+
+    void Init() override
+    {
+        TreeRebuildBench::Init();
+
+        m_content.clear();
+        for (size_t i = 0; i < m_points.size(); ++i) { m_content.push_back({ m_points[i], i }); }
+    }
+
+    void Rebuild() override
+    {
+        m_tree.rebuild(m_content);
+    }
+
+    size_t Query(const glm::vec3& p, float range) override
+    {
+        JobContext::ScratchScope scratch;
+        kdtree::QueryResults results;
+        m_tree.nearest(p, range, results);
+        return results.size();
+    }
+
+    kdtree m_tree;
+    std::vector<kdtree::NodeContent> m_content;
+};
+
+struct OctreeNodeBench
+    : TreeRebuildBench
+{
+    OctreeNodeBench(const char* name, PoolMode mode, size_t points)
+        : TreeRebuildBench(name, mode, points)
+        , m_octree(std::pmr::get_default_resource(), mode)
+    {
+    }
+
+    void Rebuild() override
+    {
+        m_octree.Initialize(m_points);
+    }
+
+    size_t Query(const glm::vec3& p, float range) override
+    {
+        m_octree.FindNeighbors(p, range, m_indices);
+        return m_indices.size();
+    }
+
+    core::Octree m_octree;
+    std::vector<size_t> m_indices;
+};
+
+// insertion only, bvh::Tree has no queries yet. it doesn't pick siblings
+// either, so every leaf hangs off the first one and a build is quadratic:
+// keep the point counts small.
+struct BVHNodeBench
+    : TreeRebuildBench
+{
+    BVHNodeBench(const char* name, PoolMode mode, size_t points)
+        : TreeRebuildBench(name, mode, points, 0)
+    {
+        m_tree.m_pool = PoolAllocator<bvh::Node>(1024, mode);
+    }
+
+    void Rebuild() override
+    {
+        m_tree.Clear();
+        for (size_t i = 0; i < m_points.size(); ++i)
+        {
+            m_tree.InsertNode(static_cast<int>(i), AABB(m_points[i], 0.5f));
+        }
+    }
+
+    size_t Query(const glm::vec3&, float) override { return 0; }
+
+    bvh::Tree m_tree;
+};
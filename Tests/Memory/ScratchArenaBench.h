@@ -0,0 +1,91 @@
+#pragma once
+
+#include "../TestRunner.h"
+#include "AllocationCounter.h"
+
+#include "Core/JobScheduler/JobScheduler.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Many small jobs each building a few temporary lists, like the per boid
+// queries do, with every worker hitting the allocator at once. The heap
+// version contends on the global allocator, the scratch one bumps a
+// pointer in its own thread's arena. Counts global allocations too.
+template<typename List>
+struct ScratchArenaBench
+    : BaseTest
+{
+    ScratchArenaBench(const char* name, unsigned int threads, size_t jobs = 20000)
+        : m_threads(threads)
+        , m_jobCount(jobs)
+    {
+        TestName = std::string(name) + "_" + std::to_string(threads);
+    }
+
+    ~ScratchArenaBench() override
+    {
+        m_scheduler.Cleanup();
+    }
+
+    void Init() override
+    {
+        m_scheduler.Init(m_threads);
+
+        // warm up, the workers set up their arenas on their first job.
+        Submit();
+        m_allocations = 0;
+        m_jobs = 0;
+    }
+
+    void Run() override
+    {
+        AllocationCounter::Scope scope;
+        Submit();
+        m_allocations += scope.Count();
+        m_jobs += m_jobCount;
+    }
+
+    void Report() override
+    {
+        printf("    %zu jobs, %zu heap allocations (checksum %llu)\n",
+            m_jobs, m_allocations, static_cast<unsigned long long>(m_checksum.load()));
+    }
+
+    void Submit()
+    {
+        JobCounter counter;
+        for (size_t i = 0; i < m_jobCount; ++i)
+        {
+            m_scheduler.AddJob([this, i]() { BuildLists(i); }, &counter);
+        }
+        m_scheduler.WaitForCounter(&counter);
+    }
+
+    // a few lists grown one element at a time, sizes all over the place.
+    void BuildLists(size_t job)
+    {
+        uint64_t sum = 0;
+        for (size_t list = 0; list < 4; ++list)
+        {
+            List values;
+            const size_t count = 8 + (job * 37 + list * 101) % 256;
+            for (size_t n = 0; n < count; ++n) { values.push_back(static_cast<uint32_t>(n ^ job)); }
+            sum += values.back();
+        }
+        m_checksum.fetch_add(sum, std::memory_order_relaxed);
+    }
+
+    JobScheduler m_scheduler;
+    unsigned int m_threads = 0;
+    size_t m_jobCount = 0;
+
+    std::atomic<uint64_t> m_checksum{ 0 };
+    size_t m_allocations = 0;
+    size_t m_jobs = 0;
+};
+
+using HeapScratchBench = ScratchArenaBench<std::vector<uint32_t>>;
+using JobScratchBench = ScratchArenaBench<std::vector<uint32_t, ScratchAllocator<uint32_t>>>;
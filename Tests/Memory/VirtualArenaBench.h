@@ -0,0 +1,279 @@
+#pragma once
+
+#include "../TestRunner.h"
+
+#include "Core/JobScheduler/ParallelFor.h"
+#include "Core/Memory/MemoryResource.h"
+#include "Core/Spatial/Octree.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtx/norm.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <vector>
+
+// Boid flocking pass and octree queries over a million agents, the arrays
+// big enough that most random neighbor reads miss the TLB. The malloc
+// version gets ordinary 4 KB pages faulted in by the main thread's fill,
+// the arena version huge pages first touched across the pool's workers.
+struct LargeBufferBench
+    : BaseTest
+{
+    static constexpr size_t kNeighbors = 16;
+
+    LargeBufferBench(const char* name, size_t count, unsigned int threads)
+        : m_count(count)
+        , m_threads(threads)
+    {
+        TestName = std::string(name) + "_" + std::to_string(count);
+    }
+
+    ~LargeBufferBench() override
+    {
+        m_scheduler.Cleanup();
+    }
+
+    void Init() override
+    {
+        m_scheduler.Init(m_threads);
+        std::pmr::memory_resource* memory = GetMemory();
+
+        m_positions = Allocate<glm::vec3>(memory, m_count);
+        m_velocities = Allocate<glm::vec3>(memory, m_count);
+        m_forces = Allocate<glm::vec3>(memory, m_count);
+        m_neighbors = Allocate<uint32_t>(memory, m_count * kNeighbors);
+
+        std::mt19937 rng(1234u);
+        std::uniform_real_distribution<float> coord(-50.0f, 50.0f);
+        std::uniform_int_distribution<uint32_t> agent(0u, static_cast<uint32_t>(m_count - 1));
+        for (size_t i = 0; i < m_count; ++i)
+        {
+            m_positions[i] = glm::vec3(coord(rng), coord(rng), coord(rng));
+            m_velocities[i] = glm::vec3(coord(rng), coord(rng), coord(rng)) * 0.01f;
+            m_forces[i] = glm::vec3(0.0f);
+        }
+        for (size_t i = 0; i < m_count * kNeighbors; ++i)
+        {
+            m_neighbors[i] = agent(rng);
+        }
+
+        m_octree = std::make_unique<core::Octree>(memory);
+        m_octree->Initialize(m_positions, m_count);
+
+        m_queries.resize(m_count / 16);
+        for (glm::vec3& query : m_queries)
+        {
+            query = m_positions[agent(rng)];
+        }
+
+        Check(CheckOctree(), "octree neighbors match a brute force search");
+        m_seconds = 0.0;
+        m_runs = 0;
+    }
+
+    void Run() override
+    {
+        const auto start = std::chrono::steady_clock::now();
+        FlockingPass();
+        QueryPass();
+        m_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        ++m_runs;
+    }
+
+    void Report() override
+    {
+        const double seconds = m_seconds / std::max<size_t>(m_runs, 1);
+        printf("    %.2f M agents/s, %.2f M queries/s (checksum %.1f, %zu found)\n",
+            m_count / seconds * 1e-6, m_queries.size() / seconds * 1e-6, m_checksum, m_found);
+    }
+
+    // separation, cohesion and alignment from kNeighbors random agents each.
+    void FlockingPass()
+    {
+        ParallelForRange(0, m_count, 1024, [this](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                const glm::vec3 pos = m_positions[i];
+                glm::vec3 separation{}, center{}, alignment{};
+                const uint32_t* neighbors = m_neighbors + i * kNeighbors;
+                for (size_t n = 0; n < kNeighbors; ++n)
+                {
+                    const glm::vec3 toAgent = pos - m_positions[neighbors[n]];
+                    separation += toAgent / std::max(glm::length2(toAgent), 0.0001f);
+                    center += m_positions[neighbors[n]];
+                    alignment += m_velocities[neighbors[n]];
+                }
+
+                const float inv = 1.0f / static_cast<float>(kNeighbors);
+                m_forces[i] = separation + (center * inv - pos) + (alignment * inv - m_velocities[i]);
+            }
+            }, m_scheduler);
+
+        m_checksum = 0.0;
+        for (size_t i = 0; i < m_count; i += 97)
+        {
+            m_checksum += glm::length(m_forces[i]);
+        }
+    }
+
+    void QueryPass()
+    {
+        WorkerLocal<std::vector<size_t>> results(std::vector<size_t>(), m_scheduler);
+        WorkerLocal<size_t> found(0u, m_scheduler);
+        ParallelForRange(0, m_queries.size(), 64, [this, &results, &found](size_t begin, size_t end) {
+            std::vector<size_t>& result = results.Local();
+            size_t& count = found.Local();
+            for (size_t q = begin; q < end; ++q)
+            {
+                m_octree->FindNeighbors(m_queries[q], m_range, result);
+                count += result.size();
+            }
+            }, m_scheduler);
+
+        m_found = 0;
+        found.ForEach([this](size_t count) { m_found += count; });
+    }
+
+    // a few queries against brute force.
+    bool CheckOctree()
+    {
+        std::vector<size_t> result;
+        for (size_t q = 0; q < 4; ++q)
+        {
+            const glm::vec3& pos = m_queries[q * m_queries.size() / 4];
+            m_octree->FindNeighbors(pos, m_range, result);
+
+            std::vector<size_t> expected;
+            for (size_t i = 0; i < m_count; ++i)
+            {
+                const float distSq = glm::length2(m_positions[i] - pos);
+                if (distSq > 0.0f && distSq < m_range * m_range) { expected.push_back(i); }
+            }
+
+            std::sort(result.begin(), result.end());
+            if (result != expected) { return false; }
+        }
+        return true;
+    }
+
+    template<typename T>
+    T* Allocate(std::pmr::memory_resource* memory, size_t count)
+    {
+        T* data = static_cast<T*>(memory->allocate(sizeof(T) * count, alignof(T)));
+        FirstTouch(data, sizeof(T) * count);
+        m_buffers.push_back({ data, sizeof(T) * count, alignof(T) });
+        return data;
+    }
+
+    void ReleaseBuffers(std::pmr::memory_resource* memory)
+    {
+        m_octree.reset();
+        for (const Buffer& buffer : m_buffers)
+        {
+            memory->deallocate(buffer.data, buffer.bytes, buffer.alignment);
+        }
+        m_buffers.clear();
+    }
+
+    virtual std::pmr::memory_resource* GetMemory() = 0;
+    virtual void FirstTouch(void*, size_t) {}
+
+    struct Buffer
+    {
+        void* data;
+        size_t bytes;
+        size_t alignment;
+    };
+
+    JobScheduler m_scheduler;
+    size_t m_count = 0;
+    unsigned int m_threads = 0;
+    float m_range = 1.5f;
+
+    glm::vec3* m_positions = nullptr;
+    glm::vec3* m_velocities = nullptr;
+    glm::vec3* m_forces = nullptr;
+    uint32_t* m_neighbors = nullptr;
+    std::vector<Buffer> m_buffers;
+
+    std::unique_ptr<core::Octree> m_octree;
+    std::vector<glm::vec3> m_queries;
+
+    double m_checksum = 0.0;
+    size_t m_found = 0;
+    double m_seconds = 0.0;
+    size_t m_runs = 0;
+};
+
+struct MallocBufferBench
+    : LargeBufferBench
+{
+    using LargeBufferBench::LargeBufferBench;
+
+    ~MallocBufferBench() override
+    {
+        ReleaseBuffers(GetMemory());
+    }
+
+    std::pmr::memory_resource* GetMemory() override { return std::pmr::new_delete_resource(); }
+};
+
+struct VirtualArenaBufferBench
+    : LargeBufferBench
+{
+    VirtualArenaBufferBench(const char* name, size_t count, unsigned int threads, HugePages hugePages = HugePages::Transparent)
+        : LargeBufferBench(name, count, threads)
+        // the four arrays plus the octree's copy of the points and its links.
+        , m_memory(count * (4 * sizeof(glm::vec3) + kNeighbors * sizeof(uint32_t) + sizeof(size_t)) + 8 * VirtualArena::kHugePageSize, hugePages)
+    {
+    }
+
+    ~VirtualArenaBufferBench() override
+    {
+        ReleaseBuffers(&m_memory);
+    }
+
+    void Init() override
+    {
+        LargeBufferBench::Init();
+
+        // everything should have fit, no fallback to the heap.
+        const VirtualArena& arena = m_memory.GetArena();
+        Check(m_memory.GetStats().upstreamAllocations == 0 && arena.committed_size() >= arena.used_size() && arena.owns(m_positions),
+            "every buffer in the arena");
+    }
+
+    void Report() override
+    {
+        LargeBufferBench::Report();
+
+        const VirtualArena& arena = m_memory.GetArena();
+        static const char* names[] = { "none", "transparent", "explicit" };
+        printf("    huge pages %s, %zu MB used, %zu MB committed of %zu MB reserved\n",
+            names[static_cast<int>(arena.GetHugePages())], arena.used_size() >> 20, arena.committed_size() >> 20,
+            arena.reserved_size() >> 20);
+    }
+
+    std::pmr::memory_resource* GetMemory() override { return &m_memory; }
+
+    // a worker per huge page, so each lands on the node of the thread that
+    // faults it in rather than all of them on the main thread's.
+    void FirstTouch(void* data, size_t bytes) override
+    {
+        uint8_t* begin = static_cast<uint8_t*>(data);
+        const size_t pages = (bytes + VirtualArena::kHugePageSize - 1) / VirtualArena::kHugePageSize;
+        ParallelForRange(0, pages, 1, [begin, bytes](size_t first, size_t last) {
+            const size_t offset = first * VirtualArena::kHugePageSize;
+            const size_t end = std::min(last * VirtualArena::kHugePageSize, bytes);
+            VirtualArena::TouchPages(begin + offset, end - offset);
+            }, m_scheduler);
+    }
+
+    VirtualMemoryResource m_memory;
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "../TestRunner.h"
+#include "../Memory/AllocationCounter.h"
+
+#include "Core/JobScheduler/Task.h"
+
+#if ENABLE_JS_COROUTINES
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Fan out / fan in with Task<T> and WhenAll. After the first run the
+// coroutine frames and resume jobs come from the frame caches and
+// JobPool, so the steady state should not allocate.
+struct CoroutineTaskTest
+    : BaseTest
+{
+    GENERIC_TEST_CTOR(CoroutineTaskTest);
+
+    ~CoroutineTaskTest() override
+    {
+        m_scheduler.Cleanup();
+    }
+
+    void Init() override
+    {
+        m_scheduler.Init(std::max(std::thread::hardware_concurrency(), 2u));
+        m_children.reserve(m_childCount * 2);
+        m_allocations = 0;
+        m_runs = 0;
+
+        // warm up the frame caches. each pool thread builds its own on the
+        // first frame it touches, and how many frames a run has live at once
+        // depends on how fast the workers finish the children. So hold every
+        // worker in a child of its own while this thread runs a fan out twice
+        // the size by itself, then do a regular run.
+        m_released.store(false);
+        m_held.store(0);
+        const unsigned int workers = m_scheduler.GetWorkerCount() - 1;
+        for (unsigned int i = 0; i < workers; ++i)
+        {
+            SpawnTask(Hold(), m_scheduler);
+        }
+        while (m_held.load() < workers)
+        {
+            std::this_thread::yield();
+        }
+        Task<size_t> warmUp = Sum(m_childCount * 2);
+        SyncWait(warmUp, m_scheduler);
+        m_released.store(true);
+
+        RunOnce();
+    }
+
+    void Run() override
+    {
+        AllocationCounter::Scope scope;
+        RunOnce();
+        m_allocations += scope.Count();
+        ++m_runs;
+    }
+
+    void Report() override
+    {
+        printf("    %zu runs x %zu children, %zu allocations\n", m_runs, m_childCount, m_allocations);
+        Check(m_allocations == 0, "no allocations once the frame caches are warm");
+    }
+
+    void RunOnce()
+    {
+        Task<size_t> root = Sum(m_childCount);
+        const size_t expected = m_childCount * (m_childCount - 1);
+        Check(SyncWait(root, m_scheduler) == expected, "root sums every child");
+    }
+
+    Task<size_t> Child(size_t index)
+    {
+        co_await ScheduleOn(m_scheduler);
+        co_return index * 2;
+    }
+
+    // keeps one pool thread busy until the warm up is done.
+    Task<void> Hold()
+    {
+        co_await ScheduleOn(m_scheduler);
+        // a frame from this thread, so it builds its cache now.
+        co_await Nothing();
+        m_held.fetch_add(1);
+        while (!m_released.load())
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    Task<void> Nothing()
+    {
+        co_return;
+    }
+
+    Task<size_t> Sum(size_t count)
+    {
+        m_children.clear();
+        for (size_t i = 0; i < count; ++i)
+        {
+            m_children.push_back(Child(i));
+        }
+
+        co_await WhenAll<size_t>(m_children, m_scheduler);
+
+        size_t sum = 0;
+        for (Task<size_t>& child : m_children)
+        {
+            sum += child.Result();
+        }
+        co_return sum;
+    }
+
+    JobScheduler m_scheduler;
+    std::atomic<unsigned int> m_held{ 0 };
+    std::atomic<bool> m_released{ false };
+    size_t m_childCount = 256;
+    std::vector<Task<size_t>> m_children;
+
+    size_t m_allocations = 0;
+    size_t m_runs = 0;
+};
+
+#endif
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "../TestRunner.h"
+
+#include "Core/JobScheduler/JobScheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Submit-to-start latency and throughput of tiny jobs.
+// Runs on Linux as well as Windows, timing is std::chrono only.
+
+// Copy of the scheduler before work stealing: a single mutex guarded queue
+// that idle workers poll, sleeping 10ms whenever it is empty.
+class LegacyJobQueue
+{
+public:
+    void Init(unsigned int numThreads)
+    {
+        m_running.store(true);
+        for (unsigned int i = 0; i < numThreads; ++i)
+        {
+            m_threads.emplace_back([this]() { WorkLoop(); });
+        }
+    }
+
+    void Cleanup()
+    {
+        m_running.store(false);
+        for (std::thread& t : m_threads) { t.join(); }
+        m_threads.clear();
+    }
+
+    void AddJob(IBaseJob* job)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push(job);
+        ++m_size;
+    }
+
+    bool TryRunPendingJob() { return false; }
+    // the queue is unbounded, nothing runs on the submitting thread.
+    size_t GetInlineJobCount() const { return 0; }
+
+private:
+    void WorkLoop()
+    {
+        while (m_running.load())
+        {
+            IBaseJob* job = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_size > 0)
+                {
+                    job = m_jobs.front();
+                    m_jobs.pop();
+                    --m_size;
+                }
+            }
+
+            if (job)
+            {
+                job->Execute();
+            }
+            else
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+    }
+
+    std::mutex m_mutex;
+    std::queue<IBaseJob*> m_jobs;
+    size_t m_size = 0;
+    std::vector<std::thread> m_threads;
+    std::atomic_bool m_running{ false };
+};
+
+struct LatencyJob
+    : IBaseJob
+{
+    void Execute() override
+    {
+        const auto now = std::chrono::steady_clock::now();
+        *latencyNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now - submitted).count();
+        done->fetch_add(1, std::memory_order_release);
+    }
+
+    std::chrono::steady_clock::time_point submitted;
+    long long* latencyNs = nullptr;
+    std::atomic<size_t>* done = nullptr;
+};
+
+template<typename Scheduler>
+struct JobBench
+    : BaseTest
+{
+    JobBench(const char* name, size_t jobCount, unsigned int numThreads = 0)
+        : m_jobCount(jobCount)
+        , m_numThreads(numThreads ? numThreads : std::max(std::thread::hardware_concurrency(), 2u))
+    {
+        TestName = std::string(name) + "_" + std::to_string(jobCount);
+    }
+
+    void Init() override
+    {
+        m_jobs.resize(m_jobCount);
+        m_latencies.resize(m_jobCount);
+        m_samples.clear();
+        m_totalSeconds = 0.0;
+        m_runs = 0;
+        m_inlineJobs = 0;
+
+        for (size_t i = 0; i < m_jobCount; ++i)
+        {
+            m_jobs[i].latencyNs = &m_latencies[i];
+            m_jobs[i].done = &m_done;
+        }
+
+        m_scheduler.Init(m_numThreads);
+    }
+
+    void Run() override
+    {
+        m_done.store(0);
+        const size_t inlineBefore = m_scheduler.GetInlineJobCount();
+        const auto start = std::chrono::steady_clock::now();
+        for (LatencyJob& job : m_jobs)
+        {
+            job.submitted = std::chrono::steady_clock::now();
+            m_scheduler.AddJob(&job);
+        }
+
+        while (m_done.load(std::memory_order_acquire) < m_jobCount)
+        {
+            if (!m_scheduler.TryRunPendingJob())
+            {
+                std::this_thread::yield();
+            }
+        }
+        const auto end = std::chrono::steady_clock::now();
+
+        // ran on this thread as they were submitted, their latency is ~0.
+        m_inlineJobs += m_scheduler.GetInlineJobCount() - inlineBefore;
+        m_totalSeconds += std::chrono::duration<double>(end - start).count();
+        ++m_runs;
+
+        // keep a bounded sample per run so 1M job runs stay cheap to sort.
+        const size_t stride = std::max<size_t>(1, m_jobCount / 10000);
+        for (size_t i = 0; i < m_jobCount; i += stride)
+        {
+            m_samples.push_back(m_latencies[i]);
+        }
+    }
+
+    void Report() override
+    {
+        if (m_samples.empty()) { return; }
+
+        std::sort(m_samples.begin(), m_samples.end());
+        auto percentile = [&](double p) {
+            const size_t index = std::min(m_samples.size() - 1, static_cast<size_t>(p * m_samples.size()));
+            return static_cast<double>(m_samples[index]) / 1000.0;
+        };
+
+        const double jobsPerSec = (m_jobCount * m_runs) / m_totalSeconds;
+        printf("    threads %u | %.2f Mjobs/s | submit->start us p50 %.1f p99 %.1f max %.1f | inline %zu / run\n",
+            m_numThreads, jobsPerSec / 1e6, percentile(0.5), percentile(0.99), percentile(1.0),
+            m_runs > 0 ? m_inlineJobs / m_runs : 0);
+    }
+
+    void Cleanup() override
+    {
+        m_scheduler.Cleanup();
+    }
+
+    Scheduler m_scheduler;
+    size_t m_jobCount;
+    unsigned int m_numThreads;
+
+    std::vector<LatencyJob> m_jobs;
+    std::vector<long long> m_latencies;
+    std::vector<long long> m_samples;
+    std::atomic<size_t> m_done{ 0 };
+
+    double m_totalSeconds = 0.0;
+    size_t m_runs = 0;
+    size_t m_inlineJobs = 0;
+};
+
+using LegacyJobQueueBench = JobBench<LegacyJobQueue>;
+using WorkStealingJobBench = JobBench<JobScheduler>;
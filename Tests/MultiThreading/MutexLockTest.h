@@ -2,9 +2,17 @@
 
 #include "../TestRunner.h"
 
+#include "Core/AdaptiveMutex.h"
 #include "Core/CustomMutex.h"
 #include "Engine/Systems/Terrain.h"
 
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
 struct StdMutexLockTest
     : BaseTest
 {
@@ -49,4 +57,85 @@ struct CustomMutexLockTest
     }
 
     Terrain<CustomMutex>* pTerrain = nullptr;
-};
\ No newline at end of file
+};
+
+struct AdaptiveMutexLockTest
+    : BaseTest
+{
+    GENERIC_TEST_CTOR(AdaptiveMutexLockTest);
+
+    ~AdaptiveMutexLockTest() override
+    {
+        delete pTerrain;
+    }
+
+    void Init() override
+    {
+        pTerrain = new Terrain<AdaptiveMutex>(1.0f, 100.0f, 100.0f, 100.0f);
+    }
+
+    void Run() override
+    {
+        pTerrain->GenerateMesh();
+    }
+
+    Terrain<AdaptiveMutex>* pTerrain = nullptr;
+};
+
+// Threads taking turns on one lock around a tiny critical section,
+// the worst case for a mutex. ProfiledAdaptiveMutex also reports how
+// often it had to wait and for how long.
+template<typename Mutex>
+struct MutexContentionTest
+    : BaseTest
+{
+    MutexContentionTest(const char* name, unsigned int threads, size_t locksPerThread = 200000)
+        : m_threads(threads)
+        , m_locksPerThread(locksPerThread)
+    {
+        TestName = std::string(name) + "_" + std::to_string(threads);
+    }
+
+    void Init() override {}
+
+    void Run() override
+    {
+        m_counter = 0;
+
+        std::vector<std::thread> threads;
+        threads.reserve(m_threads);
+        for (unsigned int t = 0; t < m_threads; ++t)
+        {
+            threads.emplace_back([this]() {
+                for (size_t i = 0; i < m_locksPerThread; ++i)
+                {
+                    std::lock_guard<Mutex> lock(m_mutex);
+                    ++m_counter;
+                }
+                });
+        }
+        for (std::thread& t : threads) { t.join(); }
+
+        Check(m_counter == m_threads * m_locksPerThread, "no lost increments");
+    }
+
+    void Report() override
+    {
+        if constexpr (std::is_same<Mutex, ProfiledAdaptiveMutex>::value)
+        {
+            const MutexStats stats = m_mutex.GetStats();
+            printf("    acquisitions %llu | contended %llu (%.1f%%) | waited %.3f ms\n",
+                static_cast<unsigned long long>(stats.acquisitions), static_cast<unsigned long long>(stats.contended),
+                stats.acquisitions ? 100.0 * stats.contended / stats.acquisitions : 0.0, stats.waitNs / 1e6);
+        }
+    }
+
+    Mutex m_mutex;
+    size_t m_counter = 0;
+
+    unsigned int m_threads;
+    size_t m_locksPerThread;
+};
+
+using StdMutexContentionTest = MutexContentionTest<std::mutex>;
+using AdaptiveMutexContentionTest = MutexContentionTest<ProfiledAdaptiveMutex>;
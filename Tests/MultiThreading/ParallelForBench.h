@@ -0,0 +1,150 @@
+#pragma once
+
+#include "../TestRunner.h"
+
+#include "Core/JobScheduler/ParallelFor.h"
+#include "Engine/Systems/Terrain.h"
+#include "Engine/Utils/MathUtils.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtx/norm.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Scaling of ParallelFor from 1 to N pool threads.
+// Each Run sweeps every thread count and Report prints time and speedup.
+struct ParallelForScalingTest
+    : BaseTest
+{
+    ~ParallelForScalingTest() override
+    {
+        JobScheduler::GetInstance().Cleanup();
+    }
+
+    void Init() override
+    {
+        m_maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        m_seconds.assign(m_maxThreads, 0.0);
+        m_runs = 0;
+        Setup();
+    }
+
+    void Run() override
+    {
+        JobScheduler& scheduler = JobScheduler::GetInstance();
+        for (unsigned int threads = 1; threads <= m_maxThreads; ++threads)
+        {
+            scheduler.Cleanup();
+            scheduler.Init(threads);
+
+            const auto start = std::chrono::steady_clock::now();
+            Step();
+            m_seconds[threads - 1] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        ++m_runs;
+    }
+
+    void Report() override
+    {
+        for (unsigned int threads = 1; threads <= m_maxThreads; ++threads)
+        {
+            const double ms = m_seconds[threads - 1] * 1000.0 / m_runs;
+            printf("    %2u threads: %8.3f ms  x%.2f\n", threads, ms, m_seconds[0] / m_seconds[threads - 1]);
+        }
+    }
+
+protected:
+    virtual void Setup() = 0;
+    virtual void Step() = 0;
+
+    unsigned int m_maxThreads = 1;
+    std::vector<double> m_seconds;
+    size_t m_runs = 0;
+};
+
+// Same brute force neighbor search and flocking rules as Boid, on plain arrays.
+struct ParallelForBoidTest
+    : ParallelForScalingTest
+{
+    GENERIC_TEST_CTOR(ParallelForBoidTest);
+
+    void Setup() override
+    {
+        m_positions.resize(m_count);
+        m_directions.resize(m_count);
+        m_forces.resize(m_count);
+        for (size_t i = 0; i < m_count; ++i)
+        {
+            m_positions[i] = MathUtils::RandomInUnitSphere() * 50.0f;
+            m_directions[i] = glm::normalize(MathUtils::RandomInUnitSphere() + glm::vec3(0.0f, 0.001f, 0.0f));
+        }
+        m_scratch = std::make_unique<WorkerLocal<std::vector<size_t>>>();
+    }
+
+    void Step() override
+    {
+        // the pool is rebuilt per thread count, so the scratch slots are too.
+        m_scratch = std::make_unique<WorkerLocal<std::vector<size_t>>>();
+
+        ParallelFor(0, m_count, 16, *m_scratch, [this](size_t i, std::vector<size_t>& neighbors) {
+            neighbors.clear();
+            const glm::vec3 pos = m_positions[i];
+            for (size_t n = 0; n < m_count; ++n)
+            {
+                if (n != i && glm::length2(pos - m_positions[n]) < m_rangeSq)
+                {
+                    neighbors.push_back(n);
+                }
+            }
+
+            glm::vec3 separation{}, center{}, alignment{};
+            for (size_t n : neighbors)
+            {
+                const glm::vec3 toAgent = pos - m_positions[n];
+                separation += toAgent / std::max(glm::length2(toAgent), 0.0001f);
+                center += m_positions[n];
+                alignment += m_directions[n];
+            }
+
+            if (!neighbors.empty())
+            {
+                const float inv = 1.0f / static_cast<float>(neighbors.size());
+                m_forces[i] = separation + (center * inv - pos) + (alignment * inv - m_directions[i]);
+            }
+            });
+
+        m_checksum = ParallelReduce(0, m_count, 0, 0.0f,
+            [this](size_t i, float& acc) { acc += glm::length(m_forces[i]); },
+            [](float a, float b) { return a + b; });
+    }
+
+    size_t m_count = 2500;
+    float m_rangeSq = 15.0f * 15.0f;
+    std::vector<glm::vec3> m_positions;
+    std::vector<glm::vec3> m_directions;
+    std::vector<glm::vec3> m_forces;
+    std::unique_ptr<WorkerLocal<std::vector<size_t>>> m_scratch;
+    float m_checksum = 0.0f;
+};
+
+struct ParallelForTerrainTest
+    : ParallelForScalingTest
+{
+    GENERIC_TEST_CTOR(ParallelForTerrainTest);
+
+    void Setup() override
+    {
+        m_terrain = std::make_unique<Terrain<>>(1.0f, 200.0f, 200.0f, 100.0f);
+    }
+
+    void Step() override
+    {
+        m_terrain->GenerateMesh();
+    }
+
+    std::unique_ptr<Terrain<>> m_terrain;
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "../TestRunner.h"
+
+#include "Core/Containers/MPMCQueue.h"
+#include "Core/Containers/ThreadSafeQueue.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+// N producers and N consumers hammering one queue.
+// Every item is pushed once and popped once, the sum checks nothing got lost.
+template<typename Queue>
+struct QueueContentionBench
+    : BaseTest
+{
+    QueueContentionBench(const char* name, unsigned int threads, size_t items = 1 << 20)
+        : m_threads(threads)
+        , m_items(items)
+    {
+        TestName = std::string(name) + "_" + std::to_string(threads) + "x" + std::to_string(threads);
+    }
+
+    void Init() override {}
+
+    void Run() override
+    {
+        Queue queue;
+        std::atomic<size_t> popped{ 0 };
+        std::atomic<size_t> sum{ 0 };
+        std::atomic<bool> go{ false };
+
+        std::vector<std::thread> threads;
+        threads.reserve(m_threads * 2);
+
+        const size_t perProducer = m_items / m_threads;
+        const size_t total = perProducer * m_threads;
+
+        for (unsigned int p = 0; p < m_threads; ++p)
+        {
+            threads.emplace_back([&, p]() {
+                while (!go.load(std::memory_order_acquire)) { std::this_thread::yield(); }
+                const size_t first = p * perProducer;
+                for (size_t i = 0; i < perProducer; ++i)
+                {
+                    queue.push(first + i);
+                }
+                });
+        }
+
+        for (unsigned int c = 0; c < m_threads; ++c)
+        {
+            threads.emplace_back([&]() {
+                while (!go.load(std::memory_order_acquire)) { std::this_thread::yield(); }
+                size_t local = 0;
+                size_t value = 0;
+                while (popped.load(std::memory_order_relaxed) < total)
+                {
+                    if (queue.try_pop(value))
+                    {
+                        local += value;
+                        popped.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+                sum.fetch_add(local, std::memory_order_relaxed);
+                });
+        }
+
+        go.store(true, std::memory_order_release);
+        for (std::thread& t : threads) { t.join(); }
+
+        Check(sum.load() == total * (total - 1) / 2, "every item popped once");
+    }
+
+    unsigned int m_threads;
+    size_t m_items;
+};
+
+using MutexQueueBench = QueueContentionBench<ThreadSafeQueue<size_t>>;
+using MPMCQueueBench = QueueContentionBench<MPMCQueue<size_t>>;
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../TestRunner.h"
+
+#include "Core/Containers/SPSCRing.h"
+#include "Core/Containers/ThreadSafeQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One producer thread handing items to one consumer thread, the shape of
+// worker -> main thread handoffs. BatchSize > 1 uses push_n / pop_n.
+template<typename Queue, size_t BatchSize = 1>
+struct HandoffBench
+    : BaseTest
+{
+    HandoffBench(const char* name, size_t items = 1 << 22)
+        : m_items(items)
+    {
+        TestName = std::string(name) + "_" + std::to_string(BatchSize);
+    }
+
+    void Init() override {}
+
+    void Run() override
+    {
+        Queue queue;
+        size_t sum = 0;
+
+        std::thread producer([this, &queue]() {
+            size_t batch[BatchSize];
+            for (size_t i = 0; i < m_items; i += BatchSize)
+            {
+                const size_t count = std::min(BatchSize, m_items - i);
+                for (size_t b = 0; b < count; ++b) { batch[b] = i + b; }
+                Push(queue, batch, count);
+            }
+            });
+
+        size_t batch[BatchSize];
+        for (size_t received = 0; received < m_items;)
+        {
+            const size_t count = Pop(queue, batch);
+            for (size_t b = 0; b < count; ++b) { sum += batch[b]; }
+            received += count;
+            if (count == 0) { std::this_thread::yield(); }
+        }
+        producer.join();
+
+        Check(sum == m_items * (m_items - 1) / 2, "every item handed off once");
+    }
+
+    static void Push(SPSCRing<size_t>& queue, const size_t* items, size_t count)
+    {
+        while (count > 0)
+        {
+            const size_t pushed = queue.push_n(items, count);
+            items += pushed;
+            count -= pushed;
+            if (pushed == 0) { std::this_thread::yield(); }
+        }
+    }
+
+    static size_t Pop(SPSCRing<size_t>& queue, size_t* out)
+    {
+        return queue.pop_n(out, BatchSize);
+    }
+
+    static void Push(ThreadSafeQueue<size_t>& queue, const size_t* items, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i) { queue.push(items[i]); }
+    }
+
+    static size_t Pop(ThreadSafeQueue<size_t>& queue, size_t* out)
+    {
+        size_t count = 0;
+        while (count < BatchSize && queue.try_pop(out[count])) { ++count; }
+        return count;
+    }
+
+    size_t m_items;
+};
+
+using MutexHandoffBench = HandoffBench<ThreadSafeQueue<size_t>>;
+using SPSCHandoffBench = HandoffBench<SPSCRing<size_t>>;
+using SPSCBatchHandoffBench = HandoffBench<SPSCRing<size_t>, 64>;
@@ -39,11 +39,11 @@ struct TestOctreeAltSearch
 
 	void Run() override
 	{
-		result.clear();
+		JobContext::ScratchScope scratch;
+		AABBOctree::SearchResults result;
 		oct.FindNeighbors(qPoint, range, result);
 		output = result.size();
 	}
 
 	AABBOctree oct;
-	std::vector<OcNode> result;
 };
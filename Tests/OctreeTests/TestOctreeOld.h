@@ -38,7 +38,8 @@ struct TestOctreeOldSearch
 
 	void Run() override
 	{
-		result.clear();
+		JobContext::ScratchScope scratch;
+		AABBOctree::SearchResults result;
 		oct.Search(AABB(qPoint, range), result);
 		result.erase(std::remove_if(result.begin(), result.end(), [&](const OcNode& n) {
 			return glm::length2(qPoint - points[n.m_data]) > rangeSq;
@@ -49,5 +50,4 @@ struct TestOctreeOldSearch
 	}
 
 	AABBOctree oct;
-	std::vector<OcNode> result;
 };
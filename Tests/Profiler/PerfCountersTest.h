@@ -0,0 +1,61 @@
+#pragma once
+
+#include "../TestRunner.h"
+
+#include "Core/ProfilerStats.h"
+
+// Scopes sample hardware counters while they're on, and come out with an
+// empty mask where perf isn't available instead of failing.
+struct PerfCountersTest
+    : BaseTest
+{
+    GENERIC_TEST_CTOR(PerfCountersTest);
+
+    void Init() override {}
+
+    void Run() override
+    {
+        Profiler& profiler = Profiler::GetInstance();
+        ProfilerStats stats(60.0f);
+        const bool available = PerfCounters::IsAvailable();
+
+        profiler.SetHardwareCounters(true);
+        for (int i = 0; i < 10; ++i)
+        {
+            PROFILE_SCOPE("PerfCountersTest Loop");
+            volatile float sum = 0.0f;
+            for (int j = 0; j < 100000; ++j)
+            {
+                sum = sum + static_cast<float>(j) * 0.5f;
+            }
+        }
+        profiler.SetHardwareCounters(false);
+
+        stats.Update();
+        stats.Refresh();
+
+        const ProfilerStats::ScopeStats* scope = stats.Find("PerfCountersTest Loop");
+        if (Check(scope != nullptr && scope->count == 10, "loop scope counted 10 times"))
+        {
+            const size_t instructions = static_cast<size_t>(PerfCounter::Instructions);
+            if (!available)
+            {
+                Check(scope->counterMask == 0 && scope->ipc == 0.0f, "no counters without perf");
+            }
+            else if (scope->counterMask & (1u << instructions))
+            {
+                // at least a couple of instructions per iteration.
+                Check(scope->counters[instructions] > 100000.0f, "instructions counted for the loop");
+            }
+        }
+
+        m_available = available;
+    }
+
+    void Report() override
+    {
+        printf("    counters %s\n", m_available ? "available" : "unavailable");
+    }
+
+    bool m_available = false;
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "../TestRunner.h"
+
+#include "Core/ProfilerStats.h"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Scopes of 1..100 ms recorded from four threads, two of them through a
+// copy of the label, come out as one scope with exact nearest rank
+// percentiles; then the same stats checked as a budget would be. A scope
+// called more often than the sample ring holds still counts every call.
+struct ProfilerStatsTest
+    : BaseTest
+{
+    GENERIC_TEST_CTOR(ProfilerStatsTest);
+
+    void Init() override {}
+
+    void Run() override
+    {
+        ProfilerStats stats(60.0f);
+
+        static const char* label = "ProfilerStatsTest Scope";
+        char copy[32];
+        strcpy(copy, label);
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([t, &copy]() {
+                Profiler& profiler = Profiler::GetInstance();
+                const char* name = t % 2 == 0 ? label : copy;
+                for (uint64_t ms = 1 + t; ms <= 100; ms += 4)
+                {
+                    const uint64_t now = profiler.Now();
+                    profiler.Record(name, nullptr, now - ms * 1000000, now);
+                }
+                });
+        }
+        for (std::thread& thread : threads) { thread.join(); }
+
+        static const char* hotLabel = "ProfilerStatsTest Hot";
+        const size_t hotCalls = ProfilerStats::kMaxSamples + 1000;
+        for (size_t i = 0; i < hotCalls; ++i)
+        {
+            const uint64_t now = Profiler::GetInstance().Now();
+            Profiler::GetInstance().Record(hotLabel, nullptr, now - 1000000, now);
+        }
+
+        stats.Update();
+        stats.Refresh();
+
+        const ProfilerStats::ScopeStats* scope = stats.Find(label);
+        if (Check(scope != nullptr, "both label pointers found as one scope"))
+        {
+            Check(scope->count == 100, "count");
+            Check(Near(scope->minMs, 1.0f) && Near(scope->maxMs, 100.0f), "min and max");
+            Check(Near(scope->meanMs, 50.5f) && Near(scope->totalMs, 5050.0f), "mean and total");
+            Check(Near(scope->p50Ms, 50.0f) && Near(scope->p95Ms, 95.0f) && Near(scope->p99Ms, 99.0f), "nearest rank percentiles");
+
+            // how a test holds a system to its budget.
+            Check(scope->p95Ms < 96.0f, "p95 within budget");
+        }
+        const ProfilerStats::ScopeStats* hot = stats.Find(hotLabel);
+        Check(hot != nullptr && hot->count == hotCalls && Near(hot->totalMs, static_cast<float>(hotCalls)), "hot scope counts every call");
+        Check(stats.Find("ProfilerStatsTest Missing") == nullptr, "unknown scope not found");
+
+        stats.Reset();
+        Check(stats.GetAll().empty(), "empty after Reset");
+    }
+
+    static bool Near(float a, float b) { return a > b - 0.01f && a < b + 0.01f; }
+};
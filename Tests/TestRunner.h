@@ -2,18 +2,16 @@
 
 #include <vector>
 #include <functional>
-
-#define NOMINMAX
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
+#include <string>
+#include <chrono>
+#include <cstdio>
 
 #define TIME_START() \
-    LARGE_INTEGER start, end;           \
-    QueryPerformanceCounter(&start);    \
+    auto start = std::chrono::steady_clock::now();  \
 
 #define TIME_END2(n) \
-    QueryPerformanceCounter(&end);                                                      \
-    int totalTime = (int)((end.QuadPart - start.QuadPart) * 1000 / freq.QuadPart);      \
+    auto end = std::chrono::steady_clock::now();                                                        \
+    int totalTime = (int)std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();    \
 
 #define PRINT_T(t, n) \
     printf(" avg %.4f (ms)\n", static_cast<float>(t)/static_cast<float>(n));  \
@@ -27,7 +25,42 @@ struct BaseTest
     virtual void Init() = 0;
     virtual void Run() = 0;
 
+    // called once after all runs, for tests that collect their own metrics.
+    virtual void Report() {}
+    // checked after Report, false counts the test as failed.
+    virtual bool Passed() const { return m_failedChecks.empty(); }
+    // called last, releases what Init started (worker threads) so the
+    // next test runs without them.
+    virtual void Cleanup() {}
+
+    // an expectation, what says which; failed ones are printed after Report
+    // and fail the test. Returns cond.
+    bool Check(bool cond, const char* what)
+    {
+        if (!cond)
+        {
+            for (std::pair<const char*, size_t>& failed : m_failedChecks)
+            {
+                if (failed.first == what) { ++failed.second; return false; }
+            }
+            m_failedChecks.push_back({ what, 1 });
+        }
+        return cond;
+    }
+
+    void PrintFailedChecks() const
+    {
+        for (const std::pair<const char*, size_t>& failed : m_failedChecks)
+        {
+            printf("    check failed: %s (%zu times)\n", failed.first, failed.second);
+        }
+    }
+
     std::string TestName = "BaseTest";
+
+private:
+    // by what, repeated runs count instead of printing again.
+    std::vector<std::pair<const char*, size_t>> m_failedChecks;
 };
 
 #define GENERIC_TEST_CTOR(className) \
@@ -36,19 +69,17 @@ struct BaseTest
 struct ProfileTime
 {
     ProfileTime()
+        : start(std::chrono::steady_clock::now())
     {
-        QueryPerformanceFrequency(&freq);
-        QueryPerformanceCounter(&start);
     }
 
     int GetTime()
     {
-        QueryPerformanceCounter(&end);
-        return static_cast<int>((end.QuadPart - start.QuadPart) * 1000 / freq.QuadPart);
+        end = std::chrono::steady_clock::now();
+        return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
     }
 
-    LARGE_INTEGER freq{};
-    LARGE_INTEGER start{}, end{};
+    std::chrono::steady_clock::time_point start{}, end{};
 };
 
 template<size_t TestCount>
@@ -97,6 +128,9 @@ struct TestRunner
         }
     }
 
+    // tests whose checks failed, main returns non-zero if any did.
+    size_t GetFailed() const { return m_failed; }
+
     void RunQuick(std::function<void(void)> f1, std::function<void(void)> f2) 
     {
         printf("f1: "); RunQuickTest(f1);
@@ -119,6 +153,14 @@ private:
 
         float timeAvg = static_cast<float>(time) / TestCount;
         printf("in %d (ms) / %0.5f (ms) avg.\n", time, timeAvg);
+        test->Report();
+        test->PrintFailedChecks();
+        if (!test->Passed())
+        {
+            printf("  FAILED: %s\n", test->TestName.c_str());
+            ++m_failed;
+        }
+        test->Cleanup();
         return timeAvg;
     }
 
@@ -141,4 +183,5 @@ private:
 private:
     std::vector<BaseTest*> m_tests;
     std::vector<std::pair<BaseTest*, BaseTest*>> m_quickBenchs;
+    size_t m_failed = 0;
 };
\ No newline at end of file
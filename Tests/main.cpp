@@ -8,6 +8,26 @@
 #include "Branches/TestAABB.h"
 
 #include "MultiThreading/MutexLockTest.h"
+#include "MultiThreading/JobSchedulerBench.h"
+#include "MultiThreading/ParallelForBench.h"
+#include "MultiThreading/CoroutineTaskTest.h"
+#include "MultiThreading/QueueContentionBench.h"
+#include "MultiThreading/SPSCRingBench.h"
+
+#include "Memory/JobAllocationTest.h"
+#include "Memory/FrameAllocatorTest.h"
+#include "Memory/NodePoolBench.h"
+#include "Memory/MemoryResourceTest.h"
+#include "Memory/MemoryTrackerTest.h"
+#include "Memory/ScratchArenaBench.h"
+#include "Memory/VirtualArenaBench.h"
+
+#include "Containers/SlotMapBench.h"
+#include "Containers/FlatHashMapBench.h"
+#include "Containers/SmallVectorBench.h"
+
+#include "Profiler/ProfilerStatsTest.h"
+#include "Profiler/PerfCountersTest.h"
 
 #include <vectorclass/vectorclass.h>
 
@@ -31,12 +51,94 @@ int main()
 
     testRunner.Add(new StdMutexLockTest());
     // testRunner.Add(new CustomMutexLockTest());
+    // testRunner.Add(new AdaptiveMutexLockTest());
 
     // testRunner.Add(new TestAABB(), new TestAABBNoBranch());
 
     // testRunner.RunTests();
     // testRunner.RunBenchs();
 
+    TestRunner<5> jobBenchRunner;
+    jobBenchRunner.Add(new LegacyJobQueueBench("LegacyJobQueue", 1000), new WorkStealingJobBench("WorkStealing", 1000));
+    jobBenchRunner.Add(new LegacyJobQueueBench("LegacyJobQueue", 100000), new WorkStealingJobBench("WorkStealing", 100000));
+    jobBenchRunner.Add(new LegacyJobQueueBench("LegacyJobQueue", 1000000), new WorkStealingJobBench("WorkStealing", 1000000));
+    // jobBenchRunner.RunBenchs();
+
+    TestRunner<3> scalingRunner;
+    scalingRunner.Add(new ParallelForBoidTest());
+    scalingRunner.Add(new ParallelForTerrainTest());
+    // scalingRunner.RunTests();
+
+    TestRunner<5> mutexRunner;
+    mutexRunner.Add(new StdMutexLockTest(), new AdaptiveMutexLockTest());
+    for (unsigned int threads : { 1u, 2u, 4u, 8u, 16u })
+    {
+        mutexRunner.Add(new StdMutexContentionTest("std::mutex", threads), new AdaptiveMutexContentionTest("AdaptiveMutex", threads));
+    }
+    // mutexRunner.RunBenchs();
+
+    TestRunner<3> queueRunner;
+    for (unsigned int threads : { 1u, 4u, 16u, 64u })
+    {
+        queueRunner.Add(new MutexQueueBench("ThreadSafeQueue", threads), new MPMCQueueBench("MPMCQueue", threads));
+    }
+    queueRunner.Add(new MutexHandoffBench("ThreadSafeQueue"), new SPSCHandoffBench("SPSCRing"));
+    queueRunner.Add(new SPSCHandoffBench("SPSCRing"), new SPSCBatchHandoffBench("SPSCRing"));
+    // queueRunner.RunBenchs();
+
+    // checks only, run by default. the bench runners are opt-in.
+    TestRunner<3> correctnessRunner;
+    correctnessRunner.Add(new JobAllocationTest());
+    correctnessRunner.Add(new MemoryTrackerTest());
+    correctnessRunner.Add(new SlotMapContainerBench("SlotMap", 1000));
+#if ENABLE_JS_COROUTINES
+    correctnessRunner.Add(new CoroutineTaskTest());
+#endif
+    correctnessRunner.RunTests();
+
+    TestRunner<3> allocationRunner;
+    allocationRunner.Add(new MallocScratchTest(), new FrameAllocatorScratchTest());
+    allocationRunner.Add(new DefaultResourceTest(), new PoolResourceTest());
+    allocationRunner.Add(new DefaultResourceTest(), new FrameResourceTest());
+    allocationRunner.Add(new JobScratchBench("JobContext::Scratch", 4));
+    for (unsigned int threads : { 4u, 16u, 32u })
+    {
+        allocationRunner.Add(new HeapScratchBench("heap", threads), new JobScratchBench("JobContext::Scratch", threads));
+    }
+    allocationRunner.Add(new VirtualArenaBufferBench("VirtualArena", 100000, 4));
+    allocationRunner.Add(new MallocBufferBench("malloc", 1000000, 4), new VirtualArenaBufferBench("VirtualArena", 1000000, 4));
+    // allocationRunner.RunTests();
+    // allocationRunner.RunBenchs();
+
+    TestRunner<5> nodePoolRunner;
+    for (size_t points : { 10000u, 100000u, 1000000u })
+    {
+        nodePoolRunner.Add(new KDTreeNodeBench("kdtree", PoolMode::HeapPerNode, points), new KDTreeNodeBench("kdtree", PoolMode::Slabs, points));
+        nodePoolRunner.Add(new OctreeNodeBench("core::Octree", PoolMode::HeapPerNode, points), new OctreeNodeBench("core::Octree", PoolMode::Slabs, points));
+    }
+    for (size_t points : { 1000u, 5000u })
+    {
+        nodePoolRunner.Add(new BVHNodeBench("bvh::Tree", PoolMode::HeapPerNode, points), new BVHNodeBench("bvh::Tree", PoolMode::Slabs, points));
+    }
+    // nodePoolRunner.RunBenchs();
+
+    TestRunner<5> containerRunner;
+    for (size_t count : { 1000u, 10000u, 100000u })
+    {
+        containerRunner.Add(new StdMapBench("std::map", count), new SlotMapContainerBench("SlotMap", count));
+        containerRunner.Add(new UnorderedMapBench("std::unordered_map", count), new SlotMapContainerBench("SlotMap", count));
+    }
+    containerRunner.Add(new StdMapUniformBench("std::map<string>"), new FlatMapUniformBench("FlatHashMap<string>"));
+    containerRunner.Add(new UnorderedMapUniformBench("unordered_map<string>"), new FlatMapUniformBench("FlatHashMap<string>"));
+    containerRunner.Add(new UnorderedHashUniformBench("unordered_map<hash>"), new FlatHashUniformBench("FlatHashMap<hash>"));
+    containerRunner.Add(new StdVectorNeighborBench("std::vector neighbors"), new SmallVectorNeighborBench("SmallVector neighbors"));
+    // containerRunner.RunBenchs();
+
+    TestRunner<3> profilerRunner;
+    profilerRunner.Add(new ProfilerStatsTest());
+    profilerRunner.Add(new PerfCountersTest());
+    profilerRunner.RunTests();
+
     auto glmTest = [](int workTime) {
         glm::vec3 p{ 0.0f, 0.0f, 0.0f };
         glm::vec3 d{ 0.0f, 1.0f, 0.0f };
@@ -123,6 +225,7 @@ int main()
 	jobber.AddBehavior(glmTest, 5, 4);
 
     float worktime = 2; // seconds
+    const float behaviorBudgetMs = 2.0f;
     
     GameTime timer;
     timer.Init();
@@ -133,9 +236,11 @@ int main()
         timer.Tick();
 		const float frameTime = timer.GetElapsed();
 
-        printf("frame: (%d), frametime: (%f s), time: (%f s), jobs: (%d)\n", 
-            frame, frameTime, timer.GetTotalTime(), jobber.Size());
-        jobber.Run((int)frameTime);
+        jobber.Run(behaviorBudgetMs);
+
+        const BehaviorScheduler::FrameStats& stats = jobber.GetBehaviorScheduler().GetLastFrameStats();
+        printf("frame: (%zu), frametime: (%f s), time: (%f s), behaviors: (%zu), ran: (%zu), deferred: (%zu), used: (%.3f ms)\n",
+            frame, frameTime, timer.GetTotalTime(), jobber.Size(), stats.ran, stats.deferred, stats.usedMs);
 
         float deltaT = freq - frameTime;
         int time = static_cast<int>(deltaT * 1000); // second to ms
@@ -149,6 +254,11 @@ int main()
     //testRunner.RunQuick(glmTest, vclTest);
     //testRunner.RunQuick(glmTest, glm4Test);
 
+    const size_t failed = testRunner.GetFailed() + jobBenchRunner.GetFailed() + scalingRunner.GetFailed()
+        + mutexRunner.GetFailed() + queueRunner.GetFailed() + correctnessRunner.GetFailed() + allocationRunner.GetFailed()
+        + nodePoolRunner.GetFailed() + containerRunner.GetFailed() + profilerRunner.GetFailed();
+    printf("%zu tests failed\n", failed);
+
     getchar();
-    return 0;
+    return failed == 0 ? 0 : 1;
 }
@@ -0,0 +1,37 @@
+#include "Core/ProfilerTrace.h"
+
+#include <cstdio>
+#include <string>
+
+// TraceConverter <in.ptrace> [out.json]
+// turns a streamed or spike dumped profiler trace into Chrome trace JSON,
+// next to the input when no output is given.
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		printf("usage: TraceConverter <in.ptrace> [out.json]\n");
+		return 1;
+	}
+
+	const std::string input = argv[1];
+	std::string output;
+	if (argc > 2)
+	{
+		output = argv[2];
+	}
+	else
+	{
+		const size_t extension = input.find_last_of('.');
+		output = (extension == std::string::npos ? input : input.substr(0, extension)) + ".json";
+	}
+
+	if (!ProfilerTrace::ConvertToChromeJson(input, output))
+	{
+		printf("couldn't convert %s to %s\n", input.c_str(), output.c_str());
+		return 1;
+	}
+
+	printf("wrote %s\n", output.c_str());
+	return 0;
+}
@@ -4,8 +4,11 @@
 #include "BoidSystem/BoidSystemState.h"
 #include "BoidSystem/ThreadedState.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
 #include <set>
+#include <string>
 
 #define RANDOM_STUFF 0
 #define INC_WIN 1
@@ -146,6 +149,24 @@ int main(int argc, char* argv[])
 	BoidSystemState state;
 #endif
 
+	// --headless [frames] [report.json]: no window or GPU, runs a fixed
+	// number of frames and writes their timings.
+	if (argc > 1 && std::string(argv[1]) == "--headless")
+	{
+		HeadlessParams params;
+		if (argc > 2)
+		{
+			params.frames = std::max(std::atoi(argv[2]), 1);
+		}
+		if (argc > 3)
+		{
+			params.reportPath = argv[3];
+		}
+
+		Game game(&state, params);
+		return game.Execute();
+	}
+
 	Game game(&state);
 	return game.Execute();
 #endif